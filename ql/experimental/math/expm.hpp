@@ -25,6 +25,7 @@
 #define quantlib_expm_hpp
 
 #include <ql/math/matrix.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -39,6 +40,55 @@ namespace QuantLib {
 
     //! returns the matrix exponential exp(t*M)
     Disposable<Matrix> Expm(const Matrix& M, Real t=1.0, Real tol=QL_EPSILON);
+
+    //! matrix exponential based on scaling and squaring
+
+    /*! The exponential of \f$ 2^{-s} t M \f$ is approximated by a
+        diagonal Padé approximant of degree 3, 5, 7, 9 or 13 and then
+        squared \f$ s \f$ times.  Degree and scaling are chosen from
+        the 1-norm of \f$ t M \f$ so that the result is accurate to
+        double precision; no tolerance is needed.
+
+        References:
+
+        N.J. Higham, 2005,
+        The Scaling and Squaring Method for the Matrix Exponential
+        Revisited, SIAM J. Matrix Anal. Appl. 26(4), pp. 1179-1193
+    */
+
+    //! returns the matrix exponential exp(t*M)
+    Disposable<Matrix> PadeExpm(const Matrix& M, Real t=1.0);
+
+    //! action of the matrix exponential on a vector
+
+    /*! exp(t*M) v is computed by a truncated Taylor series of the
+        shifted matrix \f$ M - \mu I \f$, \f$ \mu \f$ being the mean
+        of the diagonal of \f$ M \f$.  The time step is divided into
+        substeps; number of substeps and degree of the series are
+        chosen from the 1-norm of the shifted matrix so as to minimize
+        the number of matrix-vector products.  The series is truncated
+        early when two consecutive terms fall below tol relative to
+        the result.  The matrix exponential is never formed.
+
+        References:
+
+        A.H. Al-Mohy, N.J. Higham, 2011,
+        Computing the Action of the Matrix Exponential, with an
+        Application to Exponential Integrators,
+        SIAM J. Sci. Comput. 33(2), pp. 488-511
+    */
+
+    //! returns exp(t*M) v
+    Disposable<Array> Expmv(const Matrix& M, const Array& v,
+                            Real t=1.0, Real tol=QL_EPSILON);
+
+    //! returns exp(t_i*M) v for each time t_i of a non-decreasing grid
+    /*! Each result is propagated from the one at the previous time,
+        so that the whole grid costs about as much as its last time.
+    */
+    Disposable<std::vector<Array> > Expmv(const Matrix& M, const Array& v,
+                                          const std::vector<Time>& times,
+                                          Real tol=QL_EPSILON);
 }
 
 
@@ -67,6 +117,7 @@ namespace QuantLib {
 
 
 #include <ql/math/ode/adaptiverungekutta.hpp>
+#include <ql/mathconstants.hpp>
 
 #include <numeric>
 #include <algorithm>
@@ -94,7 +145,7 @@ namespace QuantLib {
         };
     }
 
-    Disposable<Matrix> Expm(const Matrix& M, Real t, Real tol) {
+    inline Disposable<Matrix> Expm(const Matrix& M, Real t, Real tol) {
         const Size n = M.rows();
         QL_REQUIRE(n == M.columns(), "Expm expects a square matrix");
 
@@ -111,6 +162,251 @@ namespace QuantLib {
         }
         return result;
     }
+
+    namespace detail {
+
+        inline Real matrixNorm1(const Matrix& M) {
+            Real norm = 0.0;
+            for (Size j=0; j<M.columns(); ++j) {
+                Real sum = 0.0;
+                for (Size i=0; i<M.rows(); ++i)
+                    sum += std::fabs(M[i][j]);
+                norm = std::max(norm, sum);
+            }
+            return norm;
+        }
+
+        inline Real arrayNormInf(const Array& a) {
+            Real norm = 0.0;
+            for (Size i=0; i<a.size(); ++i)
+                norm = std::max(norm, std::fabs(a[i]));
+            return norm;
+        }
+
+        // solves A X = B in place by Gaussian elimination with
+        // partial pivoting; A is overwritten by its factors
+        inline void solveInPlace(Matrix& A, Matrix& B) {
+            const Size n = A.rows();
+            for (Size k=0; k<n; ++k) {
+                Size p = k;
+                for (Size i=k+1; i<n; ++i)
+                    if (std::fabs(A[i][k]) > std::fabs(A[p][k]))
+                        p = i;
+                QL_REQUIRE(A[p][k] != 0.0, "singular Padé denominator");
+                if (p != k) {
+                    std::swap_ranges(A.row_begin(k), A.row_end(k),
+                                     A.row_begin(p));
+                    std::swap_ranges(B.row_begin(k), B.row_end(k),
+                                     B.row_begin(p));
+                }
+                for (Size i=k+1; i<n; ++i) {
+                    const Real l = A[i][k]/A[k][k];
+                    if (l == 0.0)
+                        continue;
+                    for (Size j=k+1; j<n; ++j)
+                        A[i][j] -= l*A[k][j];
+                    for (Size j=0; j<B.columns(); ++j)
+                        B[i][j] -= l*B[k][j];
+                }
+            }
+            for (Size k=n; k>0; --k) {
+                const Size i = k-1;
+                for (Size j=0; j<B.columns(); ++j) {
+                    Real x = B[i][j];
+                    for (Size m=i+1; m<n; ++m)
+                        x -= A[i][m]*B[m][j];
+                    B[i][j] = x/A[i][i];
+                }
+            }
+        }
+
+        // y = M x for preallocated y
+        inline void multiply(const Matrix& M, const Array& x, Array& y) {
+            for (Size i=0; i<M.rows(); ++i) {
+                const Real* m = M.row_begin(i);
+                Real sum = 0.0;
+                for (Size j=0; j<M.columns(); ++j)
+                    sum += m[j]*x[j];
+                y[i] = sum;
+            }
+        }
+
+        // propagates f to exp(h*(B + mu I)) f; B has 1-norm normB
+        inline void taylorExpmvStep(const Matrix& B, Real mu, Real normB,
+                                    Real h, Real tol,
+                                    Array& f, Array& b, Array& w) {
+            // largest scaled norm theta for which the Taylor tail
+            // theta^(m+1)/(m+1)! exp(theta) stays below 2^-53
+            static const Size degrees[] = {
+                5, 10, 15, 20, 25, 30, 35, 40, 45, 50, 55 };
+            static const Real thetas[] = {
+                6.5562e-3, 1.7133e-1, 6.5697e-1, 1.4111, 2.3467, 3.4018,
+                4.5375, 5.7292, 6.9610, 8.2225, 9.5063 };
+
+            const Real eta = std::fabs(h)*normB;
+            Size m = degrees[0], s = 1;
+            if (eta > 0.0) {
+                Real cost = QL_MAX_REAL;
+                for (Size i=0; i<sizeof(degrees)/sizeof(degrees[0]); ++i) {
+                    const Size si = std::max<Size>(
+                        1, static_cast<Size>(std::ceil(eta/thetas[i])));
+                    if (Real(si*degrees[i]) < cost) {
+                        cost = Real(si*degrees[i]);
+                        m = degrees[i];
+                        s = si;
+                    }
+                }
+            }
+
+            const Real dt = h/s;
+            const Real scaling = std::exp(mu*dt);
+            for (Size i=0; i<s; ++i) {
+                std::copy(f.begin(), f.end(), b.begin());
+                Real c1 = arrayNormInf(b);
+                for (Size k=1; k<=m && eta > 0.0; ++k) {
+                    multiply(B, b, w);
+                    const Real c = dt/k;
+                    for (Size j=0; j<b.size(); ++j) {
+                        b[j] = c*w[j];
+                        f[j] += b[j];
+                    }
+                    const Real c2 = arrayNormInf(b);
+                    if (c1 + c2 <= tol*arrayNormInf(f))
+                        break;
+                    c1 = c2;
+                }
+                f *= scaling;
+            }
+        }
+
+        inline void shiftedMatrix(const Matrix& M, Matrix& B, Real& mu) {
+            const Size n = M.rows();
+            QL_REQUIRE(n == M.columns(), "square matrix expected");
+            mu = 0.0;
+            for (Size i=0; i<n; ++i)
+                mu += M[i][i];
+            mu /= n;
+            B = M;
+            for (Size i=0; i<n; ++i)
+                B[i][i] -= mu;
+        }
+    }
+
+    inline Disposable<Matrix> PadeExpm(const Matrix& M, Real t) {
+        const Size n = M.rows();
+        QL_REQUIRE(n == M.columns(), "PadeExpm expects a square matrix");
+
+        static const Real b3[] = { 120.0, 60.0, 12.0, 1.0 };
+        static const Real b5[] = {
+            30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0 };
+        static const Real b7[] = {
+            17297280.0, 8648640.0, 1995840.0, 277200.0, 25200.0,
+            1512.0, 56.0, 1.0 };
+        static const Real b9[] = {
+            17643225600.0, 8821612800.0, 2075673600.0, 302702400.0,
+            30270240.0, 2162160.0, 110880.0, 3960.0, 90.0, 1.0 };
+        static const Real b13[] = {
+            64764752532480000.0, 32382376266240000.0, 7771770303897600.0,
+            1187353796428800.0, 129060195264000.0, 10559470521600.0,
+            670442572800.0, 33522128640.0, 1323241920.0, 40840800.0,
+            960960.0, 16380.0, 182.0, 1.0 };
+        static const Real thetas[] = {
+            1.495585217958292e-2, 2.539398330063230e-1,
+            9.504178996162932e-1, 2.097847961257068e0,
+            5.371920351148152e0 };
+        static const Real* const coefficients[] = { b3, b5, b7, b9 };
+
+        Matrix A = t*M;
+        const Real norm = detail::matrixNorm1(A);
+
+        Matrix U(n, n, 0.0), V(n, n, 0.0);
+        for (Size i=0; i<n; ++i)
+            V[i][i] = 1.0;
+        const Matrix identity = V;
+
+        Size squarings = 0;
+        Size degree = 0;
+        while (degree < 4 && norm > thetas[degree])
+            ++degree;
+
+        if (degree < 4) {
+            // low degree approximant, U odd and V even part
+            const Real* b = coefficients[degree];
+            const Size m = 2*degree+3;
+            const Matrix A2 = A*A;
+            Matrix power = identity;
+            U = b[1]*identity;
+            V = b[0]*identity;
+            for (Size k=2; k<=m; k+=2) {
+                power = power*A2;
+                U += b[k+1]*power;
+                V += b[k]*power;
+            }
+            U = A*U;
+        } else {
+            if (norm > thetas[4])
+                squarings = static_cast<Size>(
+                    std::ceil(std::log(norm/thetas[4])/M_LN2));
+            A *= std::pow(2.0, -Real(squarings));
+            const Real* b = b13;
+            const Matrix A2 = A*A, A4 = A2*A2, A6 = A4*A2;
+            U = A*(A6*(b[13]*A6 + b[11]*A4 + b[9]*A2)
+                   + b[7]*A6 + b[5]*A4 + b[3]*A2 + b[1]*identity);
+            V = A6*(b[12]*A6 + b[10]*A4 + b[8]*A2)
+                + b[6]*A6 + b[4]*A4 + b[2]*A2 + b[0]*identity;
+        }
+
+        Matrix denominator = V - U;
+        Matrix result = V + U;
+        detail::solveInPlace(denominator, result);
+
+        for (Size i=0; i<squarings; ++i)
+            result = result*result;
+
+        return result;
+    }
+
+    inline Disposable<Array> Expmv(const Matrix& M, const Array& v,
+                                   Real t, Real tol) {
+        QL_REQUIRE(v.size() == M.columns(),
+                   "vector size (" << v.size() << ") does not match "
+                   "the matrix size (" << M.columns() << ")");
+        Matrix B;
+        Real mu;
+        detail::shiftedMatrix(M, B, mu);
+
+        Array f = v, b(v.size()), w(v.size());
+        detail::taylorExpmvStep(B, mu, detail::matrixNorm1(B), t, tol,
+                                f, b, w);
+        return f;
+    }
+
+    inline Disposable<std::vector<Array> > Expmv(
+                                        const Matrix& M, const Array& v,
+                                        const std::vector<Time>& times,
+                                        Real tol) {
+        QL_REQUIRE(v.size() == M.columns(),
+                   "vector size (" << v.size() << ") does not match "
+                   "the matrix size (" << M.columns() << ")");
+        Matrix B;
+        Real mu;
+        detail::shiftedMatrix(M, B, mu);
+        const Real normB = detail::matrixNorm1(B);
+
+        std::vector<Array> result;
+        result.reserve(times.size());
+        Array f = v, b(v.size()), w(v.size());
+        Time t = 0.0;
+        for (Size i=0; i<times.size(); ++i) {
+            QL_REQUIRE(i == 0 || times[i] >= times[i-1],
+                       "times must be non-decreasing");
+            detail::taylorExpmvStep(B, mu, normB, times[i]-t, tol,
+                                    f, b, w);
+            t = times[i];
+            result.push_back(f);
+        }
+        return result;
+    }
 }
 
 #endif
\ No newline at end of file
@@ -30,7 +30,11 @@ namespace QuantLib {
 
 /*! Reference:
     http://de.mathworks.com/help/matlab/ref/pinv.html
-    https://en.wikipedia.org/wiki/Moore%E2%80%93Penrose_pseudoinverse */
+    https://en.wikipedia.org/wiki/Moore%E2%80%93Penrose_pseudoinverse
+
+    \note a full SVD is computed at each call; to solve least squares
+          problems repeatedly with the same matrix, use QRLeastSquares
+          instead of forming the inverse. */
 
 inline Disposable<Matrix> moorePenroseInverse(const Matrix &A,
                                               const Real tol = Null<Real>()) {
@@ -1,6 +1,7 @@
 #include <ql/math/abcdmathfunction.hpp>
 #include <ql/math/array.hpp>
 #include <ql/math/autocovariance.hpp>
+#include <ql/math/batchsolver1d.hpp>
 #include <ql/math/bernsteinpolynomial.hpp>
 #include <ql/math/beta.hpp>
 #include <ql/math/bspline.hpp>
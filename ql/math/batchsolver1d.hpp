@@ -0,0 +1,213 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file batchsolver1d.hpp
+    \brief Abstract solver class for many independent 1-D equations
+*/
+
+#ifndef quantlib_batch_solver1d_hpp
+#define quantlib_batch_solver1d_hpp
+
+#include <ql/math/solver1d.hpp>
+#include <vector>
+
+namespace QuantLib {
+
+    //! Base class for solvers of many independent 1-D equations
+    /*! The equations \f$ f_i(x) = 0 \f$, called lanes, are solved
+        together: the iterations of all the lanes advance in
+        lockstep, and at each step the function is called once on
+        the lanes that are still being solved.  Its signature is
+        \code
+        void operator()(const Size* lanes, const Real* x, Real* fx,
+                        Size n) const
+        \endcode
+        and it must set fx[k] to \f$ f_{lanes[k]}(x[k]) \f$ for k in
+        [0,n); the points are contiguous, so that the evaluation can
+        be vectorized.  Solvers that need the derivative pass
+        another argument (see their documentation).
+
+        Lanes whose root cannot be found do not stop the others;
+        their root is set to Null<Real>() and the reason is given by
+        status().
+
+        Concrete solvers are declared as
+        \code
+        class Foo : public BatchSolver1D<Foo> {
+          public:
+            template <class F>
+            void values(const F& f, const std::vector<Size>& lanes,
+                        const std::vector<Real>& x,
+                        std::vector<Real>& fx) const;
+            template <class F>
+            void solveImpl(const F& f, Real accuracy) const;
+        };
+        \endcode
+        where values() sets fx[i] to \f$ f_i(x[i]) \f$ for the given
+        lanes i.  Before calling solveImpl(), the base class sets the
+        elements of its data members for the lanes in lanes_ as
+        Solver1D does for its scalar ones; solveImpl() must solve
+        those lanes, set their root and status, and leave lanes_
+        empty.
+    */
+    template <class Impl>
+    class BatchSolver1D : public CuriouslyRecurringTemplate<Impl> {
+      public:
+        enum Status { Converged, NotBracketed, MaxEvaluationsExceeded };
+        BatchSolver1D() : maxEvaluations_(MAX_FUNCTION_EVALUATIONS) {}
+        //! \name Modifiers
+        //@{
+        /*! This method sets roots[i] to the zero of \f$ f_i \f$,
+            determined with the given accuracy, from the initial guess
+            guess[i] and the values xMin[i] and xMax[i] that must
+            bracket it; see Solver1D::solve.
+        */
+        template <class F>
+        void solve(const F& f,
+                   Real accuracy,
+                   const std::vector<Real>& guess,
+                   const std::vector<Real>& xMin,
+                   const std::vector<Real>& xMax,
+                   std::vector<Real>& roots) const {
+
+            const Size n = guess.size();
+            QL_REQUIRE(xMin.size() == n && xMax.size() == n,
+                       "number of lower (" << xMin.size()
+                       << ") and upper (" << xMax.size()
+                       << ") bounds does not match the number of guesses ("
+                       << n << ")");
+            QL_REQUIRE(accuracy>0.0,
+                       "accuracy (" << accuracy << ") must be positive");
+            // check whether we really want to use epsilon
+            accuracy = std::max(accuracy, QL_EPSILON);
+
+            for (Size i=0; i<n; ++i) {
+                QL_REQUIRE(xMin[i] < xMax[i],
+                           "lane " << i << ": invalid range: xMin ("
+                           << xMin[i] << ") >= xMax (" << xMax[i] << ")");
+                QL_REQUIRE(guess[i] > xMin[i] && guess[i] < xMax[i],
+                           "lane " << i << ": guess (" << guess[i]
+                           << ") not in (" << xMin[i] << ", " << xMax[i]
+                           << ")");
+            }
+
+            root_ = guess;
+            xMin_ = xMin;
+            xMax_ = xMax;
+            fxMin_.resize(n);
+            fxMax_.resize(n);
+            evaluationNumber_.assign(n, 2);
+            status_.assign(n, Converged);
+            lanes_.resize(n);
+            for (Size i=0; i<n; ++i)
+                lanes_[i] = i;
+
+            if (n > 0) {
+                this->impl().values(f, lanes_, xMin_, fxMin_);
+                this->impl().values(f, lanes_, xMax_, fxMax_);
+            }
+
+            std::vector<Size> bracketed;
+            bracketed.reserve(n);
+            for (Size i=0; i<n; ++i) {
+                if (close(fxMin_[i], 0.0)) {
+                    root_[i] = xMin_[i];
+                } else if (close(fxMax_[i], 0.0)) {
+                    root_[i] = xMax_[i];
+                } else if (fxMin_[i]*fxMax_[i] < 0.0) {
+                    bracketed.push_back(i);
+                } else {
+                    root_[i] = Null<Real>();
+                    status_[i] = NotBracketed;
+                }
+            }
+            lanes_.swap(bracketed);
+
+            if (!lanes_.empty())
+                this->impl().solveImpl(f, accuracy);
+            roots = root_;
+        }
+        /*! This method sets the maximum number of function
+            evaluations for each lane.
+        */
+        void setMaxEvaluations(Size evaluations) {
+            maxEvaluations_ = evaluations;
+        }
+        //@}
+        //! \name Inspectors
+        //@{
+        //! outcome of the last solve() for each lane
+        const std::vector<Status>& status() const { return status_; }
+        //! function evaluations used by the last solve() for each lane
+        const std::vector<Size>& evaluations() const {
+            return evaluationNumber_;
+        }
+        //@}
+      protected:
+        // calls f on the given lanes; x and fx are indexed by lane
+        template <class F>
+        void evaluate(const F& f,
+                      const std::vector<Size>& lanes,
+                      const std::vector<Real>& x,
+                      std::vector<Real>& fx) const {
+            const Size n = lanes.size();
+            xWork_.resize(n);
+            fxWork_.resize(n);
+            for (Size k=0; k<n; ++k)
+                xWork_[k] = x[lanes[k]];
+            f(&lanes[0], &xWork_[0], &fxWork_[0], n);
+            for (Size k=0; k<n; ++k)
+                fx[lanes[k]] = fxWork_[k];
+        }
+        // same as above, with the derivative
+        template <class F>
+        void evaluate(const F& f,
+                      const std::vector<Size>& lanes,
+                      const std::vector<Real>& x,
+                      std::vector<Real>& fx,
+                      std::vector<Real>& dfx) const {
+            const Size n = lanes.size();
+            xWork_.resize(n);
+            fxWork_.resize(n);
+            dfxWork_.resize(n);
+            for (Size k=0; k<n; ++k)
+                xWork_[k] = x[lanes[k]];
+            f(&lanes[0], &xWork_[0], &fxWork_[0], &dfxWork_[0], n);
+            for (Size k=0; k<n; ++k) {
+                fx[lanes[k]] = fxWork_[k];
+                dfx[lanes[k]] = dfxWork_[k];
+            }
+        }
+        // marks the lane as failed
+        void fail(Size i, Status status) const {
+            root_[i] = Null<Real>();
+            status_[i] = status;
+        }
+        mutable std::vector<Real> root_, xMin_, xMax_, fxMin_, fxMax_;
+        Size maxEvaluations_;
+        mutable std::vector<Size> evaluationNumber_;
+        mutable std::vector<Status> status_;
+        // lanes still being solved
+        mutable std::vector<Size> lanes_;
+      private:
+        // contiguous workspaces for the function calls
+        mutable std::vector<Real> xWork_, fxWork_, dfxWork_;
+    };
+
+}
+
+#endif
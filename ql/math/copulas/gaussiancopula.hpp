@@ -26,14 +26,22 @@
 
 #include <ql/math/distributions/bivariatenormaldistribution.hpp>
 #include <functional>
+#include <vector>
 
 namespace QuantLib {
 
     //! Gaussian copula
+    /*! \test the array version is checked against the scalar one. */
     class GaussianCopula : public std::binary_function<Real,Real,Real> {
       public:
         GaussianCopula(Real rho);
         Real operator()(Real x, Real y) const;
+        /*! sets result[i] to the value at (x[i], y[i]) for i in
+            [0,n); the inverse cumulative normal is applied to each
+            array in a single call.
+        */
+        void operator()(const Real* x, const Real* y,
+                        Real* result, Size n) const;
       private:
         Real rho_;
         BivariateCumulativeNormalDistributionWe04DP bivariate_normal_cdf_;     
@@ -80,6 +88,24 @@ namespace QuantLib {
         return bivariate_normal_cdf_(invCumNormal_(x), invCumNormal_(y));
     }
 
+    inline void GaussianCopula::operator()(const Real* x, const Real* y,
+                                           Real* result, Size n) const
+    {
+        for (Size i=0; i<n; ++i) {
+            QL_REQUIRE(x[i] >= 0.0 && x[i] <=1.0 ,
+                       "1st argument (" << x[i] << ") must be in [0,1]");
+            QL_REQUIRE(y[i] >= 0.0 && y[i] <=1.0 ,
+                       "2nd argument (" << y[i] << ") must be in [0,1]");
+        }
+        if (n == 0)
+            return;
+        std::vector<Real> u(n), v(n);
+        invCumNormal_(x, &u[0], n);
+        invCumNormal_(y, &v[0], n);
+        for (Size i=0; i<n; ++i)
+            result[i] = bivariate_normal_cdf_(u[i], v[i]);
+    }
+
 }
 
 
@@ -29,6 +29,7 @@
 #include <ql/math/errorfunction.hpp>
 #include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
+#include <algorithm>
 
 #if defined(__GNUC__) && (((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8)) || (__GNUC__ > 4))
 #pragma GCC diagnostic push
@@ -76,6 +77,24 @@ namespace QuantLib {
         For this implementation see M. Abramowitz and I. Stegun,
         Handbook of Mathematical Functions,
         Dover Publications, New York (1972)
+
+        The array version calls the scalar one on each element,
+        unless QL_ENABLE_VECTORIZED_NORMAL_DISTRIBUTION is defined
+        (see ql/userconfig.hpp).  In that case, it uses instead
+        piecewise polynomial approximations of
+        \f$ \log(\mathrm{erfc}(z)/t) + z^2 \f$ in
+        \f$ t = 2/(2+z) \f$, evaluated without branches on the
+        arguments so that the loop can be vectorized; e.g., gcc does
+        it with -O3 -ffast-math on AVX2 targets, where the array
+        version is about 1.5 times as fast as the scalar one, while
+        it is slower without vectorization.  Its relative error is
+        below \f$ 10^{-15} \f$ for arguments down to -10 and grows
+        as \f$ 10^{-16} x^2 \f$ below, due to the rounding of
+        \f$ x^2 \f$; in the left tail it is more accurate than the
+        scalar version, whose relative error grows to about
+        \f$ 10^{-8} \f$ near \f$ x = -5.6 \f$.
+
+        \test the array version is checked against the scalar one.
     */
     class CumulativeNormalDistribution
     : public std::unary_function<Real,Real> {
@@ -84,6 +103,8 @@ namespace QuantLib {
                                      Real sigma   = 1.0);
         // function
         Real operator()(Real x) const;
+        //! sets y[i] to the value at x[i] for i in [0,n); y can be x
+        void operator()(const Real* x, Real* y, Size n) const;
         Real derivative(Real x) const;
       private:
         Real average_, sigma_;
@@ -109,6 +130,13 @@ namespace QuantLib {
       in this case the traditional Box-Muller approach and its
       variants would not preserve the sequence's low-discrepancy.
 
+      The array version uses the same approximation and gives the
+      same results; it works on blocks of arguments, evaluating the
+      central approximation on all of them in a loop without branches,
+      that can be vectorized, and then the tails on the few arguments
+      (a small fraction of uniform deviates) that need it.
+
+      \test the array version is checked against the scalar one.
     */
     class InverseCumulativeNormal
         : public std::unary_function<Real,Real> {
@@ -119,6 +147,8 @@ namespace QuantLib {
         Real operator()(Real x) const {
             return average_ + sigma_*standard_value(x);
         }
+        //! sets y[i] to the value at x[i] for i in [0,n); y can be x
+        void operator()(const Real* x, Real* y, Size n) const;
         // value for average=0, sigma=1
         /* Compared to operator(), this method avoids 2 floating point
            operations (we use average=0 and sigma=1 most of the
@@ -369,10 +399,146 @@ namespace QuantLib {
         return result;
     }
 
+    namespace detail {
+
+        /* array cumulative normal without branches on the arguments;
+           see the documentation of CumulativeNormalDistribution */
+        inline void branchFreeCumulativeNormal(Real average, Real sigma,
+                                               const Real* x, Real* y,
+                                               Size n) {
+            /* log(erfc(z)/t)+z^2, with t = 2/(2+z), is approximated on
+               each of 16 subintervals of (0,1] in t by a polynomial in
+               the local variable s in [-1,1] */
+            static const Real c[16][10] = {
+                {-1.2338934557406128, 3.1989701517633838e-2, 3.7330449206923905e-4,
+                 2.1707924574914037e-6, -1.0462017729854881e-7, -4.7717673014168979e-9,
+                 -7.57998891399464e-11, 1.9474013285946232e-12, 1.496644441687336e-13, 2.8479851308237479e-15},
+                {-1.1684052995790095, 3.350522588668166e-2, 3.834200183045187e-4,
+                 1.1322050952501061e-6, -1.5616276636290442e-7, -5.4458635711343907e-9,
+                 -3.0261763132472386e-11, 4.6242346826700442e-12, 1.7307608888674962e-13, -7.9344377775835139e-16},
+                {-1.0998547842646503, 3.5047055979431279e-2, 3.8602582249883482e-4,
+                 -3.3688107752275422e-7, -2.1095464520681304e-7, -5.3465666305194542e-9,
+                 5.246484869544699e-11, 7.0177257987031312e-12, 1.0674953592437942e-13, -6.6826879793413193e-15},
+                {-1.0282228061490861, 3.6579951732800597e-2, 3.7853136509879815e-4,
+                 -2.2259043288101868e-6, -2.5921778447707374e-7, -4.095025639776719e-9,
+                 1.5736539139617244e-10, 7.5291005486073445e-12, -5.5945045406750507e-14, -1.0649109145053814e-14},
+                {-9.5357085196777679e-1, 3.8058777275356842e-2, 3.5866978792417413e-4,
+                 -4.4342106921622798e-6, -2.8872380555339082e-7, -1.6208283314142158e-9,
+                 2.4934107485453939e-10, 5.1135845931968006e-12, -2.3932648933804647e-13, -8.6081835021158775e-15},
+                {-8.7605874685145874e-1, 3.943092697103167e-2, 3.2506829803357633e-4,
+                 -6.7665479096190738e-6, -2.8883933174930343e-7, 1.6783702569404742e-9,
+                 2.893091332598992e-10, 3.4358813002661192e-13, -3.3264387295614913e-13, -1.2205701323354492e-15},
+                {-7.9595530134779758e-1, 4.0640948358355568e-2, 2.777402028070248e-4,
+                 -8.9642437717434134e-6, -2.5497378972825882e-7, 5.0304040496338247e-9,
+                 2.5733929986095128e-10, -4.7709028175432883e-12, -2.8127042793125227e-13, 6.5204120718740865e-15},
+                {-7.1363806058721928e-1, 4.1636628514996584e-2, 2.1829588506140709e-4,
+                 -1.0764781213525541e-5, -1.9085103571701805e-7, 7.6067168630904177e-9,
+                 1.6422235010272215e-10, -8.1067003629480972e-12, -1.2427124053171475e-13, 1.0027330110819288e-14},
+                {-6.2958053902241897e-1, 4.2375163779665975e-2, 1.4976909953054522e-4,
+                 -1.1965753699332782e-5, -1.0729911779643719e-7, 8.8609479376414532e-9,
+                 4.3516987748833194e-11, -8.6715896162740419e-12, 4.8402881854359265e-14, 8.4481052170929749e-15},
+                {-5.4432829263836511e-1, 4.2827930976327672e-2, 7.6113015358259353e-5,
+                 -1.2467472069948396e-5, -1.8420453384344443e-8, 8.6921020741691976e-9,
+                 -6.7394400517399882e-11, -6.8662421356214795e-12, 1.6286973529473697e-13, 4.064052986351409e-15},
+                {-4.584677401292903e-1, 4.2982863446221755e-2, 1.540980262187101e-6,
+                 -1.2281468745519645e-5, 6.2730626077765807e-8, 7.38613254077659e-9,
+                 -1.4326615644814023e-10, -3.8871466363080978e-12, 1.9541870908415501e-13, -2.4936093788603841e-16},
+                {-3.7259287063628064e-1, 4.284421896344844e-2, -7.0088054859911099e-5,
+                 -1.1508930860546386e-5, 1.2712365146952822e-7, 5.4263191454151935e-9,
+                 -1.7646236708718631e-10, -9.3966638287718544e-13, 1.645990475749828e-13, -2.8379606710553744e-15},
+                {-2.8727466012829211e-1, 4.2430227496121036e-2, -1.3569926791354076e-4,
+                 -1.0303370125930485e-5, 1.7070819486180459e-7, 3.2974148460982118e-9,
+                 -1.7327631826878139e-10, 1.2336549871513806e-12, 1.0486446893018101e-13, -3.526188633888301e-15},
+                {-2.0303660322705093e-1, 4.176948382128747e-2, -1.931992843624302e-4,
+                 -8.832672258529357e-6, 1.9373454206041789e-7, 1.361685280675495e-9,
+                 -1.4658554294858163e-10, 2.4192606569500381e-12, 4.5199577185039467e-14, -2.9647946315152959e-15},
+                {-1.2033795983512398e-1, 4.0896976035902437e-2, -2.4147024117249949e-4,
+                 -7.2503618141740795e-6, 1.9927284466681802e-7, -1.7951203976006635e-10,
+                 -1.0949469984136165e-10, 2.7612690129615697e-12, 9.5410201634993191e-16, -1.925636295550167e-15},
+                {-3.9564715656325817e-2, 3.9850433310272537e-2, -2.802286546657309e-4,
+                 -5.6793404257075246e-6, 1.9167507315744888e-7, -1.264588123843746e-9,
+                 -7.1862124603870636e-11, 2.5472262375002893e-12, -2.4481406172606217e-14, -9.3558998173684842e-16}
+            };
+            for (Size i=0; i<n; ++i) {
+                const Real u = (x[i]-average)/sigma;
+                // z = |u|/sqrt(2), limited to where erfc underflows anyway;
+                // the order of the arguments maps a NaN to 30, so that the
+                // index below stays in range while the NaN propagates to
+                // the result through u
+                const Real z = std::min(Real(30.0), std::fabs(u)*M_SQRT_2);
+                const Real t = 2.0/(2.0+z);
+                const Real w = 16.0*t;
+                const Size k = static_cast<Size>(std::min(w, Real(15.0)));
+                const Real s = 2.0*(w-k)-1.0;
+                const Real g = c[k][0]+s*(c[k][1]+s*(c[k][2]+s*(c[k][3]
+                               +s*(c[k][4]+s*(c[k][5]+s*(c[k][6]+s*(c[k][7]
+                               +s*(c[k][8]+s*c[k][9]))))))));
+                // erfc(z)/2, i.e., the value at -|u|
+                const Real p = 0.5*t*std::exp(g - 0.5*u*u);
+                y[i] = u < 0.0 ? p : 1.0-p;
+            }
+        }
+
+    }
+
+    inline void CumulativeNormalDistribution::operator()(const Real* x,
+                                                        Real* y,
+                                                        Size n) const {
+        #if defined(QL_ENABLE_VECTORIZED_NORMAL_DISTRIBUTION)
+        detail::branchFreeCumulativeNormal(average_, sigma_, x, y, n);
+        #else
+        for (Size i=0; i<n; ++i)
+            y[i] = (*this)(x[i]);
+        #endif
+    }
+
+
     // #if !defined(QL_PATCH_SOLARIS)
     // const CumulativeNormalDistribution InverseCumulativeNormal::f_;
     // #endif
 
+    inline void InverseCumulativeNormal::operator()(const Real* x,
+                                                   Real* y,
+                                                   Size n) const {
+        // blocks of fixed size, so that the compiler can vectorize the
+        // loop on the central region even at -O2; the remaining
+        // arguments are handled by the scalar version
+        const Size blockSize = 8;
+        Real z[blockSize];
+        Size k = 0;
+        for (; k+blockSize<=n; k+=blockSize) {
+            const Real* xk = x+k;
+            Real* yk = y+k;
+            for (Size i=0; i<blockSize; ++i) {
+                const Real q = xk[i] - 0.5;
+                const Real r = q*q;
+                z[i] = (((((a1_()*r+a2_())*r+a3_())*r+a4_())*r+a5_())*r+a6_())*q
+                    / (((((b1_()*r+b2_())*r+b3_())*r+b4_())*r+b5_())*r+1.0);
+            }
+            // the few arguments in the tails (or outside (0,1), which
+            // tail_value checks) are patched afterwards
+            for (Size i=0; i<blockSize; ++i) {
+                if (xk[i] < x_low_() || x_high_() < xk[i])
+                    z[i] = tail_value(xk[i]);
+            }
+
+            #ifdef REFINE_TO_FULL_MACHINE_PRECISION_USING_HALLEYS_METHOD
+            Real f[blockSize];
+            CumulativeNormalDistribution()(z, f, blockSize);
+            for (Size i=0; i<blockSize; ++i) {
+                const Real r = (f[i] - xk[i]) * M_SQRT2 * M_SQRTPI
+                    * std::exp(0.5 * z[i]*z[i]);
+                z[i] -= r/(1+0.5*z[i]*r);
+            }
+            #endif
+
+            for (Size i=0; i<blockSize; ++i)
+                yk[i] = average_ + sigma_*z[i];
+        }
+        for (; k<n; ++k)
+            y[k] = (*this)(x[k]);
+    }
+
     inline Real InverseCumulativeNormal::tail_value(Real x) {
         if (x <= 0.0 || x >= 1.0) {
             // try to recover if due to numerical error
@@ -5,6 +5,7 @@
 #include <ql/math/integrals/gaussianquadratures.hpp>
 #include <ql/math/integrals/integral.hpp>
 #include <ql/math/integrals/kronrodintegral.hpp>
+#include <ql/math/integrals/multidimensionalquadrature.hpp>
 #include <ql/math/integrals/segmentintegral.hpp>
 #include <ql/math/integrals/simpsonintegral.hpp>
 #include <ql/math/integrals/trapezoidintegral.hpp>
@@ -52,6 +52,8 @@ namespace QuantLib {
       protected:
         Real integrate(const boost::function<Real (Real)>& f,
                        Real a, Real b) const;
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a, Real b) const;
     };
 
     class DiscreteSimpsonIntegrator: public Integrator {
@@ -62,6 +64,8 @@ namespace QuantLib {
       protected:
         Real integrate(const boost::function<Real (Real)>& f,
                        Real a, Real b) const;
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a, Real b) const;
     };
 }
 
@@ -151,6 +155,16 @@ namespace QuantLib {
             return DiscreteTrapezoidIntegral()(x, fv);
     }
 
+    inline Real DiscreteTrapezoidIntegrator::integrateBatch(
+        const BatchIntegrand& f, Real a, Real b) const {
+            const Array x(maxEvaluations(), a, (b-a)/(maxEvaluations()-1));
+            Array fv(x.size());
+            f(x.begin(), fv.begin(), x.size());
+
+            increaseNumberOfEvaluations(maxEvaluations());
+            return DiscreteTrapezoidIntegral()(x, fv);
+    }
+
     inline Real DiscreteSimpsonIntegrator::integrate(
         const boost::function<Real (Real)>& f, Real a, Real b) const {
             const Array x(maxEvaluations(), a, (b-a)/(maxEvaluations()-1));
@@ -160,6 +174,16 @@ namespace QuantLib {
             increaseNumberOfEvaluations(maxEvaluations());
             return DiscreteSimpsonIntegral()(x, fv);
     }
+
+    inline Real DiscreteSimpsonIntegrator::integrateBatch(
+        const BatchIntegrand& f, Real a, Real b) const {
+            const Array x(maxEvaluations(), a, (b-a)/(maxEvaluations()-1));
+            Array fv(x.size());
+            f(x.begin(), fv.begin(), x.size());
+
+            increaseNumberOfEvaluations(maxEvaluations());
+            return DiscreteSimpsonIntegral()(x, fv);
+    }
 }
 
 #endif
\ No newline at end of file
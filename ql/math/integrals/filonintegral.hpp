@@ -51,7 +51,12 @@ namespace QuantLib {
       protected:
         Real integrate(const boost::function<Real (Real)>& f,
                        Real a, Real b) const;
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a, Real b) const;
       private:
+        // the integral given the values v of f at the nodes x
+        Real integrateValues(const Array& x, const Array& v,
+                             Real a, Real b) const;
         const Type type_;
         const Real t_;
         const Size intervals_, n_;
@@ -102,7 +107,24 @@ namespace QuantLib {
                                   Real a, Real b) const {
         const Real h = (b-a)/(2*n_);
         Array x(2*n_+1, a, h);
+        Array v(x.size());
+        std::transform(x.begin(), x.end(), v.begin(), f);
+        return integrateValues(x, v, a, b);
+    }
+
+    inline Real FilonIntegral::integrateBatch(const BatchIntegrand& f,
+                                              Real a, Real b) const {
+        const Real h = (b-a)/(2*n_);
+        Array x(2*n_+1, a, h);
+        Array v(x.size());
+        f(x.begin(), v.begin(), x.size());
+        return integrateValues(x, v, a, b);
+    }
 
+    inline Real FilonIntegral::integrateValues(const Array& x,
+                                               const Array& v,
+                                               Real a, Real b) const {
+        const Real h = (b-a)/(2*n_);
         const Real theta = t_*h;
         const Real theta2 = theta*theta;
         const Real theta3 = theta2*theta;
@@ -113,9 +135,6 @@ namespace QuantLib {
             - std::sin(2*theta)/theta3);
         const Real gamma = 4*(std::sin(theta)/theta3 - std::cos(theta)/theta2);
 
-        Array v(x.size());
-        std::transform(x.begin(), x.end(), v.begin(), f);
-
         boost::function<Real(Real)> f1, f2;
         switch(type_) {
           case Cosine:
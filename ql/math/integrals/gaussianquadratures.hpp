@@ -27,12 +27,72 @@
 
 #include <ql/math/array.hpp>
 #include <ql/math/integrals/gaussianorthogonalpolynomial.hpp>
+#include <ql/math/integrals/integral.hpp>
 #include <ql/math/matrixutilities/tqreigendecomposition.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <boost/shared_ptr.hpp>
+#if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+#include <boost/thread/mutex.hpp>
+#endif
+#include <map>
+#include <utility>
 
 namespace QuantLib {
     class GaussianOrthogonalPolynomial;
 
+    namespace detail {
+
+        //! process-wide cache of Gaussian quadrature rules
+        /*! The nodes and weights are stored by polynomial family,
+            parameters and order, and are never modified once stored.
+            Access to the stored rules is serialized by a mutex if
+            thread-safe singleton initialization is enabled (see
+            QL_ENABLE_SINGLETON_THREAD_SAFE_INIT in userconfig.hpp), or
+            else by an OpenMP critical section if compiled with OpenMP.
+
+            Since the parameters can take any real value, at most
+            maxSize() rules are stored; rules requested afterwards are
+            calculated by each quadrature and not stored.
+        */
+        class GaussianQuadratureCache
+            : public Singleton<GaussianQuadratureCache> {
+          public:
+            explicit GaussianQuadratureCache(Size maxSize = 256)
+            : maxSize_(maxSize) {}
+            enum Family { Laguerre, Hermite, Jacobi, Hyperbolic };
+            struct Rule {
+                Array x, w;
+            };
+            //! the stored rule, or a null pointer if there is none
+            boost::shared_ptr<const Rule> rule(Family family,
+                                               Real p1, Real p2,
+                                               Size n) const;
+            /*! stores the rule unless another one was stored in the
+                meantime or the cache is full; returns the stored rule,
+                or the given one if it was not stored.
+            */
+            boost::shared_ptr<const Rule> add(
+                                    Family family, Real p1, Real p2, Size n,
+                                    const boost::shared_ptr<const Rule>& r);
+            Size size() const;
+            Size maxSize() const { return maxSize_; }
+          private:
+            typedef std::pair<std::pair<int, Size>,
+                              std::pair<Real, Real> > key_type;
+            static key_type key(Family family, Real p1, Real p2, Size n) {
+                return std::make_pair(std::make_pair(int(family), n),
+                                      std::make_pair(p1, p2));
+            }
+            Size maxSize_;
+            std::map<key_type, boost::shared_ptr<const Rule> > rules_;
+            #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+            mutable boost::mutex mutex_;
+            #endif
+        };
+
+    }
+
     //! Integral of a 1-dimensional function using the Gauss quadratures method
     /*! References:
         Gauss quadratures and orthogonal polynomials
@@ -43,6 +103,11 @@ namespace QuantLib {
         "Numerical Recipes in C", 2nd edition,
         Press, Teukolsky, Vetterling, Flannery,
 
+        The quadratures for the standard polynomial families defined
+        below take their nodes and weights from a process-wide cache,
+        so that the eigenvalue decomposition is performed only the
+        first time a given rule is requested.
+
         \test the correctness of the result is tested by checking it
               against known good values.
     */
@@ -59,13 +124,34 @@ namespace QuantLib {
             }
             return sum;
         }
+        //! evaluates the integrand on all the nodes in a single call
+        Real operator()(const BatchIntegrand& f) const {
+            Array fx(order());
+            f(x_.begin(), fx.begin(), order());
+            Real sum = 0.0;
+            for (Integer i = order()-1; i >= 0; --i) {
+                sum += w_[i] * fx[i];
+            }
+            return sum;
+        }
 
         Size order() const { return x_.size(); }
-        const Array& weights() { return w_; }
-        const Array& x()       { return x_; }
+        const Array& weights() const { return w_; }
+        const Array& x() const       { return x_; }
         
       protected:
+        /* takes the nodes and weights from the process-wide cache,
+           calculating and storing them on first use; p1 and p2 are
+           the parameters of the polynomial family. */
+        GaussianQuadrature(Size n,
+                           const GaussianOrthogonalPolynomial& p,
+                           detail::GaussianQuadratureCache::Family family,
+                           Real p1 = 0.0, Real p2 = 0.0);
         Array x_, w_;
+      private:
+        static void calculate(Size n,
+                              const GaussianOrthogonalPolynomial& p,
+                              Array& x, Array& w);
     };
 
 
@@ -83,7 +169,8 @@ namespace QuantLib {
     class GaussLaguerreIntegration : public GaussianQuadrature {
       public:
         GaussLaguerreIntegration(Size n, Real s = 0.0)
-        : GaussianQuadrature(n, GaussLaguerrePolynomial(s)) {}
+        : GaussianQuadrature(n, GaussLaguerrePolynomial(s),
+                             detail::GaussianQuadratureCache::Laguerre, s) {}
     };
 
     //! generalized Gauss-Hermite integration
@@ -100,7 +187,8 @@ namespace QuantLib {
     class GaussHermiteIntegration : public GaussianQuadrature {
       public:
         GaussHermiteIntegration(Size n, Real mu = 0.0)
-        : GaussianQuadrature(n, GaussHermitePolynomial(mu)) {}
+        : GaussianQuadrature(n, GaussHermitePolynomial(mu),
+                             detail::GaussianQuadratureCache::Hermite, mu) {}
     };
 
     //! Gauss-Jacobi integration
@@ -116,7 +204,9 @@ namespace QuantLib {
     class GaussJacobiIntegration : public GaussianQuadrature {
       public:
         GaussJacobiIntegration(Size n, Real alpha, Real beta)
-        : GaussianQuadrature(n, GaussJacobiPolynomial(alpha, beta)) {}
+        : GaussianQuadrature(n, GaussJacobiPolynomial(alpha, beta),
+                             detail::GaussianQuadratureCache::Jacobi,
+                             alpha, beta) {}
     };
 
     //! Gauss-Hyperbolic integration
@@ -132,7 +222,8 @@ namespace QuantLib {
     class GaussHyperbolicIntegration : public GaussianQuadrature {
       public:
         GaussHyperbolicIntegration(Size n)
-        : GaussianQuadrature(n, GaussHyperbolicPolynomial()) {}
+        : GaussianQuadrature(n, GaussHyperbolicPolynomial(),
+                             detail::GaussianQuadratureCache::Hyperbolic) {}
     };
 
     //! Gauss-Legendre integration
@@ -148,7 +239,9 @@ namespace QuantLib {
     class GaussLegendreIntegration : public GaussianQuadrature {
       public:
         GaussLegendreIntegration(Size n)
-        : GaussianQuadrature(n, GaussJacobiPolynomial(0.0, 0.0)) {}
+        : GaussianQuadrature(n, GaussJacobiPolynomial(0.0, 0.0),
+                             detail::GaussianQuadratureCache::Jacobi,
+                             0.0, 0.0) {}
     };
 
     //! Gauss-Chebyshev integration
@@ -164,7 +257,9 @@ namespace QuantLib {
     class GaussChebyshevIntegration : public GaussianQuadrature {
       public:
         GaussChebyshevIntegration(Size n)
-        : GaussianQuadrature(n, GaussJacobiPolynomial(-0.5, -0.5)) {}
+        : GaussianQuadrature(n, GaussJacobiPolynomial(-0.5, -0.5),
+                             detail::GaussianQuadratureCache::Jacobi,
+                             -0.5, -0.5) {}
     };
 
     //! Gauss-Chebyshev integration (second kind)
@@ -180,7 +275,9 @@ namespace QuantLib {
     class GaussChebyshev2ndIntegration : public GaussianQuadrature {
       public:
         GaussChebyshev2ndIntegration(Size n)
-      : GaussianQuadrature(n, GaussJacobiPolynomial(0.5, 0.5)) {}
+      : GaussianQuadrature(n, GaussJacobiPolynomial(0.5, 0.5),
+                           detail::GaussianQuadratureCache::Jacobi,
+                           0.5, 0.5) {}
     };
 
     //! Gauss-Gegenbauer integration
@@ -196,8 +293,9 @@ namespace QuantLib {
     class GaussGegenbauerIntegration : public GaussianQuadrature {
       public:
         GaussGegenbauerIntegration(Size n, Real lambda)
-        : GaussianQuadrature(n, GaussJacobiPolynomial(lambda-0.5, lambda-0.5))
-        {}
+        : GaussianQuadrature(n, GaussJacobiPolynomial(lambda-0.5, lambda-0.5),
+                             detail::GaussianQuadratureCache::Jacobi,
+                             lambda-0.5, lambda-0.5) {}
     };
 
 
@@ -229,6 +327,8 @@ namespace QuantLib {
             }
             return val;
         }
+        //! evaluates the integrand on all the nodes in a single call
+        Real operator() (const BatchIntegrand& f) const;
 
         void order(Size);
         Size order() const { return order_; }
@@ -303,36 +403,162 @@ namespace QuantLib {
 
     // implementation
 
+    namespace detail {
+
+        inline boost::shared_ptr<const GaussianQuadratureCache::Rule>
+        GaussianQuadratureCache::rule(Family family, Real p1, Real p2,
+                                      Size n) const {
+            boost::shared_ptr<const Rule> result;
+            #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+            boost::mutex::scoped_lock guard(mutex_);
+            #elif defined(_OPENMP)
+            #pragma omp critical(ql_gaussian_quadrature_rules)
+            #endif
+            {
+                std::map<key_type,
+                         boost::shared_ptr<const Rule> >::const_iterator
+                    i = rules_.find(key(family, p1, p2, n));
+                if (i != rules_.end())
+                    result = i->second;
+            }
+            return result;
+        }
+
+        inline boost::shared_ptr<const GaussianQuadratureCache::Rule>
+        GaussianQuadratureCache::add(Family family, Real p1, Real p2, Size n,
+                                     const boost::shared_ptr<const Rule>& r) {
+            boost::shared_ptr<const Rule> result = r;
+            const key_type k = key(family, p1, p2, n);
+            #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+            boost::mutex::scoped_lock guard(mutex_);
+            #elif defined(_OPENMP)
+            #pragma omp critical(ql_gaussian_quadrature_rules)
+            #endif
+            {
+                // a rule stored by another thread is not replaced
+                std::map<key_type,
+                         boost::shared_ptr<const Rule> >::const_iterator
+                    i = rules_.find(k);
+                if (i != rules_.end())
+                    result = i->second;
+                else if (rules_.size() < maxSize_)
+                    rules_.insert(std::make_pair(k, r));
+            }
+            return result;
+        }
+
+        inline Size GaussianQuadratureCache::size() const {
+            Size result;
+            #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+            boost::mutex::scoped_lock guard(mutex_);
+            #elif defined(_OPENMP)
+            #pragma omp critical(ql_gaussian_quadrature_rules)
+            #endif
+            {
+                result = rules_.size();
+            }
+            return result;
+        }
+
+    }
+
     inline GaussianQuadrature::GaussianQuadrature(
                                 Size n,
-                                const GaussianOrthogonalPolynomial& orthPoly)
-    : x_(n), w_(n) {
+                                const GaussianOrthogonalPolynomial& orthPoly) {
+        calculate(n, orthPoly, x_, w_);
+    }
+
+    inline GaussianQuadrature::GaussianQuadrature(
+                                Size n,
+                                const GaussianOrthogonalPolynomial& orthPoly,
+                                detail::GaussianQuadratureCache::Family family,
+                                Real p1, Real p2) {
+        typedef detail::GaussianQuadratureCache cache;
+        boost::shared_ptr<const cache::Rule> rule;
+        // the stored rules are protected by the cache itself; this
+        // critical section protects the creation of the singleton
+        // instance when its initialization is not thread-safe
+        cache* instance;
+        #if defined(_OPENMP) && !defined(QL_SINGLETON_THREAD_SAFE_INIT)
+        #pragma omp critical(ql_gaussian_quadrature_cache)
+        #endif
+        {
+            instance = &cache::instance();
+        }
+        rule = instance->rule(family, p1, p2, n);
+        if (!rule) {
+            boost::shared_ptr<cache::Rule> newRule(new cache::Rule);
+            calculate(n, orthPoly, newRule->x, newRule->w);
+            rule = instance->add(family, p1, p2, n, newRule);
+        }
+        x_ = rule->x;
+        w_ = rule->w;
+    }
+
+    inline void GaussianQuadrature::calculate(
+                                Size n,
+                                const GaussianOrthogonalPolynomial& orthPoly,
+                                Array& x, Array& w) {
+        x = Array(n);
+        w = Array(n);
 
         // set-up matrix to compute the roots and the weights
         Array e(n-1);
 
         Size i;
         for (i=1; i < n; ++i) {
-            x_[i] = orthPoly.alpha(i);
+            x[i] = orthPoly.alpha(i);
             e[i-1] = std::sqrt(orthPoly.beta(i));
         }
-        x_[0] = orthPoly.alpha(0);
+        x[0] = orthPoly.alpha(0);
 
         TqrEigenDecomposition tqr(
-                               x_, e,
+                               x, e,
                                TqrEigenDecomposition::OnlyFirstRowEigenVector,
                                TqrEigenDecomposition::Overrelaxation);
 
-        x_ = tqr.eigenvalues();
+        x = tqr.eigenvalues();
         const Matrix& ev = tqr.eigenvectors();
 
         Real mu_0 = orthPoly.mu_0();
         for (i=0; i<n; ++i) {
-            w_[i] = mu_0*ev[0][i]*ev[0][i] / orthPoly.w(x_[i]);
+            w[i] = mu_0*ev[0][i]*ev[0][i] / orthPoly.w(x[i]);
         }
     }
 
 
+    inline Real TabulatedGaussLegendre::operator()(
+                                              const BatchIntegrand& f) const {
+        QL_ASSERT(w_!=0, "Null weights" );
+        QL_ASSERT(x_!=0, "Null abscissas");
+        // the nodes x_[i] and -x_[i] are adjacent; the one at zero of
+        // the odd orders is evaluated only once
+        Real x[2*n20], fx[2*n20];
+        for (Size i=0; i<n_; ++i) {
+            x[2*i] = x_[i];
+            x[2*i+1] = -x_[i];
+        }
+        const Size isOrderOdd = order_ & 1;
+        if (isOrderOdd)
+            x[1] = x_[0];
+        f(x+isOrderOdd, fx+isOrderOdd, 2*n_-isOrderOdd);
+        Size startIdx;
+        Real val;
+        if (isOrderOdd) {
+            QL_ASSERT((n_>0), "assume at least 1 point in quadrature");
+            val = w_[0]*fx[1];
+            startIdx=1;
+        } else {
+            val = 0.0;
+            startIdx=0;
+        }
+        for (Size i=startIdx; i<n_; ++i) {
+            val += w_[i]*fx[2*i];
+            val += w_[i]*fx[2*i+1];
+        }
+        return val;
+    }
+
     inline void TabulatedGaussLegendre::order(Size order) {
         switch(order) {
           case(6):
@@ -28,6 +28,7 @@
 #include <ql/errors.hpp>
 #include <ql/utilities/null.hpp>
 #include <ql/math/integrals/integral.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -58,12 +59,21 @@ namespace QuantLib {
       protected:
         Real integrate (const boost::function<Real (Real)>& f,
                         Real a, Real b) const;
+        /*! The intervals are refined breadth-first, and the 5 new
+            points of all the intervals of a refinement level are
+            evaluated in a single call.  The result is the same as the
+            one of the recursive scalar version.
+        */
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a, Real b) const;
 
         Real adaptivGaussLobattoStep(const boost::function<Real (Real)>& f,
                                      Real a, Real b, Real fa, Real fb,
                                      Real is) const;
         Real calculateAbsTolerance(const boost::function<Real (Real)>& f,
                                    Real a, Real b) const;
+        Real calculateAbsTolerance(const BatchIntegrand& f,
+                                   Real a, Real b) const;
 
         Real relAccuracy_;
         const bool useConvergenceEstimate_;
@@ -97,6 +107,97 @@ namespace QuantLib {
         return adaptivGaussLobattoStep(f, a, b, f(a), f(b), calcAbsTolerance);
     }
 
+    inline Real GaussLobattoIntegral::integrateBatch(
+                                     const BatchIntegrand& f,
+                                     Real a, Real b) const {
+
+        setNumberOfEvaluations(0);
+        const Real acc = calculateAbsTolerance(f, a, b);
+
+        Real ends[] = { a, b }, fEnds[2];
+        f(ends, fEnds, 2);
+        increaseNumberOfEvaluations(2);
+
+        // the intervals of the refinement tree, level by level; the
+        // six parts of a split interval are stored next to each other
+        std::vector<Real> lower(1, a), upper(1, b);
+        std::vector<Real> fLower(1, fEnds[0]), fUpper(1, fEnds[1]);
+        std::vector<Real> value(1);
+        std::vector<Size> firstChild(1, 0);
+        std::vector<Real> x, fx;
+
+        Size begin = 0;
+        while (begin < lower.size()) {
+            const Size end = lower.size();
+            // the same check as at the start of each recursive step
+            QL_REQUIRE(numberOfEvaluations() + 5*(end-begin-1)
+                       < maxEvaluations(),
+                       "max number of iterations reached");
+
+            x.resize(5*(end-begin));
+            fx.resize(x.size());
+            for (Size i=begin; i<end; ++i) {
+                const Real h=(upper[i]-lower[i])/2;
+                const Real m=(lower[i]+upper[i])/2;
+                Real* p = &x[5*(i-begin)];
+                p[0] = m-alpha_()*h;
+                p[1] = m-beta_()*h;
+                p[2] = m;
+                p[3] = m+beta_()*h;
+                p[4] = m+alpha_()*h;
+            }
+            f(&x[0], &fx[0], x.size());
+            increaseNumberOfEvaluations(x.size());
+
+            for (Size i=begin; i<end; ++i) {
+                const Real lo = lower[i], hi = upper[i];
+                const Real flo = fLower[i], fhi = fUpper[i];
+                const Real h=(hi-lo)/2;
+                const Real m=(lo+hi)/2;
+                const Real* p = &x[5*(i-begin)];
+                const Real* q = &fx[5*(i-begin)];
+                const Real mll = p[0], ml = p[1], mr = p[3], mrr = p[4];
+                const Real fmll = q[0], fml = q[1], fm = q[2];
+                const Real fmr = q[3], fmrr = q[4];
+
+                const Real integral2=(h/6)*(flo+fhi+5*(fml+fmr));
+                const Real integral1=(h/1470)*(77*(flo+fhi)
+                                       +432*(fmll+fmrr)+625*(fml+fmr)+672*fm);
+
+                // avoid 80 bit logic on x86 cpu
+                volatile Real dist = acc + (integral1-integral2);
+                if(Real(dist)==acc || mll<=lo || hi<=mrr) {
+                    QL_REQUIRE(m>lo && hi>m,
+                               "Interval contains no more machine number");
+                    value[i] = integral1;
+                } else {
+                    firstChild[i] = lower.size();
+                    const Real nodes[] = { lo, mll, ml, m, mr, mrr, hi };
+                    const Real values[] = { flo, fmll, fml, fm, fmr, fmrr,
+                                            fhi };
+                    for (Size k=0; k<6; ++k) {
+                        lower.push_back(nodes[k]);
+                        upper.push_back(nodes[k+1]);
+                        fLower.push_back(values[k]);
+                        fUpper.push_back(values[k+1]);
+                    }
+                    value.resize(lower.size());
+                    firstChild.resize(lower.size(), 0);
+                }
+            }
+            begin = end;
+        }
+
+        // add up the parts in the same order as the recursion
+        for (Size i=lower.size(); i>0; --i) {
+            const Size c = firstChild[i-1];
+            if (c != 0)
+                value[i-1] = value[c] + value[c+1] + value[c+2]
+                    + value[c+3] + value[c+4] + value[c+5];
+        }
+        return value[0];
+    }
+
     inline Real GaussLobattoIntegral::calculateAbsTolerance(
                                      const boost::function<Real (Real)>& f,
                                      Real a, Real b) const {
@@ -155,6 +256,70 @@ namespace QuantLib {
         }
     }
 
+    inline Real GaussLobattoIntegral::calculateAbsTolerance(
+                                     const BatchIntegrand& f,
+                                     Real a, Real b) const {
+
+
+        Real relTol = std::max(relAccuracy_, QL_EPSILON);
+
+        const Real m = (a+b)/2;
+        const Real h = (b-a)/2;
+        const Real x[] = { a, m-alpha_()*h, m-beta_()*h, m,
+                           m+beta_()*h, m+alpha_()*h, b,
+                           m-x1_()*h, m+x1_()*h, m-x2_()*h, m+x2_()*h,
+                           m-x3_()*h, m+x3_()*h };
+        Real y[13];
+        f(x, y, 13);
+        const Real y1 = y[0];
+        const Real y3 = y[1];
+        const Real y5 = y[2];
+        const Real y7 = y[3];
+        const Real y9 = y[4];
+        const Real y11= y[5];
+        const Real y13= y[6];
+
+        const Real f1 = y[7];
+        const Real f2 = y[8];
+        const Real f3 = y[9];
+        const Real f4 = y[10];
+        const Real f5 = y[11];
+        const Real f6 = y[12];
+
+        Real acc=h*(0.0158271919734801831*(y1+y13)
+                  +0.0942738402188500455*(f1+f2)
+                  +0.1550719873365853963*(y3+y11)
+                  +0.1888215739601824544*(f3+f4)
+                  +0.1997734052268585268*(y5+y9)
+                  +0.2249264653333395270*(f5+f6)
+                  +0.2426110719014077338*y7);
+
+        increaseNumberOfEvaluations(13);
+        if (acc == 0.0 && (   f1 != 0.0 || f2 != 0.0 || f3 != 0.0
+                           || f4 != 0.0 || f5 != 0.0 || f6 != 0.0)) {
+            QL_FAIL("can not calculate absolute accuracy "
+                    "from relative accuracy");
+        }
+
+        Real r = 1.0;
+        if (useConvergenceEstimate_) {
+            const Real integral2 = (h/6)*(y1+y13+5*(y5+y9));
+            const Real integral1 = (h/1470)*(77*(y1+y13)+432*(y3+y11)+
+                                             625*(y5+y9)+672*y7);
+
+            if (std::fabs(integral2-acc) != 0.0)
+                r = std::fabs(integral1-acc)/std::fabs(integral2-acc);
+            if (r == 0.0 || r > 1.0)
+                r = 1.0;
+        }
+
+        if (relAccuracy_ != Null<Real>())
+            return std::min(absoluteAccuracy(), acc*relTol)/(r*QL_EPSILON);
+        else {
+            return absoluteAccuracy()/(r*QL_EPSILON);
+        }
+    }
+
     inline Real GaussLobattoIntegral::adaptivGaussLobattoStep(
                                      const boost::function<Real (Real)>& f,
                                      Real a, Real b, Real fa, Real fb,
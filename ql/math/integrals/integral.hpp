@@ -28,6 +28,43 @@
 
 namespace QuantLib {
 
+    //! integrand evaluated on a batch of points
+    /*! Wraps a function or functor f such that f(x, fx, n) sets fx[i]
+        to the value of the integrand at x[i] for i in [0,n).  Passed
+        to an integrator instead of a scalar function, it allows the
+        nodes of a rule, or of a refinement level of an adaptive rule,
+        to be evaluated in a single call.
+    */
+    class BatchIntegrand {
+      public:
+        BatchIntegrand() {}
+        template <class F>
+        explicit BatchIntegrand(const F& f) : f_(f) {}
+        void operator()(const Real* x, Real* fx, Size n) const {
+            f_(x, fx, n);
+        }
+      private:
+        boost::function<void (const Real*, Real*, Size)> f_;
+    };
+
+    namespace detail {
+
+        // evaluates a batch integrand at a single point
+        class BatchIntegrandPoint {
+          public:
+            explicit BatchIntegrandPoint(const BatchIntegrand& f)
+            : f_(f) {}
+            Real operator()(Real x) const {
+                Real fx;
+                f_(&x, &fx, 1);
+                return fx;
+            }
+          private:
+            const BatchIntegrand& f_;
+        };
+
+    }
+
     class Integrator{
       public:
         Integrator(Real absoluteAccuracy,
@@ -37,6 +74,10 @@ namespace QuantLib {
         Real operator()(const boost::function<Real (Real)>& f,
                         Real a,
                         Real b) const;
+        //! integrates a function evaluated on batches of points
+        Real operator()(const BatchIntegrand& f,
+                        Real a,
+                        Real b) const;
 
         //! \name Modifiers
         //@{
@@ -60,6 +101,13 @@ namespace QuantLib {
         virtual Real integrate(const boost::function<Real (Real)>& f,
                                Real a,
                                Real b) const = 0;
+        /*! The default implementation passes the points one at a
+            time to integrate(); it is overridden by the integrators
+            which can evaluate several points at once.
+        */
+        virtual Real integrateBatch(const BatchIntegrand& f,
+                                    Real a,
+                                    Real b) const;
         void setAbsoluteError(Real error) const;
         void setNumberOfEvaluations(Size evaluations) const;
         void increaseNumberOfEvaluations(Size increase) const;
@@ -135,6 +183,24 @@ namespace QuantLib {
             return -integrate(f, b, a);
     }
 
+    inline Real Integrator::operator()(const BatchIntegrand& f,
+                                       Real a,
+                                       Real b) const {
+        evaluations_ = 0;
+        if (a == b)
+            return 0.0;
+        if (b > a)
+            return integrateBatch(f, a, b);
+        else
+            return -integrateBatch(f, b, a);
+    }
+
+    inline Real Integrator::integrateBatch(const BatchIntegrand& f,
+                                           Real a,
+                                           Real b) const {
+        return integrate(detail::BatchIntegrandPoint(f), a, b);
+    }
+
 
 }
 
@@ -30,6 +30,7 @@
 #include <ql/utilities/null.hpp>
 #include <ql/math/integrals/integral.hpp>
 #include <boost/function.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -60,6 +61,10 @@ namespace QuantLib {
         Real integrate(const boost::function<Real (Real)>& f,
                        Real a,
                        Real b) const;
+        //! evaluates the new points of each rule in a single call
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a,
+                            Real b) const;
       private:
         Real relativeAccuracy_;
     };
@@ -91,6 +96,14 @@ namespace QuantLib {
           Real integrate(const boost::function<Real (Real)>& f,
                          Real a,
                          Real b) const;
+          /*! The intervals are refined breadth-first, and the 15
+              points of all the intervals of a refinement level are
+              evaluated in a single call.  The result is the same as
+              the one of the recursive scalar version.
+          */
+          Real integrateBatch(const BatchIntegrand& f,
+                              Real a,
+                              Real b) const;
       private:
           Real integrateRecursively(const boost::function<Real (Real)>& f,
                                     Real a,
@@ -446,6 +459,145 @@ namespace QuantLib {
         return result;
     }
 
+    inline Real
+    GaussKronrodNonAdaptive::integrateBatch(const BatchIntegrand& f,
+                                            Real a,
+                                            Real b) const {
+        Real result;
+        //Size neval;
+        Real fv1[5], fv2[5], fv3[5], fv4[5];
+        Real savfun[21];  /* array of function values which have been computed */
+        Real res10, res21, res43, res87;    /* 10, 21, 43 and 87 point results */
+        Real err;
+        Real resAbs; /* approximation to the integral of abs(f) */
+        Real resasc; /* approximation to the integral of abs(f-i/(b-a)) */
+        int k ;
+
+        // abscissae and function values of each rule; the points
+        // center+abscissa and center-abscissa are adjacent
+        Real x[44], fx[44];
+
+        QL_REQUIRE(a<b, "b must be greater than a)");
+
+        const Real halfLength = 0.5 * (b - a);
+        const Real center = 0.5 * (b + a);
+
+        // Compute the integral using the 10- and 21-point formula.
+
+        x[0] = center;
+        for (k = 0; k < 5; k++) {
+            x[2*k+1] = center + halfLength * x1[k];
+            x[2*k+2] = center - halfLength * x1[k];
+            x[2*k+11] = center + halfLength * x2[k];
+            x[2*k+12] = center - halfLength * x2[k];
+        }
+        f(x, fx, 21);
+        const Real fCenter = fx[0];
+
+        res10 = 0;
+        res21 = w21b[5] * fCenter;
+        resAbs = w21b[5] * std::fabs(fCenter);
+
+        for (k = 0; k < 5; k++) {
+            Real fval1 = fx[2*k+1];
+            Real fval2 = fx[2*k+2];
+            Real fval = fval1 + fval2;
+            res10 += w10[k] * fval;
+            res21 += w21a[k] * fval;
+            resAbs += w21a[k] * (std::fabs(fval1) + std::fabs(fval2));
+            savfun[k] = fval;
+            fv1[k] = fval1;
+            fv2[k] = fval2;
+        }
+
+        for (k = 0; k < 5; k++) {
+            Real fval1 = fx[2*k+11];
+            Real fval2 = fx[2*k+12];
+            Real fval = fval1 + fval2;
+            res21 += w21b[k] * fval;
+            resAbs += w21b[k] * (std::fabs(fval1) + std::fabs(fval2));
+            savfun[k + 5] = fval;
+            fv3[k] = fval1;
+            fv4[k] = fval2;
+        }
+
+        result = res21 * halfLength;
+        resAbs *= halfLength ;
+        Real mean = 0.5 * res21;
+        resasc = w21b[5] * std::fabs(fCenter - mean);
+
+        for (k = 0; k < 5; k++)
+            resasc += (w21a[k] * (std::fabs(fv1[k] - mean)
+                        + std::fabs(fv2[k] - mean))
+                        + w21b[k] * (std::fabs(fv3[k] - mean)
+                        + std::fabs(fv4[k] - mean)));
+
+        err = rescaleError ((res21 - res10) * halfLength, resAbs, resasc) ;
+        resasc *= halfLength ;
+
+        // test for convergence.
+        if (err < absoluteAccuracy() || err < relativeAccuracy() * std::fabs(result)){
+            setAbsoluteError(err);
+            setNumberOfEvaluations(21);
+            return result;
+        }
+
+        /* compute the integral using the 43-point formula. */
+
+        for (k = 0; k < 11; k++) {
+            x[2*k] = center + halfLength * x3[k];
+            x[2*k+1] = center - halfLength * x3[k];
+        }
+        f(x, fx, 22);
+
+        res43 = w43b[11] * fCenter;
+
+        for (k = 0; k < 10; k++)
+            res43 += savfun[k] * w43a[k];
+
+        for (k = 0; k < 11; k++){
+            Real fval = fx[2*k] + fx[2*k+1];
+            res43 += fval * w43b[k];
+            savfun[k + 10] = fval;
+            }
+
+        // test for convergence.
+
+        result = res43 * halfLength;
+        err = rescaleError ((res43 - res21) * halfLength, resAbs, resasc);
+
+       if (err < absoluteAccuracy() || err < relativeAccuracy() * std::fabs(result)){
+            setAbsoluteError(err);
+            setNumberOfEvaluations(43);
+            return result;
+        }
+
+        /* compute the integral using the 87-point formula. */
+
+        for (k = 0; k < 22; k++) {
+            x[2*k] = center + halfLength * x4[k];
+            x[2*k+1] = center - halfLength * x4[k];
+        }
+        f(x, fx, 44);
+
+        res87 = w87b[22] * fCenter;
+
+        for (k = 0; k < 21; k++)
+            res87 += savfun[k] * w87a[k];
+
+        for (k = 0; k < 22; k++){
+            res87 += w87b[k] * (fx[2*k] + fx[2*k+1]);
+        }
+
+        // test for convergence.
+        result = res87 * halfLength ;
+        err = rescaleError ((res87 - res43) * halfLength, resAbs, resasc);
+
+        setAbsoluteError(err);
+        setNumberOfEvaluations(87);
+        return result;
+    }
+
     inline Real
     GaussKronrodAdaptive::integrate(const boost::function<Real (Real)>& f,
                                     Real a,
@@ -534,6 +686,89 @@ namespace QuantLib {
             }
         }
 
+    inline Real
+    GaussKronrodAdaptive::integrateBatch(const BatchIntegrand& f,
+                                         Real a,
+                                         Real b) const {
+        // the intervals of the refinement tree, level by level; the
+        // two halves of a split interval are stored next to each other
+        std::vector<Real> lower(1, a), upper(1, b);
+        std::vector<Real> tolerance(1, absoluteAccuracy()), value(1);
+        std::vector<Size> firstChild(1, 0);
+        std::vector<Real> x, fx;
+
+        Size begin = 0;
+        while (begin < lower.size()) {
+            const Size end = lower.size();
+            x.resize(15*(end-begin));
+            fx.resize(x.size());
+            for (Size i=begin; i<end; ++i) {
+                const Real halflength = (upper[i] - lower[i]) / 2;
+                const Real center = (lower[i] + upper[i]) / 2;
+                Real* p = &x[15*(i-begin)];
+                p[0] = center;
+                for (Size j=1; j<8; ++j) {
+                    const Real t = halflength * k15t[j];
+                    p[2*j-1] = center - t;
+                    p[2*j] = center + t;
+                }
+            }
+            f(&x[0], &fx[0], x.size());
+            increaseNumberOfEvaluations(x.size());
+
+            Size splits = 0;
+            for (Size i=begin; i<end; ++i) {
+                const Real* q = &fx[15*(i-begin)];
+                const Real halflength = (upper[i] - lower[i]) / 2;
+                const Real center = (lower[i] + upper[i]) / 2;
+
+                // same sums as in integrateRecursively
+                Real g7 = q[0] * g7w[0];
+                Real k15 = q[0] * k15w[0];
+                Integer j, j2;
+                for (j = 1, j2 = 2; j < 4; j++, j2 += 2) {
+                    const Real fsum = q[2*j2-1] + q[2*j2];
+                    g7  += fsum * g7w[j];
+                    k15 += fsum * k15w[j2];
+                }
+                for (j2 = 1; j2 < 8; j2 += 2) {
+                    const Real fsum = q[2*j2-1] + q[2*j2];
+                    k15 += fsum * k15w[j2];
+                }
+                g7 = halflength * g7;
+                k15 = halflength * k15;
+
+                if (std::fabs(k15 - g7) < tolerance[i]) {
+                    value[i] = k15;
+                } else {
+                    ++splits;
+                    QL_REQUIRE(numberOfEvaluations()+30*splits <=
+                               maxEvaluations(),
+                               "maximum number of function evaluations "
+                               "exceeded");
+                    firstChild[i] = lower.size();
+                    const Real halfTolerance = tolerance[i]/2;
+                    lower.push_back(lower[i]);
+                    upper.push_back(center);
+                    lower.push_back(center);
+                    upper.push_back(upper[i]);
+                    tolerance.resize(lower.size(), halfTolerance);
+                    value.resize(lower.size());
+                    firstChild.resize(lower.size(), 0);
+                }
+            }
+            begin = end;
+        }
+
+        // add up the halves in the same order as the recursion
+        for (Size i=lower.size(); i>0; --i) {
+            const Size c = firstChild[i-1];
+            if (c != 0)
+                value[i-1] = value[c] + value[c+1];
+        }
+        return value[0];
+    }
+
 
     inline GaussKronrodAdaptive::GaussKronrodAdaptive(Real absoluteAccuracy,
                                                Size maxEvaluations)
@@ -0,0 +1,272 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file multidimensionalquadrature.hpp
+    \brief tensor-product and sparse-grid Gaussian quadratures
+*/
+
+#ifndef quantlib_multidimensional_quadrature_hpp
+#define quantlib_multidimensional_quadrature_hpp
+
+#include <ql/math/integrals/gaussianquadratures.hpp>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace QuantLib {
+
+    //! multi-dimensional quadrature with precomputed nodes and weights
+    /*! The integral is approximated as
+        \f[
+        \sum_k w_k f(x_k)
+        \f]
+        where the points \f$ x_k \f$ and the weights \f$ w_k \f$ are
+        calculated once on construction.  The coordinates of the
+        points are stored in a single flat array, point k being given
+        by nodes()[k*dimensions()], ...,
+        nodes()[k*dimensions()+dimensions()-1].
+
+        The integrand can be a function taking a
+        <tt>std::vector<Real></tt>, or a BatchIntegrand, which is
+        passed all the points in a single call laid out as above.
+    */
+    class MultidimensionalQuadrature {
+      public:
+        template <class F>
+        Real operator()(const F& f) const {
+            std::vector<Real> x(dimensions_);
+            Real sum = 0.0;
+            for (Size k=0; k<weights_.size(); ++k) {
+                std::copy(nodes_.begin() + k*dimensions_,
+                          nodes_.begin() + (k+1)*dimensions_, x.begin());
+                sum += weights_[k] * f(x);
+            }
+            return sum;
+        }
+        //! evaluates the integrand on all the points in a single call
+        Real operator()(const BatchIntegrand& f) const;
+
+        Size dimensions() const { return dimensions_; }
+        //! number of points
+        Size size() const { return weights_.size(); }
+        const std::vector<Real>& nodes() const { return nodes_; }
+        const std::vector<Real>& weights() const { return weights_; }
+
+      protected:
+        explicit MultidimensionalQuadrature(Size dimensions)
+        : dimensions_(dimensions) {}
+        /* appends the points of the tensor product of the given
+           rules, the last axis running fastest, and their weights
+           multiplied by factor. */
+        static void tensorProduct(
+                         const std::vector<const GaussianQuadrature*>& rules,
+                         Real factor,
+                         std::vector<Real>& nodes,
+                         std::vector<Real>& weights);
+        Size dimensions_;
+        std::vector<Real> nodes_, weights_;
+    };
+
+
+    //! tensor-product Gaussian quadrature
+    /*! The points are the tensor product of the nodes of
+        one-dimensional Gaussian quadratures, one for each axis; the
+        weighting function is the product of theirs.  The number of
+        points grows as the product of the orders of the rules, which
+        limits its use to a few dimensions.
+
+        \test the integral of an exponential is checked against its
+              closed form in 4 dimensions, and the batch integrand
+              against the scalar one.
+    */
+    class GaussianTensorProductIntegration
+        : public MultidimensionalQuadrature {
+      public:
+        //! rules[i] is the quadrature along the axis i
+        explicit GaussianTensorProductIntegration(
+                           const std::vector<GaussianQuadrature>& rules);
+        //! the same quadrature along each of the given number of axes
+        GaussianTensorProductIntegration(Size dimensions,
+                                         const GaussianQuadrature& rule);
+      private:
+        void initialize(const std::vector<const GaussianQuadrature*>& rules);
+    };
+
+
+    //! sparse-grid (Smolyak) Gaussian quadrature
+    /*! For a level \f$ L \f$ in \f$ d \f$ dimensions, the quadrature
+        is the combination
+        \f[
+        \sum_{L \le |l| \le L+d-1} (-1)^{L+d-1-|l|}
+            \binom{d-1}{L+d-1-|l|}
+            U_{l_1} \otimes \dots \otimes U_{l_d}
+        \f]
+        of tensor products of the one-dimensional rules \f$ U_1,
+        \dots, U_L \f$ given for each level, \f$ l \f$ running over
+        the multi-indices with \f$ l_i \ge 1 \f$.  Points shared by
+        several products are merged.  With rules of order \f$ l \f$
+        at level \f$ l \f$ the quadrature is exact for polynomials of
+        total degree up to \f$ 2L-1 \f$, using far fewer points than
+        the tensor product of the rule of order \f$ L \f$.
+
+        Some of the weights are negative.
+
+        \test the quadrature is checked to be exact on polynomials
+              and against the closed form of an exponential in 5
+              dimensions.
+    */
+    class GaussianSparseGridIntegration : public MultidimensionalQuadrature {
+      public:
+        /*! rules[l-1] is the one-dimensional quadrature at level l;
+            the level of the sparse grid is rules.size().
+        */
+        GaussianSparseGridIntegration(
+                           Size dimensions,
+                           const std::vector<GaussianQuadrature>& rules);
+        Size level() const { return level_; }
+      private:
+        Size level_;
+    };
+
+
+    // inline definitions
+
+    inline Real MultidimensionalQuadrature::operator()(
+                                           const BatchIntegrand& f) const {
+        const Size n = weights_.size();
+        std::vector<Real> fx(n);
+        f(&nodes_[0], &fx[0], n);
+        Real sum = 0.0;
+        for (Size k=0; k<n; ++k)
+            sum += weights_[k] * fx[k];
+        return sum;
+    }
+
+    inline void MultidimensionalQuadrature::tensorProduct(
+                         const std::vector<const GaussianQuadrature*>& rules,
+                         Real factor,
+                         std::vector<Real>& nodes,
+                         std::vector<Real>& weights) {
+        const Size n = rules.size();
+        std::vector<Size> k(n, 0);
+        for (;;) {
+            Real w = factor;
+            for (Size i=0; i<n; ++i) {
+                nodes.push_back(rules[i]->x()[k[i]]);
+                w *= rules[i]->weights()[k[i]];
+            }
+            weights.push_back(w);
+            // next point
+            Size i = n;
+            while (i > 0 && ++k[i-1] == rules[i-1]->order())
+                k[--i] = 0;
+            if (i == 0)
+                return;
+        }
+    }
+
+
+    inline GaussianTensorProductIntegration::GaussianTensorProductIntegration(
+                           const std::vector<GaussianQuadrature>& rules)
+    : MultidimensionalQuadrature(rules.size()) {
+        std::vector<const GaussianQuadrature*> r(rules.size());
+        for (Size i=0; i<rules.size(); ++i)
+            r[i] = &rules[i];
+        initialize(r);
+    }
+
+    inline GaussianTensorProductIntegration::GaussianTensorProductIntegration(
+                           Size dimensions, const GaussianQuadrature& rule)
+    : MultidimensionalQuadrature(dimensions) {
+        initialize(std::vector<const GaussianQuadrature*>(dimensions, &rule));
+    }
+
+    inline void GaussianTensorProductIntegration::initialize(
+                      const std::vector<const GaussianQuadrature*>& rules) {
+        QL_REQUIRE(!rules.empty(), "no dimensions given");
+        Size size = 1;
+        for (Size i=0; i<rules.size(); ++i) {
+            QL_REQUIRE(rules[i]->order() > 0,
+                       "empty quadrature along axis " << i);
+            size *= rules[i]->order();
+        }
+        nodes_.reserve(size*dimensions_);
+        weights_.reserve(size);
+        tensorProduct(rules, 1.0, nodes_, weights_);
+    }
+
+
+    inline GaussianSparseGridIntegration::GaussianSparseGridIntegration(
+                           Size dimensions,
+                           const std::vector<GaussianQuadrature>& rules)
+    : MultidimensionalQuadrature(dimensions), level_(rules.size()) {
+        QL_REQUIRE(dimensions > 0, "no dimensions given");
+        QL_REQUIRE(level_ > 0, "no rules given");
+        for (Size l=0; l<level_; ++l)
+            QL_REQUIRE(rules[l].order() > 0,
+                       "empty quadrature at level " << l+1);
+
+        // all the tensor products, possibly with repeated points...
+        const Size d = dimensions, q = level_ + d - 1;
+        std::vector<Real> nodes, weights;
+        std::vector<Size> l(d, 1);
+        std::vector<const GaussianQuadrature*> r(d, &rules[0]);
+        Size sum = d;
+        for (;;) {
+            if (sum >= level_) {
+                // (-1)^(q-|l|) binomial(d-1, q-|l|)
+                const Size m = q - sum;
+                Real c = 1.0;
+                for (Size j=0; j<m; ++j)
+                    c *= -Real(d-1-j)/Real(j+1);
+                for (Size i=0; i<d; ++i)
+                    r[i] = &rules[l[i]-1];
+                tensorProduct(r, c, nodes, weights);
+            }
+            // next multi-index with |l| <= q
+            Size i = d;
+            while (i > 0 && (sum == q || l[i-1] == level_)) {
+                sum -= l[i-1]-1;
+                l[--i] = 1;
+            }
+            if (i == 0)
+                break;
+            ++l[i-1];
+            ++sum;
+        }
+
+        // ...and their merge
+        std::map<std::vector<Real>, Real> points;
+        for (Size k=0; k<weights.size(); ++k)
+            points[std::vector<Real>(nodes.begin() + k*d,
+                                     nodes.begin() + (k+1)*d)]
+                += weights[k];
+        nodes_.reserve(points.size()*d);
+        weights_.reserve(points.size());
+        for (std::map<std::vector<Real>, Real>::const_iterator
+                 p = points.begin(); p != points.end(); ++p) {
+            if (p->second != 0.0) {
+                nodes_.insert(nodes_.end(), p->first.begin(), p->first.end());
+                weights_.push_back(p->second);
+            }
+        }
+    }
+
+}
+
+
+#endif
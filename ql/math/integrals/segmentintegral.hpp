@@ -28,6 +28,7 @@
 #include <ql/math/integrals/integral.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/errors.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -54,6 +55,9 @@ namespace QuantLib {
         virtual Real integrate(const boost::function<Real (Real)>& f,
                                Real a,
                                Real b) const;
+        virtual Real integrateBatch(const BatchIntegrand& f,
+                                    Real a,
+                                    Real b) const;
       private:
         Size intervals_;
     };
@@ -75,6 +79,28 @@ namespace QuantLib {
         return sum*dx;
     }
 
+    inline Real
+    SegmentIntegral::integrateBatch(const BatchIntegrand& f,
+                                    Real a,
+                                    Real b) const {
+        if(close_enough(a,b))
+            return 0.0;
+        Real dx = (b-a)/intervals_;
+        Real end = b - 0.5*dx;
+        // the end points first, then the inner ones
+        std::vector<Real> x(2), fx;
+        x[0] = a;
+        x[1] = b;
+        for (Real xi = a+dx; xi < end; xi += dx)
+            x.push_back(xi);
+        fx.resize(x.size());
+        f(&x[0], &fx[0], x.size());
+        Real sum = 0.5*(fx[0]+fx[1]);
+        for (Size i=2; i<x.size(); ++i)
+            sum += fx[i];
+        return sum*dx;
+    }
+
     // implementation
 
     inline SegmentIntegral::SegmentIntegral(Size intervals)
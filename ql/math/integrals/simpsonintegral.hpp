@@ -64,6 +64,34 @@ namespace QuantLib {
             } while (i < maxEvaluations());
             QL_FAIL("max number of iterations reached");
         }
+
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a,
+                            Real b) const {
+
+            // start from the coarsest trapezoid...
+            Size N = 1;
+            Real ends[] = { a, b }, fEnds[2];
+            f(ends, fEnds, 2);
+            Real I = (fEnds[0]+fEnds[1])*(b-a)/2.0, newI;
+            Real adjI = I, newAdjI;
+            // ...and refine it
+            Size i = 1;
+            do {
+                newI = Default::integrate(f,a,b,I,N);
+                N *= 2;
+                newAdjI = (4.0*newI-I)/3.0;
+                // good enough? Also, don't run away immediately
+                if (std::fabs(adjI-newAdjI) <= absoluteAccuracy() && i > 5)
+                    // ok, exit
+                    return newAdjI;
+                // oh well. Another step.
+                I = newI;
+                adjI = newAdjI;
+                i++;
+            } while (i < maxEvaluations());
+            QL_FAIL("max number of iterations reached");
+        }
     };
 
 }
@@ -28,6 +28,7 @@
 #include <ql/math/integrals/integral.hpp>
 #include <ql/utilities/null.hpp>
 #include <ql/errors.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -78,9 +79,36 @@ namespace QuantLib {
             } while (i < maxEvaluations());
             QL_FAIL("max number of iterations reached");
         }
+
+        Real integrateBatch(const BatchIntegrand& f,
+                            Real a,
+                            Real b) const {
+
+            // start from the coarsest trapezoid...
+            Size N = 1;
+            Real ends[] = { a, b }, fEnds[2];
+            f(ends, fEnds, 2);
+            Real I = (fEnds[0]+fEnds[1])*(b-a)/2.0, newI;
+            // ...and refine it
+            Size i = 1;
+            do {
+                newI = IntegrationPolicy::integrate(f,a,b,I,N);
+                N *= IntegrationPolicy::nbEvalutions();
+                // good enough? Also, don't run away immediately
+                if (std::fabs(I-newI) <= absoluteAccuracy() && i > 5)
+                    // ok, exit
+                    return newI;
+                // oh well. Another step.
+                I = newI;
+                i++;
+            } while (i < maxEvaluations());
+            QL_FAIL("max number of iterations reached");
+        }
     };
 
     // Integration policies
+    /* The batch versions evaluate all the new points of a
+       refinement level in a single call. */
     struct Default {
         inline static Real integrate(const boost::function<Real (Real)>& f, 
                                      Real a, 
@@ -95,6 +123,23 @@ namespace QuantLib {
                 sum += f(x);
             return (I + dx*sum)/2.0;
         }
+        inline static Real integrate(const BatchIntegrand& f,
+                                     Real a,
+                                     Real b,
+                                     Real I,
+                                     Size N)
+        {
+            Real dx = (b-a)/N;
+            std::vector<Real> x(N), fx(N);
+            Real xi = a + dx/2.0;
+            for (Size i=0; i<N; xi += dx, ++i)
+                x[i] = xi;
+            f(&x[0], &fx[0], N);
+            Real sum = 0.0;
+            for (Size i=0; i<N; ++i)
+                sum += fx[i];
+            return (I + dx*sum)/2.0;
+        }
         inline static Size nbEvalutions(){ return 2;}
     };
 
@@ -113,6 +158,27 @@ namespace QuantLib {
                 sum += f(x) + f(x+D);
             return (I + dx*sum)/3.0;
         }
+        inline static Real integrate(const BatchIntegrand& f,
+                                     Real a,
+                                     Real b,
+                                     Real I,
+                                     Size N)
+        {
+            Real dx = (b-a)/N;
+            Real D = 2.0*dx/3.0;
+            // x and x+D for each interval
+            std::vector<Real> x(2*N), fx(2*N);
+            Real xi = a + dx/6.0;
+            for (Size i=0; i<N; xi += dx, ++i) {
+                x[2*i] = xi;
+                x[2*i+1] = xi+D;
+            }
+            f(&x[0], &fx[0], 2*N);
+            Real sum = 0.0;
+            for (Size i=0; i<N; ++i)
+                sum += fx[2*i] + fx[2*i+1];
+            return (I + dx*sum)/3.0;
+        }
         inline static Size nbEvalutions(){ return 3;}
     };
 
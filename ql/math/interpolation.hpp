@@ -30,6 +30,8 @@
 #include <ql/math/comparison.hpp>
 #include <ql/errors.hpp>
 #include <vector>
+#include <algorithm>
+#include <functional>
 
 namespace QuantLib {
 
@@ -55,6 +57,21 @@ namespace QuantLib {
             virtual Real primitive(Real) const = 0;
             virtual Real derivative(Real) const = 0;
             virtual Real secondDerivative(Real) const = 0;
+            /*! batch evaluation at the n points starting at x; the
+                default implementations evaluate point by point.
+                If sorted is true, the points are in increasing order.
+            */
+            virtual void values(const Real* x, Size n, Real* result,
+                                bool sorted) const {
+                for (Size k=0; k<n; ++k)
+                    result[k] = value(x[k]);
+            }
+            virtual void derivatives(const Real* x, Size n, Real* result,
+                                     bool sorted) const {
+                for (Size k=0; k<n; ++k)
+                    result[k] = derivative(x[k]);
+            }
+            virtual void enableLocalityHint(bool) {}
         };
         boost::shared_ptr<Impl> impl_;
       public:
@@ -66,7 +83,8 @@ namespace QuantLib {
           public:
             templateImpl(const I1& xBegin, const I1& xEnd, const I2& yBegin,
                          const int requiredPoints = 2)
-            : xBegin_(xBegin), xEnd_(xEnd), yBegin_(yBegin) {
+            : xBegin_(xBegin), xEnd_(xEnd), yBegin_(yBegin),
+              hint_(0), useHint_(false) {
                 QL_REQUIRE(static_cast<int>(xEnd_-xBegin_) >= requiredPoints,
                            "not enough points to interpolate: at least " <<
                            requiredPoints <<
@@ -92,6 +110,10 @@ namespace QuantLib {
                 Real x1 = xMin(), x2 = xMax();
                 return (x >= x1 && x <= x2) || close(x,x1) || close(x,x2);
             }
+            void enableLocalityHint(bool flag) {
+                useHint_ = flag;
+                hint_ = 0;
+            }
           protected:
             Size locate(Real x) const {
                 #if defined(QL_EXTRA_SAFETY_CHECKS)
@@ -102,11 +124,79 @@ namespace QuantLib {
                     return 0;
                 else if (x > *(xEnd_-1))
                     return xEnd_-xBegin_-2;
+                else if (useHint_)
+                    return hintedLocate(x);
                 else
                     return std::upper_bound(xBegin_,xEnd_-1,x)-xBegin_-1;
             }
+            /*! same as locate() for x in [xMin, xMax]; the search
+                starts from the previously located segment and widens
+                exponentially, so that its cost is logarithmic in the
+                distance between consecutive queries.
+            */
+            Size hintedLocate(Real x) const {
+                const Size last = (xEnd_-xBegin_)-1;
+                Size lo = std::min(hint_, last-1), hi;
+                if (xBegin_[lo] <= x) {
+                    Size step = 1;
+                    hi = lo+1;
+                    while (hi < last && xBegin_[hi] <= x) {
+                        lo = hi;
+                        step *= 2;
+                        hi = std::min(last, lo+step);
+                    }
+                } else {
+                    Size step = 1;
+                    hi = lo;
+                    lo = hi-1;
+                    while (lo > 0 && xBegin_[lo] > x) {
+                        hi = lo;
+                        step *= 2;
+                        lo = (lo > step) ? lo-step : 0;
+                    }
+                }
+                hint_ = std::upper_bound(xBegin_+lo,xBegin_+hi,x)-xBegin_-1;
+                return hint_;
+            }
+            /*! calls the given kernel, with the index of the segment
+                as returned by locate(), on runs of consecutive points
+                lying in the same segment.  Sorted points are located
+                in a single sweep over the segments, so that each run
+                can be processed by a tight loop.
+            */
+            template <class Derived>
+            void evaluateBySegment(
+                    const Derived* impl,
+                    void (Derived::*kernel)(Size, const Real*,
+                                            Size, Real*) const,
+                    const Real* x, Size n, Real* result,
+                    bool sorted) const {
+                if (!sorted) {
+                    for (Size k=0; k<n; ++k)
+                        (impl->*kernel)(locate(x[k]), x+k, 1, result+k);
+                    return;
+                }
+                const Size last = (xEnd_-xBegin_)-2;
+                Size i = 0, k = 0;
+                while (k < n) {
+                    while (i < last && xBegin_[i+1] <= x[k])
+                        ++i;
+                    Size end = n;
+                    if (i < last) {
+                        const Real right = xBegin_[i+1];
+                        end = k+1;
+                        while (end < n && x[end] < right)
+                            ++end;
+                    }
+                    (impl->*kernel)(i, x+k, end-k, result+k);
+                    k = end;
+                }
+            }
             I1 xBegin_, xEnd_;
             I2 yBegin_;
+          private:
+            mutable Size hint_;
+            bool useHint_;
         };
       public:
         Interpolation() {}
@@ -128,6 +218,24 @@ namespace QuantLib {
             checkRange(x,allowExtrapolation);
             return impl_->secondDerivative(x);
         }
+        /*! \name Batch evaluation
+            The points in [xBegin, xEnd) are evaluated at once and
+            the results written starting at result.  If the points
+            are sorted in increasing order, the interpolation locates
+            them in a single sweep instead of a search per point.
+        */
+        //@{
+        void values(const Real* xBegin, const Real* xEnd, Real* result,
+                    bool allowExtrapolation = false) const {
+            const bool sorted = checkRange(xBegin, xEnd, allowExtrapolation);
+            impl_->values(xBegin, xEnd-xBegin, result, sorted);
+        }
+        void derivatives(const Real* xBegin, const Real* xEnd, Real* result,
+                         bool allowExtrapolation = false) const {
+            const bool sorted = checkRange(xBegin, xEnd, allowExtrapolation);
+            impl_->derivatives(xBegin, xEnd-xBegin, result, sorted);
+        }
+        //@}
         Real xMin() const {
             return impl_->xMin();
         }
@@ -137,6 +245,17 @@ namespace QuantLib {
         bool isInRange(Real x) const {
             return impl_->isInRange(x);
         }
+        /*! enables or disables a segment lookup starting from the
+            segment found by the previous one, which speeds up
+            repeated queries at nearby points.
+
+            \warning the hint is cached by the interpolation, which
+                     must therefore not be used concurrently by
+                     several threads while the hint is enabled.
+        */
+        void enableLocalityHint(bool flag = true) {
+            impl_->enableLocalityHint(flag);
+        }
         void update() {
             impl_->update();
         }
@@ -148,6 +267,24 @@ namespace QuantLib {
                        << impl_->xMin() << ", " << impl_->xMax()
                        << "]: extrapolation at " << x << " not allowed");
         }
+        // checks the range of all points and returns whether they
+        // are sorted, in which case only the first and last are checked
+        bool checkRange(const Real* xBegin, const Real* xEnd,
+                        bool extrapolate) const {
+            if (xBegin == xEnd)
+                return true;
+            const bool sorted =
+                std::adjacent_find(xBegin, xEnd,
+                                   std::greater<Real>()) == xEnd;
+            if (sorted) {
+                checkRange(*xBegin, extrapolate);
+                checkRange(*(xEnd-1), extrapolate);
+            } else {
+                for (const Real* x=xBegin; x!=xEnd; ++x)
+                    checkRange(*x, extrapolate);
+            }
+            return sorted;
+        }
     };
 
 }
@@ -6,6 +6,7 @@
 #include <ql/math/interpolations/convexmonotoneinterpolation.hpp>
 #include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/math/interpolations/extrapolation.hpp>
+#include <ql/math/interpolations/fixedsizeinterpolation.hpp>
 #include <ql/math/interpolations/flatextrapolation2d.hpp>
 #include <ql/math/interpolations/forwardflatinterpolation.hpp>
 #include <ql/math/interpolations/interpolation2d.hpp>
@@ -16,5 +17,7 @@
 #include <ql/math/interpolations/loginterpolation.hpp>
 #include <ql/math/interpolations/mixedinterpolation.hpp>
 #include <ql/math/interpolations/multicubicspline.hpp>
+#include <ql/math/interpolations/polynomialsurface.hpp>
 #include <ql/math/interpolations/sabrinterpolation.hpp>
+#include <ql/math/interpolations/tensorproductinterpolation.hpp>
 #include <ql/math/interpolations/xabrinterpolation.hpp>
\ No newline at end of file
@@ -100,7 +100,26 @@ namespace QuantLib {
             Real secondDerivative(Real) const {
                 return 0.0;
             }
+            void values(const Real* x, Size n, Real* result,
+                        bool sorted) const {
+                this->evaluateBySegment(
+                    this, &BackwardFlatInterpolationImpl::valueKernel,
+                    x, n, result, sorted);
+            }
+            void derivatives(const Real*, Size n, Real* result,
+                             bool) const {
+                std::fill(result, result+n, 0.0);
+            }
           private:
+            void valueKernel(Size i, const Real* x, Size n,
+                             Real* result) const {
+                const Real x0 = this->xBegin_[0], xi = this->xBegin_[i];
+                const Real y0 = this->yBegin_[0], yi = this->yBegin_[i],
+                           yNext = this->yBegin_[i+1];
+                for (Size k=0; k<n; ++k)
+                    result[k] = (x[k] <= x0) ? y0
+                              : ((x[k] == xi) ? yi : yNext);
+            }
             std::vector<Real> primitive_;
         };
 
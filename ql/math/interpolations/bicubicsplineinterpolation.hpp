@@ -27,6 +27,7 @@
 
 #include <ql/math/interpolations/interpolation2d.hpp>
 #include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/math/interpolations/polynomialsurface.hpp>
 
 namespace QuantLib {
 
@@ -56,26 +57,66 @@ namespace QuantLib {
                 calculate();
             }
             void calculate() {
+                const Size nx = this->xEnd_-this->xBegin_;
+                const Size ny = this->yEnd_-this->yBegin_;
+                surface_.reset(this->xBegin_, this->xEnd_,
+                               this->yBegin_, this->yEnd_, 4);
+                // rowCoefficients_[(k*4+m)*ny+i] is the coefficient of
+                // (x-x_k)^m in the spline of row i on the segment k
+                rowCoefficients_.resize((nx-1)*4*ny);
                 splines_.resize(this->zData_.rows());
-                for (Size i=0; i<(this->zData_.rows()); ++i)
-                    splines_[i] = CubicInterpolation(
+                for (Size i=0; i<(this->zData_.rows()); ++i) {
+                    CubicInterpolation spline(
                                 this->xBegin_, this->xEnd_,
                                 this->zData_.row_begin(i),
                                 CubicInterpolation::Spline, false,
                                 CubicInterpolation::SecondDerivative, 0.0,
                                 CubicInterpolation::SecondDerivative, 0.0);
-            }
-            Real value(Real x, Real y) const {
-                std::vector<Real> section(splines_.size());
-                for (Size i=0; i<splines_.size(); i++)
-                    section[i]=splines_[i](x,true);
+                    for (Size k=0; k<nx-1; ++k) {
+                        rowCoefficients_[(k*4)*ny+i] = this->zData_[i][k];
+                        rowCoefficients_[(k*4+1)*ny+i] =
+                            spline.aCoefficients()[k];
+                        rowCoefficients_[(k*4+2)*ny+i] =
+                            spline.bCoefficients()[k];
+                        rowCoefficients_[(k*4+3)*ny+i] =
+                            spline.cCoefficients()[k];
+                    }
+                    splines_[i] = spline;
+                }
 
+                // The section at x on the segment k is a linear
+                // combination of the row coefficients with weights
+                // (x-x_k)^m; since the spline in y is linear in the
+                // data, its coefficients are the same combination of
+                // the splines through each set of row coefficients.
+                section_.resize(ny);
                 CubicInterpolation spline(this->yBegin_, this->yEnd_,
-                                          section.begin(),
+                                          section_.begin(),
                                           CubicInterpolation::Spline, false,
                                           CubicInterpolation::SecondDerivative, 0.0,
                                           CubicInterpolation::SecondDerivative, 0.0);
-                return spline(y,true);
+                for (Size k=0; k<nx-1; ++k) {
+                    for (Size m=0; m<4; ++m) {
+                        std::copy(rowCoefficients_.begin()+(k*4+m)*ny,
+                                  rowCoefficients_.begin()+(k*4+m+1)*ny,
+                                  section_.begin());
+                        spline.update();
+                        for (Size j=0; j<ny-1; ++j) {
+                            Real* c = surface_.cell(k,j) + 4*m;
+                            c[0] = section_[j];
+                            c[1] = spline.aCoefficients()[j];
+                            c[2] = spline.bCoefficients()[j];
+                            c[3] = spline.cCoefficients()[j];
+                        }
+                    }
+                }
+            }
+            Real value(Real x, Real y) const {
+                return surface_.value(x, y);
+            }
+            void values(const Real* x, const Real* y, Size n,
+                        Real* result) const {
+                surface_.values(x, y, n, result);
             }
             
             Real derivativeX(Real x, Real y) const {
@@ -150,6 +191,8 @@ namespace QuantLib {
           
           private:
             std::vector<Interpolation> splines_;
+            PolynomialSurface surface_;
+            std::vector<Real> rowCoefficients_, section_;
         };
 
     }
@@ -26,6 +26,7 @@
 #define quantlib_bilinear_interpolation_hpp
 
 #include <ql/math/interpolations/interpolation2d.hpp>
+#include <ql/math/interpolations/polynomialsurface.hpp>
 
 namespace QuantLib {
 
@@ -43,28 +44,46 @@ namespace QuantLib {
                                                      zData) {
                 calculate();
             }
-            void calculate() {}
+            void calculate() {
+                // z = z1 + t(z2-z1) + u(z3-z1) + tu(z1-z2-z3+z4)
+                // with t = dx/hx and u = dy/hy
+                surface_.reset(this->xBegin_, this->xEnd_,
+                               this->yBegin_, this->yEnd_, 2);
+                const Size nx = this->xEnd_-this->xBegin_;
+                const Size ny = this->yEnd_-this->yBegin_;
+                for (Size j=0; j<ny-1; ++j) {
+                    const Real hy = this->yBegin_[j+1]-this->yBegin_[j];
+                    for (Size i=0; i<nx-1; ++i) {
+                        const Real hx = this->xBegin_[i+1]-this->xBegin_[i];
+                        Real z1 = this->zData_[j][i];
+                        Real z2 = this->zData_[j][i+1];
+                        Real z3 = this->zData_[j+1][i];
+                        Real z4 = this->zData_[j+1][i+1];
+                        Real* c = surface_.cell(i,j);
+                        c[0] = z1;
+                        c[1] = (z3-z1)/hy;
+                        c[2] = (z2-z1)/hx;
+                        c[3] = (z1-z2-z3+z4)/(hx*hy);
+                    }
+                }
+            }
             Real value(Real x, Real y) const {
-                Size i = this->locateX(x), j = this->locateY(y);
-
-                Real z1 = this->zData_[j][i];
-                Real z2 = this->zData_[j][i+1];
-                Real z3 = this->zData_[j+1][i];
-                Real z4 = this->zData_[j+1][i+1];
-
-                Real t=(x-this->xBegin_[i])/
-                    (this->xBegin_[i+1]-this->xBegin_[i]);
-                Real u=(y-this->yBegin_[j])/
-                    (this->yBegin_[j+1]-this->yBegin_[j]);
-
-                return (1.0-t)*(1.0-u)*z1 + t*(1.0-u)*z2
-                     + (1.0-t)*u*z3 + t*u*z4;
+                return surface_.value(x, y);
+            }
+            void values(const Real* x, const Real* y, Size n,
+                        Real* result) const {
+                surface_.values(x, y, n, result);
             }
+          private:
+            PolynomialSurface surface_;
         };
 
     }
 
     //! %bilinear interpolation between discrete points
+    /*! \warning the coefficients of each cell are precomputed;
+                 update() must be called after the z values change.
+    */
     class BilinearInterpolation : public Interpolation2D {
       public:
         /*! \pre the \f$ x \f$ and \f$ y \f$ values must be sorted. */
@@ -25,7 +25,10 @@
 #define quantlib_convex_monotone_interpolation_hpp
 
 #include <ql/math/interpolation.hpp>
+#include <boost/make_shared.hpp>
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace QuantLib {
 
@@ -159,12 +162,116 @@ namespace QuantLib {
 
     namespace detail {
 
+        /* One section of the convex-monotone interpolation, stored as
+           a type tag and the coefficients of the corresponding
+           polynomial pieces; the evaluation dispatches on the tag
+           instead of calling a virtual function. */
+        class ConvexMonotoneSection {
+          public:
+            enum Type {
+                EverywhereConstant,
+                ConstantGradient,
+                Quadratic,
+                QuadraticMin,
+                ConvexMonotone2,
+                ConvexMonotone3,
+                ConvexMonotone4,
+                ConvexMonotone4Min
+            };
+
+            static ConvexMonotoneSection everywhereConstant(
+                                Real value, Real prevPrimitive, Real xPrev);
+            static ConvexMonotoneSection constantGradient(
+                                Real fPrev, Real prevPrimitive,
+                                Real xPrev, Real xNext, Real fNext);
+            static ConvexMonotoneSection quadratic(
+                                Real xPrev, Real xNext,
+                                Real fPrev, Real fNext,
+                                Real fAverage, Real prevPrimitive);
+            static ConvexMonotoneSection quadraticMin(
+                                Real xPrev, Real xNext,
+                                Real fPrev, Real fNext,
+                                Real fAverage, Real prevPrimitive);
+            static ConvexMonotoneSection convexMonotone2(
+                                Real xPrev, Real xNext,
+                                Real gPrev, Real gNext,
+                                Real fAverage, Real eta2,
+                                Real prevPrimitive);
+            static ConvexMonotoneSection convexMonotone3(
+                                Real xPrev, Real xNext,
+                                Real gPrev, Real gNext,
+                                Real fAverage, Real eta3,
+                                Real prevPrimitive);
+            static ConvexMonotoneSection convexMonotone4(
+                                Real xPrev, Real xNext,
+                                Real gPrev, Real gNext,
+                                Real fAverage, Real eta4,
+                                Real prevPrimitive);
+            static ConvexMonotoneSection convexMonotone4Min(
+                                Real xPrev, Real xNext,
+                                Real gPrev, Real gNext,
+                                Real fAverage, Real eta4,
+                                Real prevPrimitive);
+
+            Type type() const { return type_; }
+            Real value(Real x) const;
+            Real primitive(Real x) const;
+            Real fNext() const { return fNext_; }
+          private:
+            explicit ConvexMonotoneSection(Type type);
+            Type type_;
+            // xPrev_ and xScaling_ map the section to [0,1]; the
+            // meaning of the other coefficients depends on the type
+            Real xPrev_, xScaling_, prevPrimitive_, fNext_;
+            Real gPrev_, gNext_, fAverage_, eta_, A_;
+            Real a_, b_, c_;
+            // regions of the sections avoiding negative values
+            bool splitRegion_;
+            Real xRatio_, x2_, x3_, xWidth_, primitive2_;
+        };
+
+        //! section of the convex-monotone interpolation
+        /*! This is either a single ConvexMonotoneSection or the
+            weighted combination of a quadratic and a convex-monotone
+            one, depending on the quadraticity.  Sections are copied
+            by value, so that the interpolation can keep them in a
+            contiguous array.
+        */
         class SectionHelper {
           public:
-            virtual ~SectionHelper() {}
-            virtual Real value(Real x) const = 0;
-            virtual Real primitive(Real x) const = 0;
-            virtual Real fNext() const = 0;
+            SectionHelper(const ConvexMonotoneSection& section)
+            : first_(section), second_(section),
+              quadraticity_(1.0), combined_(false) {}
+            SectionHelper(const ConvexMonotoneSection& quadraticHelper,
+                          const ConvexMonotoneSection& convMonoHelper,
+                          Real quadraticity)
+            : first_(quadraticHelper), second_(convMonoHelper),
+              quadraticity_(quadraticity), combined_(true) {
+                QL_REQUIRE(quadraticity < 1.0 && quadraticity > 0.0,
+                           "Quadratic value must lie between 0 and 1");
+            }
+            Real value(Real x) const {
+                if (!combined_)
+                    return first_.value(x);
+                return quadraticity_*first_.value(x)
+                    + (1.0-quadraticity_)*second_.value(x);
+            }
+            Real primitive(Real x) const {
+                if (!combined_)
+                    return first_.primitive(x);
+                return quadraticity_*first_.primitive(x)
+                    + (1.0-quadraticity_)*second_.primitive(x);
+            }
+            Real fNext() const {
+                if (!combined_)
+                    return first_.fNext();
+                return quadraticity_*first_.fNext()
+                    + (1.0-quadraticity_)*second_.fNext();
+            }
+          private:
+            ConvexMonotoneSection first_, second_;
+            Real quadraticity_;
+            bool combined_;
         };
 
         //the first value in the y-vector is ignored.
@@ -190,7 +297,8 @@ namespace QuantLib {
                                const helper_map& preExistingHelpers)
             : Interpolation::templateImpl<I1,I2>(xBegin,xEnd,yBegin,
                                                  ConvexMonotone::requiredPoints),
-              preSectionHelpers_(preExistingHelpers),
+              extrapolationHelper_(
+                  ConvexMonotoneSection::everywhereConstant(0.0, 0.0, 0.0)),
               forcePositive_(forcePositive),
               constantLastPeriod_(constantLastPeriod),
               quadraticity_(quadraticity), monotonicity_(monotonicity),
@@ -205,12 +313,20 @@ namespace QuantLib {
                            "monotone method as first point is ignored");
                 QL_REQUIRE((length_ - preExistingHelpers.size()) > 1,
                             "Too many existing helpers have been supplied");
+                for (typename helper_map::const_iterator i =
+                         preExistingHelpers.begin();
+                     i != preExistingHelpers.end(); ++i) {
+                    preSectionEnds_.push_back(i->first);
+                    preSections_.push_back(*(i->second));
+                }
             }
 
             void update();
 
             Real value(Real x) const;
             Real primitive(Real x) const;
+            void values(const Real* x, Size n, Real* result,
+                        bool sorted) const;
             Real derivative(Real) const {
                 QL_FAIL("Convex-monotone spline derivative not implemented");
             }
@@ -220,15 +336,32 @@ namespace QuantLib {
             }
 
             helper_map getExistingHelpers() {
-                helper_map retArray(sectionHelpers_);
+                helper_map retArray;
+                Size n = sections_.size();
                 if (constantLastPeriod_)
-                    retArray.erase(*(this->xEnd_-1));
+                    --n;
+                for (Size i=0; i<n; ++i)
+                    retArray[sectionEnds_[i]] =
+                        boost::make_shared<SectionHelper>(sections_[i]);
                 return retArray;
             }
           private:
-            helper_map sectionHelpers_;
-            helper_map preSectionHelpers_;
-            boost::shared_ptr<SectionHelper> extrapolationHelper_;
+            Size locateSection(Real x) const {
+                return std::upper_bound(sectionEnds_.begin(),
+                                        sectionEnds_.end(), x)
+                    - sectionEnds_.begin();
+            }
+            void addSection(Real xEnd, const SectionHelper& section) {
+                sectionEnds_.push_back(xEnd);
+                sections_.push_back(section);
+            }
+            // the sections are sorted by their right end, which is the
+            // first node greater than the points they apply to
+            std::vector<Real> sectionEnds_;
+            std::vector<SectionHelper> sections_;
+            std::vector<Real> preSectionEnds_;
+            std::vector<SectionHelper> preSections_;
+            SectionHelper extrapolationHelper_;
             bool forcePositive_, constantLastPeriod_;
             Real quadraticity_;
             Real monotonicity_;
@@ -236,384 +369,365 @@ namespace QuantLib {
         };
 
 
-        class ComboHelper : public SectionHelper {
-          public:
-            ComboHelper(boost::shared_ptr<SectionHelper>& quadraticHelper,
-                        boost::shared_ptr<SectionHelper>& convMonoHelper,
-                        Real quadraticity)
-            : quadraticity_(quadraticity),
-              quadraticHelper_(quadraticHelper),
-              convMonoHelper_(convMonoHelper) {
-                QL_REQUIRE(quadraticity < 1.0 && quadraticity > 0.0,
-                           "Quadratic value must lie between 0 and 1"); }
-
-            Real value(Real x) const {
-                return( quadraticity_*quadraticHelper_->value(x) + (1.0-quadraticity_)*convMonoHelper_->value(x) );
-            }
-            Real primitive(Real x) const {
-                return( quadraticity_*quadraticHelper_->primitive(x) + (1.0-quadraticity_)*convMonoHelper_->primitive(x) );
-            }
-            Real fNext() const {
-                return( quadraticity_*quadraticHelper_->fNext() + (1.0-quadraticity_)*convMonoHelper_->fNext() );
-            }
+        // inline definitions
 
-          private:
-            Real quadraticity_;
-            boost::shared_ptr<SectionHelper> quadraticHelper_;
-            boost::shared_ptr<SectionHelper> convMonoHelper_;
-        };
-
-        class EverywhereConstantHelper : public SectionHelper {
-          public:
-            EverywhereConstantHelper(Real value, Real prevPrimitive, Real xPrev)
-            : value_(value), prevPrimitive_(prevPrimitive), xPrev_(xPrev)
-            {}
-
-            Real value(Real) const {
-                return value_;
-            }
-            Real primitive(Real x) const {
-                return prevPrimitive_ + (x-xPrev_)*value_;
-            }
-            Real fNext() const {
-                return value_;
-            }
-          private:
-            Real value_;
-            Real prevPrimitive_;
-            Real xPrev_;
-        };
-
-        class ConvexMonotone2Helper : public SectionHelper {
-          public:
-            ConvexMonotone2Helper(Real xPrev, Real xNext,
-                                  Real gPrev, Real gNext,
-                                  Real fAverage, Real eta2,
-                                  Real prevPrimitive)
-            : xPrev_(xPrev), xScaling_(xNext-xPrev), gPrev_(gPrev),
-              gNext_(gNext), fAverage_(fAverage), eta2_(eta2),
-              prevPrimitive_(prevPrimitive)
-            {}
-
-            Real value(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (xVal <= eta2_) {
-                    return( fAverage_ + gPrev_ );
-                } else {
-                    return( fAverage_ + gPrev_ + (gNext_-gPrev_)/((1-eta2_)*(1-eta2_))*(xVal-eta2_)*(xVal-eta2_) );
-                }
-            }
-
-            Real primitive(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (xVal <= eta2_) {
-                    return( prevPrimitive_ + xScaling_*(fAverage_*xVal + gPrev_*xVal) );
-                } else {
-                    return( prevPrimitive_ + xScaling_*(fAverage_*xVal + gPrev_*xVal + (gNext_-gPrev_)/((1-eta2_)*(1-eta2_)) *
-                            (1.0/3.0*(xVal*xVal*xVal - eta2_*eta2_*eta2_) - eta2_*xVal*xVal + eta2_*eta2_*xVal) ) );
-                }
-            }
-            Real fNext() const {
-                return(fAverage_+gNext_);
-            }
-          private:
-            Real xPrev_, xScaling_, gPrev_, gNext_, fAverage_, eta2_, prevPrimitive_;
-        };
-
-        class ConvexMonotone3Helper : public SectionHelper {
-          public:
-            ConvexMonotone3Helper(Real xPrev, Real xNext,
-                                  Real gPrev, Real gNext,
-                                  Real fAverage, Real eta3,
-                                  Real prevPrimitive)
-              : xPrev_(xPrev), xScaling_(xNext-xPrev), gPrev_(gPrev),
-                gNext_(gNext), fAverage_(fAverage), eta3_(eta3), prevPrimitive_(prevPrimitive)
-            {}
-
-            Real value(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (xVal <= eta3_) {
-                    return( fAverage_ + gNext_ + (gPrev_-gNext_) / (eta3_*eta3_) * (eta3_-xVal)*(eta3_-xVal) );
-                } else {
-                    return( fAverage_ + gNext_ );
-                }
-            }
-
-            Real primitive(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (xVal <= eta3_) {
-                    return( prevPrimitive_ + xScaling_ * (fAverage_*xVal + gNext_*xVal + (gPrev_-gNext_)/(eta3_*eta3_) *
-                            (1.0/3.0 * xVal*xVal*xVal - eta3_*xVal*xVal + eta3_*eta3_*xVal) ) );
-                } else {
-                    return( prevPrimitive_ + xScaling_ * (fAverage_*xVal + gNext_*xVal + (gPrev_-gNext_)/(eta3_*eta3_) *
-                            (1.0/3.0 * eta3_*eta3_*eta3_)) );
-                }
-            }
-            Real fNext() const {
-                return(fAverage_+gNext_);
-            }
-          private:
-            Real xPrev_, xScaling_, gPrev_, gNext_, fAverage_, eta3_, prevPrimitive_;
-        };
-
-        class ConvexMonotone4Helper : public SectionHelper {
-          public:
-            ConvexMonotone4Helper(Real xPrev,  Real xNext,
-                                  Real gPrev, Real gNext,
-                                  Real fAverage, Real eta4,
-                                  Real prevPrimitive)
-            : xPrev_(xPrev), xScaling_(xNext-xPrev), gPrev_(gPrev),
-              gNext_(gNext), fAverage_(fAverage), eta4_(eta4), prevPrimitive_(prevPrimitive) {
-                A_ = -0.5*(eta4_*gPrev_ + (1-eta4_)*gNext_);
-            }
-
-            Real value(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (xVal <= eta4_) {
-                    return(fAverage_ + A_ + (gPrev_-A_)*(eta4_-xVal)*(eta4_-xVal)/(eta4_*eta4_) );
-                } else {
-                    return(fAverage_ + A_ + (gNext_-A_)*(xVal-eta4_)*(xVal-eta4_)/((1-eta4_)*(1-eta4_)) );
-                }
-            }
+        inline ConvexMonotoneSection::ConvexMonotoneSection(Type type)
+        : type_(type), xPrev_(0.0), xScaling_(1.0), prevPrimitive_(0.0),
+          fNext_(0.0), gPrev_(0.0), gNext_(0.0), fAverage_(0.0), eta_(0.0),
+          A_(0.0), a_(0.0), b_(0.0), c_(0.0), splitRegion_(false),
+          xRatio_(1.0), x2_(0.0), x3_(0.0), xWidth_(1.0), primitive2_(0.0) {}
 
-            Real primitive(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                Real retVal;
-                if (xVal <= eta4_) {
-                    retVal = prevPrimitive_ + xScaling_ * (fAverage_ + A_ + (gPrev_-A_)/(eta4_*eta4_) *
-                            (eta4_*eta4_ - eta4_*xVal + 1.0/3.0*xVal*xVal)) * xVal;
-                } else {
-                    retVal = prevPrimitive_ + xScaling_ *(fAverage_*xVal + A_*xVal + (gPrev_-A_)*(1.0/3.0*eta4_) +
-                             (gNext_-A_)/((1-eta4_)*(1-eta4_)) *
-                             (1.0/3.0*xVal*xVal*xVal - eta4_*xVal*xVal + eta4_*eta4_*xVal - 1.0/3.0*eta4_*eta4_*eta4_));
-                }
-                return retVal;
-            }
-            Real fNext() const {
-                return(fAverage_+gNext_);
-            }
-          protected:
-            Real xPrev_, xScaling_, gPrev_, gNext_, fAverage_, eta4_, prevPrimitive_;
-            Real A_;
-        };
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::everywhereConstant(Real value,
+                                                  Real prevPrimitive,
+                                                  Real xPrev) {
+            ConvexMonotoneSection s(EverywhereConstant);
+            s.fNext_ = value;
+            s.prevPrimitive_ = prevPrimitive;
+            s.xPrev_ = xPrev;
+            return s;
+        }
 
-        class ConvexMonotone4MinHelper : public ConvexMonotone4Helper {
-          public:
-            ConvexMonotone4MinHelper(Real xPrev,  Real xNext,
-                                  Real gPrev, Real gNext,
-                                  Real fAverage, Real eta4,
-                                  Real prevPrimitive)
-            : ConvexMonotone4Helper(xPrev, xNext, gPrev, gNext,
-                                    fAverage, eta4, prevPrimitive),
-              splitRegion_(false) {
-                if ( A_+ fAverage_ <= 0.0 ) {
-                    splitRegion_ = true;
-                    Real fPrev = gPrev_+fAverage_;
-                    Real fNext = gNext_+fAverage_;
-                    Real reqdShift = (eta4_*fPrev + (1-eta4_)*fNext)/3.0 - fAverage_;
-                    Real reqdPeriod = reqdShift * xScaling_ / (fAverage_+reqdShift);
-                    Real xAdjust = xScaling_ - reqdPeriod;
-                    xRatio_ =  xAdjust/xScaling_;
-
-                    fAverage_ += reqdShift;
-                    gNext_ = fNext - fAverage_;
-                    gPrev_ = fPrev - fAverage_;
-                    A_ = -(eta4_ * gPrev_ + (1.0-eta4)*gNext_)/2.0;
-                    x2_ = xPrev_ + xAdjust  * eta4_;
-                    x3_ = xPrev_ + xScaling_ - xAdjust*(1.0-eta4_);
-                }
-            }
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::constantGradient(Real fPrev,
+                                                Real prevPrimitive,
+                                                Real xPrev, Real xNext,
+                                                Real fNext) {
+            ConvexMonotoneSection s(ConstantGradient);
+            s.c_ = fPrev;
+            s.prevPrimitive_ = prevPrimitive;
+            s.xPrev_ = xPrev;
+            s.b_ = (fNext-fPrev)/(xNext-xPrev);
+            s.fNext_ = fNext;
+            return s;
+        }
 
-            Real value(Real x) const {
-                if (!splitRegion_)
-                    return ConvexMonotone4Helper::value(x);
-
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (x <= x2_) {
-                    xVal /= xRatio_;
-                    return(fAverage_ + A_ + (gPrev_-A_)*(eta4_-xVal)*(eta4_-xVal)/(eta4_*eta4_));
-                } else if (x < x3_) {
-                    return 0.0;
-                } else {
-                    xVal = 1.0 - (1.0 - xVal) / xRatio_;
-                    return(fAverage_ + A_ + (gNext_-A_)*(xVal-eta4_)*(xVal-eta4_)/((1-eta4_)*(1-eta4_)) );
-                }
-            }
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::quadratic(Real xPrev, Real xNext,
+                                         Real fPrev, Real fNext,
+                                         Real fAverage,
+                                         Real prevPrimitive) {
+            ConvexMonotoneSection s(Quadratic);
+            s.xPrev_ = xPrev;
+            s.fNext_ = fNext;
+            s.prevPrimitive_ = prevPrimitive;
+            s.a_ = 3*fPrev + 3*fNext - 6*fAverage;
+            s.b_ = -(4*fPrev + 2*fNext - 6*fAverage);
+            s.c_ = fPrev;
+            s.xScaling_ = xNext-xPrev;
+            return s;
+        }
 
-            Real primitive(Real x) const {
-                if (!splitRegion_)
-                    return ConvexMonotone4Helper::primitive(x);
-
-                Real xVal = (x-xPrev_)/xScaling_;
-                if (x <= x2_) {
-                    xVal /= xRatio_;
-                    return( prevPrimitive_ + xScaling_*xRatio_*(fAverage_ + A_ + (gPrev_-A_)/(eta4_*eta4_) *
-                            (eta4_*eta4_ - eta4_*xVal + 1.0/3.0*xVal*xVal)) * xVal );
-                } else if (x <= x3_) {
-                    return( prevPrimitive_ + xScaling_*xRatio_*(fAverage_*eta4_ + A_*eta4_ + (gPrev_-A_)/(eta4_*eta4_) *
-                            (1.0/3.0*eta4_*eta4_*eta4_)) );
-                } else {
-                    xVal = 1.0 - (1.0-xVal)/xRatio_;
-                    return( prevPrimitive_ + xScaling_*xRatio_*(fAverage_*xVal + A_*xVal + (gPrev_-A_)*(1.0/3.0*eta4_) +
-                            (gNext_-A_) / ((1.0-eta4_)*(1.0-eta4_)) *
-                            (1.0/3.0*xVal*xVal*xVal - eta4_*xVal*xVal + eta4_*eta4_*xVal - 1.0/3.0*eta4_*eta4_*eta4_)) );
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::quadraticMin(Real xPrev, Real xNext,
+                                            Real fPrev, Real fNext,
+                                            Real fAverage,
+                                            Real prevPrimitive) {
+            ConvexMonotoneSection s(QuadraticMin);
+            s.xPrev_ = xPrev;
+            s.xWidth_ = xNext-xPrev;
+            s.prevPrimitive_ = prevPrimitive;
+            s.fAverage_ = fAverage;
+            s.fNext_ = fNext;
+            s.a_ = 3*fPrev + 3*fNext - 6*fAverage;
+            s.b_ = -(4*fPrev + 2*fNext - 6*fAverage);
+            s.c_ = fPrev;
+            Real d = s.b_*s.b_-4*s.a_*s.c_;
+            s.xScaling_ = xNext-xPrev;
+            s.xRatio_ = 1.0;
+            if (d > 0) {
+                Real aAv = 36;
+                Real bAv = -24*(fPrev+fNext);
+                Real cAv = 4*(fPrev*fPrev + fPrev*fNext + fNext*fNext);
+                Real dAv = bAv*bAv - 4.0*aAv*cAv;
+                if (dAv >= 0.0) {
+                    s.splitRegion_ = true;
+                    Real avRoot = (-bAv - std::sqrt(dAv))/(2*aAv);
+
+                    s.xRatio_ = fAverage / avRoot;
+                    s.xScaling_ *= s.xRatio_;
+
+                    s.a_ = 3*fPrev + 3*fNext - 6*avRoot;
+                    s.b_ = -(4*fPrev + 2*fNext - 6*avRoot);
+                    s.c_ = fPrev;
+                    Real xRoot = -s.b_/(2*s.a_);
+                    s.x2_ = xPrev + s.xRatio_ * (xNext-xPrev) * xRoot;
+                    s.x3_ = xNext - s.xRatio_ * (xNext-xPrev) * (1-xRoot);
+                    s.primitive2_ = prevPrimitive
+                        + s.xScaling_*(s.a_/3*xRoot*xRoot
+                                       + s.b_/2*xRoot + s.c_)*xRoot;
                 }
             }
-          private:
-            bool splitRegion_;
-            Real xRatio_, x2_, x3_;
-        };
-
-        class ConstantGradHelper : public SectionHelper {
-          public:
-            ConstantGradHelper(Real fPrev, Real prevPrimitive,
-                               Real xPrev, Real xNext, Real fNext)
-            : fPrev_(fPrev), prevPrimitive_(prevPrimitive),
-            xPrev_(xPrev), fGrad_((fNext-fPrev)/(xNext-xPrev)),fNext_(fNext)
-            {}
+            return s;
+        }
 
-            Real value(Real x) const {
-                return (fPrev_ + (x-xPrev_)*fGrad_);
-            }
-            Real primitive(Real x) const {
-                return (prevPrimitive_+(x-xPrev_)*(fPrev_+0.5*(x-xPrev_)*fGrad_));
-            }
-            Real fNext()  const {
-                return fNext_;
-            }
-          private:
-            Real fPrev_, prevPrimitive_, xPrev_, fGrad_, fNext_;
-        };
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::convexMonotone2(Real xPrev, Real xNext,
+                                               Real gPrev, Real gNext,
+                                               Real fAverage, Real eta2,
+                                               Real prevPrimitive) {
+            ConvexMonotoneSection s(ConvexMonotone2);
+            s.xPrev_ = xPrev;
+            s.xScaling_ = xNext-xPrev;
+            s.gPrev_ = gPrev;
+            s.gNext_ = gNext;
+            s.fAverage_ = fAverage;
+            s.eta_ = eta2;
+            s.prevPrimitive_ = prevPrimitive;
+            s.fNext_ = fAverage+gNext;
+            return s;
+        }
 
-        class QuadraticHelper : public SectionHelper {
-          public:
-            QuadraticHelper(Real xPrev, Real xNext,
-                               Real fPrev, Real fNext,
-                               Real fAverage,
-                               Real prevPrimitive)
-            : xPrev_(xPrev), xNext_(xNext), fPrev_(fPrev),
-              fNext_(fNext), fAverage_(fAverage),
-              prevPrimitive_(prevPrimitive) {
-                a_ = 3*fPrev_ + 3*fNext_ - 6*fAverage_;
-                b_ = -(4*fPrev_ + 2*fNext_ - 6*fAverage_);
-                c_ = fPrev_;
-                xScaling_ = xNext_-xPrev_;
-            }
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::convexMonotone3(Real xPrev, Real xNext,
+                                               Real gPrev, Real gNext,
+                                               Real fAverage, Real eta3,
+                                               Real prevPrimitive) {
+            ConvexMonotoneSection s =
+                convexMonotone2(xPrev, xNext, gPrev, gNext,
+                                fAverage, eta3, prevPrimitive);
+            s.type_ = ConvexMonotone3;
+            return s;
+        }
 
-            Real value(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                return( a_*xVal*xVal + b_*xVal + c_ );
-            }
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::convexMonotone4(Real xPrev, Real xNext,
+                                               Real gPrev, Real gNext,
+                                               Real fAverage, Real eta4,
+                                               Real prevPrimitive) {
+            ConvexMonotoneSection s =
+                convexMonotone2(xPrev, xNext, gPrev, gNext,
+                                fAverage, eta4, prevPrimitive);
+            s.type_ = ConvexMonotone4;
+            s.A_ = -0.5*(eta4*gPrev + (1-eta4)*gNext);
+            return s;
+        }
 
-            Real primitive(Real x) const {
-                Real xVal = (x-xPrev_)/xScaling_;
-                return( prevPrimitive_ + xScaling_ * (a_/3*xVal*xVal + b_/2*xVal + c_) * xVal );
-            }
+        inline ConvexMonotoneSection
+        ConvexMonotoneSection::convexMonotone4Min(Real xPrev, Real xNext,
+                                                  Real gPrev, Real gNext,
+                                                  Real fAverage, Real eta4,
+                                                  Real prevPrimitive) {
+            ConvexMonotoneSection s =
+                convexMonotone4(xPrev, xNext, gPrev, gNext,
+                                fAverage, eta4, prevPrimitive);
+            s.type_ = ConvexMonotone4Min;
+            if (s.A_ + s.fAverage_ <= 0.0) {
+                s.splitRegion_ = true;
+                Real fPrev = s.gPrev_+s.fAverage_;
+                Real fNext = s.gNext_+s.fAverage_;
+                Real reqdShift =
+                    (eta4*fPrev + (1-eta4)*fNext)/3.0 - s.fAverage_;
+                Real reqdPeriod =
+                    reqdShift * s.xScaling_ / (s.fAverage_+reqdShift);
+                Real xAdjust = s.xScaling_ - reqdPeriod;
+                s.xRatio_ = xAdjust/s.xScaling_;
+
+                s.fAverage_ += reqdShift;
+                s.gNext_ = fNext - s.fAverage_;
+                s.gPrev_ = fPrev - s.fAverage_;
+                s.A_ = -(eta4 * s.gPrev_ + (1.0-eta4)*s.gNext_)/2.0;
+                s.x2_ = xPrev + xAdjust * eta4;
+                s.x3_ = xPrev + s.xScaling_ - xAdjust*(1.0-eta4);
+            }
+            s.fNext_ = s.fAverage_+s.gNext_;
+            return s;
+        }
 
-            Real fNext() const {
+        inline Real ConvexMonotoneSection::value(Real x) const {
+            switch (type_) {
+              case EverywhereConstant:
                 return fNext_;
-            }
-          private:
-            Real xPrev_, xNext_, fPrev_, fNext_, fAverage_, prevPrimitive_;
-            Real xScaling_, a_, b_, c_;
-        };
-
-        class QuadraticMinHelper : public SectionHelper {
-          public:
-            QuadraticMinHelper(Real xPrev, Real xNext,
-                               Real fPrev, Real fNext,
-                               Real fAverage,
-                               Real prevPrimitive)
-            : splitRegion_(false), x1_(xPrev), x4_(xNext),
-              primitive1_(prevPrimitive), fAverage_(fAverage),
-              fPrev_(fPrev), fNext_(fNext) {
-                a_ = 3*fPrev_ + 3*fNext_ - 6*fAverage_;
-                b_ = -(4*fPrev_ + 2*fNext_ - 6*fAverage_);
-                c_ = fPrev_;
-                Real d = b_*b_-4*a_*c_;
-                xScaling_ = x4_-x1_;
-                xRatio_ = 1.0;
-                if (d > 0) {
-                    Real aAv = 36;
-                    Real bAv = -24*(fPrev_+fNext_);
-                    Real cAv = 4*(fPrev_*fPrev_ + fPrev_*fNext_ + fNext_*fNext_);
-                    Real dAv = bAv*bAv - 4.0*aAv*cAv;
-                    if (dAv >= 0.0) {
-                        splitRegion_ = true;
-                        Real avRoot = (-bAv - std::sqrt(dAv))/(2*aAv);
-
-                        xRatio_ = fAverage_ / avRoot;
-                        xScaling_ *= xRatio_;
-
-                        a_ = 3*fPrev_ + 3*fNext_ - 6*avRoot;
-                        b_ = -(4*fPrev_ + 2*fNext_ - 6*avRoot);
-                        c_ = fPrev_;
-                        Real xRoot = -b_/(2*a_);
-                        x2_ = x1_ + xRatio_ * (x4_-x1_) * xRoot;
-                        x3_ = x4_ - xRatio_ * (x4_-x1_) * (1-xRoot);
-                        primitive2_ =
-                            primitive1_ + xScaling_*(a_/3*xRoot*xRoot + b_/2*xRoot + c_)*xRoot;
-                    }
-                }
-            }
-
-            Real value(Real x) const {
-                Real xVal = (x - x1_) / (x4_-x1_);
+              case ConstantGradient:
+                return c_ + (x-xPrev_)*b_;
+              case Quadratic: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  return a_*xVal*xVal + b_*xVal + c_;
+              }
+              case QuadraticMin: {
+                  Real xVal = (x-xPrev_)/xWidth_;
+                  if (splitRegion_) {
+                      if (x <= x2_) {
+                          xVal /= xRatio_;
+                      } else if (x < x3_) {
+                          return 0.0;
+                      } else {
+                          xVal = 1.0 - (1.0 - xVal) / xRatio_;
+                      }
+                  }
+                  return c_ + b_*xVal + a_*xVal*xVal;
+              }
+              case ConvexMonotone2: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  if (xVal <= eta_)
+                      return fAverage_ + gPrev_;
+                  return fAverage_ + gPrev_
+                      + (gNext_-gPrev_)/((1-eta_)*(1-eta_))
+                        *(xVal-eta_)*(xVal-eta_);
+              }
+              case ConvexMonotone3: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  if (xVal <= eta_)
+                      return fAverage_ + gNext_
+                          + (gPrev_-gNext_) / (eta_*eta_)
+                            * (eta_-xVal)*(eta_-xVal);
+                  return fAverage_ + gNext_;
+              }
+              case ConvexMonotone4Min:
                 if (splitRegion_) {
+                    Real xVal = (x-xPrev_)/xScaling_;
                     if (x <= x2_) {
                         xVal /= xRatio_;
+                        return fAverage_ + A_
+                            + (gPrev_-A_)*(eta_-xVal)*(eta_-xVal)
+                              /(eta_*eta_);
                     } else if (x < x3_) {
                         return 0.0;
                     } else {
                         xVal = 1.0 - (1.0 - xVal) / xRatio_;
+                        return fAverage_ + A_
+                            + (gNext_-A_)*(xVal-eta_)*(xVal-eta_)
+                              /((1-eta_)*(1-eta_));
                     }
                 }
-
-                return c_ + b_*xVal + a_*xVal*xVal;
+                // falls through - same as ConvexMonotone4 if not split
+              case ConvexMonotone4: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  if (xVal <= eta_)
+                      return fAverage_ + A_
+                          + (gPrev_-A_)*(eta_-xVal)*(eta_-xVal)/(eta_*eta_);
+                  return fAverage_ + A_
+                      + (gNext_-A_)*(xVal-eta_)*(xVal-eta_)
+                        /((1-eta_)*(1-eta_));
+              }
+              default:
+                QL_FAIL("unknown section type");
             }
+        }
 
-            Real primitive(Real x) const {
-                Real xVal = (x - x1_) / (x4_-x1_);
+        inline Real ConvexMonotoneSection::primitive(Real x) const {
+            switch (type_) {
+              case EverywhereConstant:
+                return prevPrimitive_ + (x-xPrev_)*fNext_;
+              case ConstantGradient:
+                return prevPrimitive_+(x-xPrev_)*(c_+0.5*(x-xPrev_)*b_);
+              case Quadratic: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  return prevPrimitive_
+                      + xScaling_ * (a_/3*xVal*xVal + b_/2*xVal + c_) * xVal;
+              }
+              case QuadraticMin: {
+                  Real xVal = (x-xPrev_)/xWidth_;
+                  if (splitRegion_) {
+                      if (x < x2_) {
+                          xVal /= xRatio_;
+                      } else if (x < x3_) {
+                          return primitive2_;
+                      } else {
+                          xVal = 1.0 - (1.0 - xVal) / xRatio_;
+                      }
+                  }
+                  return prevPrimitive_
+                      + xScaling_ * (a_/3*xVal*xVal+ b_/2*xVal+c_)*xVal;
+              }
+              case ConvexMonotone2: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  if (xVal <= eta_)
+                      return prevPrimitive_
+                          + xScaling_*(fAverage_*xVal + gPrev_*xVal);
+                  return prevPrimitive_
+                      + xScaling_*(fAverage_*xVal + gPrev_*xVal
+                                   + (gNext_-gPrev_)/((1-eta_)*(1-eta_))
+                                     * (1.0/3.0*(xVal*xVal*xVal
+                                                 - eta_*eta_*eta_)
+                                        - eta_*xVal*xVal
+                                        + eta_*eta_*xVal));
+              }
+              case ConvexMonotone3: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  if (xVal <= eta_)
+                      return prevPrimitive_
+                          + xScaling_ * (fAverage_*xVal + gNext_*xVal
+                                         + (gPrev_-gNext_)/(eta_*eta_)
+                                           * (1.0/3.0 * xVal*xVal*xVal
+                                              - eta_*xVal*xVal
+                                              + eta_*eta_*xVal));
+                  return prevPrimitive_
+                      + xScaling_ * (fAverage_*xVal + gNext_*xVal
+                                     + (gPrev_-gNext_)/(eta_*eta_)
+                                       * (1.0/3.0 * eta_*eta_*eta_));
+              }
+              case ConvexMonotone4Min:
                 if (splitRegion_) {
-                    if (x < x2_) {
+                    Real xVal = (x-xPrev_)/xScaling_;
+                    if (x <= x2_) {
                         xVal /= xRatio_;
-                    } else if (x < x3_) {
-                        return primitive2_;
+                        return prevPrimitive_
+                            + xScaling_*xRatio_
+                              *(fAverage_ + A_ + (gPrev_-A_)/(eta_*eta_)
+                                * (eta_*eta_ - eta_*xVal
+                                   + 1.0/3.0*xVal*xVal)) * xVal;
+                    } else if (x <= x3_) {
+                        return prevPrimitive_
+                            + xScaling_*xRatio_
+                              *(fAverage_*eta_ + A_*eta_
+                                + (gPrev_-A_)/(eta_*eta_)
+                                  * (1.0/3.0*eta_*eta_*eta_));
                     } else {
-                        xVal = 1.0 - (1.0 - xVal) / xRatio_;
+                        xVal = 1.0 - (1.0-xVal)/xRatio_;
+                        return prevPrimitive_
+                            + xScaling_*xRatio_
+                              *(fAverage_*xVal + A_*xVal
+                                + (gPrev_-A_)*(1.0/3.0*eta_)
+                                + (gNext_-A_) / ((1.0-eta_)*(1.0-eta_))
+                                  * (1.0/3.0*xVal*xVal*xVal
+                                     - eta_*xVal*xVal + eta_*eta_*xVal
+                                     - 1.0/3.0*eta_*eta_*eta_));
                     }
                 }
-                return primitive1_ + xScaling_ * (a_/3*xVal*xVal+ b_/2*xVal+c_)*xVal;
+                // falls through - same as ConvexMonotone4 if not split
+              case ConvexMonotone4: {
+                  Real xVal = (x-xPrev_)/xScaling_;
+                  if (xVal <= eta_)
+                      return prevPrimitive_
+                          + xScaling_ * (fAverage_ + A_
+                                         + (gPrev_-A_)/(eta_*eta_)
+                                           * (eta_*eta_ - eta_*xVal
+                                              + 1.0/3.0*xVal*xVal)) * xVal;
+                  return prevPrimitive_
+                      + xScaling_ *(fAverage_*xVal + A_*xVal
+                                    + (gPrev_-A_)*(1.0/3.0*eta_)
+                                    + (gNext_-A_)/((1-eta_)*(1-eta_))
+                                      * (1.0/3.0*xVal*xVal*xVal
+                                         - eta_*xVal*xVal + eta_*eta_*xVal
+                                         - 1.0/3.0*eta_*eta_*eta_));
+              }
+              default:
+                QL_FAIL("unknown section type");
             }
-
-            Real fNext() const {
-                return fNext_;
-            }
-
-          private:
-            bool splitRegion_;
-            Real x1_, x2_, x3_, x4_;
-            Real a_, b_, c_;
-            Real primitive1_, primitive2_;
-            Real fAverage_, fPrev_, fNext_, xScaling_, xRatio_;
-        };
+        }
 
         template <class I1, class I2>
         void ConvexMonotoneImpl<I1,I2>::update() {
-            sectionHelpers_.clear();
+            typedef ConvexMonotoneSection Section;
+            sectionEnds_.clear();
+            sections_.clear();
             if (length_ == 2) { //single period
-                boost::shared_ptr<SectionHelper> singleHelper(
-                              new EverywhereConstantHelper(this->yBegin_[1],
-                                                           0.0,
-                                                           this->xBegin_[0]));
-                sectionHelpers_[this->xBegin_[1]] = singleHelper;
+                SectionHelper singleHelper(
+                           Section::everywhereConstant(this->yBegin_[1],
+                                                       0.0,
+                                                       this->xBegin_[0]));
+                addSection(this->xBegin_[1], singleHelper);
                 extrapolationHelper_ = singleHelper;
                 return;
             }
 
             std::vector<Real> f(length_);
-            sectionHelpers_ = preSectionHelpers_;
-            Size startPoint = sectionHelpers_.size()+1;
+            sectionEnds_ = preSectionEnds_;
+            sections_ = preSections_;
+            sectionEnds_.reserve(length_-1);
+            sections_.reserve(length_-1);
+            Size startPoint = sections_.size()+1;
 
             //first derive the boundary forwards.
             for (Size i=startPoint; i<length_-1; ++i) {
@@ -624,7 +738,7 @@ namespace QuantLib {
             }
 
             if (startPoint > 1)
-                f[startPoint-1] = preSectionHelpers_.rbegin()->second->fNext();
+                f[startPoint-1] = preSections_.back().fNext();
             if (startPoint == 1)
                 f[0] = 1.5 * this->yBegin_[1] - 0.5 * f[1];
 
@@ -650,36 +764,32 @@ namespace QuantLib {
             for (Size i=startPoint; i< endPoint; ++i) {
                 Real gPrev = f[i-1] - this->yBegin_[i];
                 Real gNext = f[i] - this->yBegin_[i];
+                Real xPrev = this->xBegin_[i-1], xNext = this->xBegin_[i];
+                Real fAverage = this->yBegin_[i];
                 //first deal with the zero gradient case
                 if ( std::fabs(gPrev) < 1.0E-14
                      && std::fabs(gNext) < 1.0E-14 ) {
-                    boost::shared_ptr<SectionHelper> singleHelper(
-                                     new ConstantGradHelper(f[i-1], primitive,
-                                                            this->xBegin_[i-1],
-                                                            this->xBegin_[i],
-                                                            f[i]));
-                    sectionHelpers_[this->xBegin_[i]] = singleHelper;
+                    addSection(xNext,
+                               Section::constantGradient(f[i-1], primitive,
+                                                         xPrev, xNext,
+                                                         f[i]));
                 } else {
                     Real quadraticity = quadraticity_;
-                    boost::shared_ptr<SectionHelper> quadraticHelper;
-                    boost::shared_ptr<SectionHelper> convMonotoneHelper;
+                    // placeholders, overwritten by the sections in use
+                    Section quadraticHelper =
+                        Section::everywhereConstant(0.0, 0.0, 0.0);
+                    Section convMonotoneHelper = quadraticHelper;
                     if (quadraticity_ > 0.0) {
                         if (gPrev >= -2.0*gNext && gPrev > -0.5*gNext && forcePositive_) {
                             quadraticHelper =
-                                boost::shared_ptr<SectionHelper>(
-                                    new QuadraticMinHelper(this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           f[i-1], f[i],
-                                                           this->yBegin_[i],
-                                                           primitive) );
+                                Section::quadraticMin(xPrev, xNext,
+                                                      f[i-1], f[i],
+                                                      fAverage, primitive);
                         } else {
                             quadraticHelper =
-                                boost::shared_ptr<SectionHelper>(
-                                    new QuadraticHelper(this->xBegin_[i-1],
-                                                        this->xBegin_[i],
-                                                        f[i-1], f[i],
-                                                        this->yBegin_[i],
-                                                        primitive) );
+                                Section::quadratic(xPrev, xNext,
+                                                   f[i-1], f[i],
+                                                   fAverage, primitive);
                         }
                     }
                     if (quadraticity_ < 1.0) {
@@ -690,22 +800,16 @@ namespace QuantLib {
                             if (quadraticity_ == 0) {
                                 if (forcePositive_) {
                                     quadraticHelper =
-                                        boost::shared_ptr<SectionHelper>(
-                                            new QuadraticMinHelper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           f[i-1], f[i],
-                                                           this->yBegin_[i],
-                                                           primitive) );
+                                        Section::quadraticMin(xPrev, xNext,
+                                                              f[i-1], f[i],
+                                                              fAverage,
+                                                              primitive);
                                 } else {
                                     quadraticHelper =
-                                        boost::shared_ptr<SectionHelper>(
-                                            new QuadraticHelper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
+                                        Section::quadratic(xPrev, xNext,
                                                            f[i-1], f[i],
-                                                           this->yBegin_[i],
-                                                           primitive) );
+                                                           fAverage,
+                                                           primitive);
                                 }
                             }
                         }
@@ -716,32 +820,25 @@ namespace QuantLib {
                             Real b2 = (1.0 + monotonicity_)/2.0;
                             if (eta < b2) {
                                 convMonotoneHelper =
-                                    boost::shared_ptr<SectionHelper>(
-                                        new ConvexMonotone2Helper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           eta, primitive));
+                                    Section::convexMonotone2(xPrev, xNext,
+                                                             gPrev, gNext,
+                                                             fAverage,
+                                                             eta, primitive);
                             } else {
                                 if (forcePositive_) {
                                     convMonotoneHelper =
-                                        boost::shared_ptr<SectionHelper>(
-                                            new ConvexMonotone4MinHelper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           b2, primitive));
+                                        Section::convexMonotone4Min(
+                                                         xPrev, xNext,
+                                                         gPrev, gNext,
+                                                         fAverage,
+                                                         b2, primitive);
                                 } else {
                                     convMonotoneHelper =
-                                        boost::shared_ptr<SectionHelper>(
-                                            new ConvexMonotone4Helper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           b2, primitive));
+                                        Section::convexMonotone4(
+                                                         xPrev, xNext,
+                                                         gPrev, gNext,
+                                                         fAverage,
+                                                         b2, primitive);
                                 }
                             }
                         }
@@ -751,32 +848,25 @@ namespace QuantLib {
                             Real b3 = (1.0 - monotonicity_)/2.0;
                             if (eta > b3) {
                                 convMonotoneHelper =
-                                    boost::shared_ptr<SectionHelper>(
-                                        new ConvexMonotone3Helper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           eta, primitive));
+                                    Section::convexMonotone3(xPrev, xNext,
+                                                             gPrev, gNext,
+                                                             fAverage,
+                                                             eta, primitive);
                             } else {
                                 if (forcePositive_) {
                                     convMonotoneHelper =
-                                        boost::shared_ptr<SectionHelper>(
-                                            new ConvexMonotone4MinHelper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           b3, primitive));
+                                        Section::convexMonotone4Min(
+                                                         xPrev, xNext,
+                                                         gPrev, gNext,
+                                                         fAverage,
+                                                         b3, primitive);
                                 } else {
                                     convMonotoneHelper =
-                                        boost::shared_ptr<SectionHelper>(
-                                            new ConvexMonotone4Helper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           b3, primitive));
+                                        Section::convexMonotone4(
+                                                         xPrev, xNext,
+                                                         gPrev, gNext,
+                                                         fAverage,
+                                                         b3, primitive);
                                 }
                             }
                         } else {
@@ -789,36 +879,30 @@ namespace QuantLib {
                                 eta = b3;
                             if (forcePositive_) {
                                 convMonotoneHelper =
-                                    boost::shared_ptr<SectionHelper>(
-                                        new ConvexMonotone4MinHelper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           eta, primitive));
+                                    Section::convexMonotone4Min(
+                                                         xPrev, xNext,
+                                                         gPrev, gNext,
+                                                         fAverage,
+                                                         eta, primitive);
                             } else {
                                 convMonotoneHelper =
-                                    boost::shared_ptr<SectionHelper>(
-                                        new ConvexMonotone4Helper(
-                                                           this->xBegin_[i-1],
-                                                           this->xBegin_[i],
-                                                           gPrev, gNext,
-                                                           this->yBegin_[i],
-                                                           eta, primitive));
+                                    Section::convexMonotone4(
+                                                         xPrev, xNext,
+                                                         gPrev, gNext,
+                                                         fAverage,
+                                                         eta, primitive);
                             }
                         }
                     }
 
                     if (quadraticity == 1.0) {
-                        sectionHelpers_[this->xBegin_[i]] = quadraticHelper;
+                        addSection(xNext, quadraticHelper);
                     } else if (quadraticity == 0.0) {
-                        sectionHelpers_[this->xBegin_[i]] = convMonotoneHelper;
+                        addSection(xNext, convMonotoneHelper);
                     } else {
-                        sectionHelpers_[this->xBegin_[i]] =
-                            boost::shared_ptr<SectionHelper>(
-                                           new ComboHelper(quadraticHelper,
-                                                           convMonotoneHelper,
-                                                           quadraticity));
+                        addSection(xNext, SectionHelper(quadraticHelper,
+                                                        convMonotoneHelper,
+                                                        quadraticity));
                     }
 
                 }
@@ -827,38 +911,60 @@ namespace QuantLib {
             }
 
             if (constantLastPeriod_) {
-                sectionHelpers_[this->xBegin_[length_-1]] =
-                    boost::shared_ptr<SectionHelper>(
-                        new EverywhereConstantHelper(this->yBegin_[length_-1],
-                                                     primitive,
-                                                     this->xBegin_[length_-2]));
-                extrapolationHelper_ = sectionHelpers_[this->xBegin_[length_-1]];
+                addSection(this->xBegin_[length_-1],
+                           Section::everywhereConstant(
+                                                this->yBegin_[length_-1],
+                                                primitive,
+                                                this->xBegin_[length_-2]));
+                extrapolationHelper_ = sections_.back();
             } else {
-                extrapolationHelper_ =
-                    boost::shared_ptr<SectionHelper>(
-                        new EverywhereConstantHelper(
-                                (sectionHelpers_.rbegin())->second->value(*(this->xEnd_-1)),
+                extrapolationHelper_ = Section::everywhereConstant(
+                                sections_.back().value(*(this->xEnd_-1)),
                                 primitive,
-                                *(this->xEnd_-1)));
+                                *(this->xEnd_-1));
             }
         }
 
         template <class I1, class I2>
         Real ConvexMonotoneImpl<I1,I2>::value(Real x) const {
             if (x >= *(this->xEnd_-1)) {
-                return extrapolationHelper_->value(x);
+                return extrapolationHelper_.value(x);
+            }
+
+            return sections_[locateSection(x)].value(x);
+        }
+
+        template <class I1, class I2>
+        void ConvexMonotoneImpl<I1,I2>::values(const Real* x, Size n,
+                                               Real* result,
+                                               bool sorted) const {
+            if (!sorted) {
+                for (Size k=0; k<n; ++k)
+                    result[k] = value(x[k]);
+                return;
             }
 
-            return sectionHelpers_.upper_bound(x)->second->value(x);
+            // sorted points: sweep the sections instead of searching
+            const Real xMax = *(this->xEnd_-1);
+            Size section = 0;
+            for (Size k=0; k<n; ++k) {
+                if (x[k] >= xMax) {
+                    result[k] = extrapolationHelper_.value(x[k]);
+                } else {
+                    while (sectionEnds_[section] <= x[k])
+                        ++section;
+                    result[k] = sections_[section].value(x[k]);
+                }
+            }
         }
 
         template <class I1, class I2>
         Real ConvexMonotoneImpl<I1,I2>::primitive(Real x) const {
             if (x >= *(this->xEnd_-1)) {
-                return extrapolationHelper_->primitive(x);
+                return extrapolationHelper_.primitive(x);
             }
 
-            return sectionHelpers_.upper_bound(x)->second->primitive(x);
+            return sections_[locateSection(x)].primitive(x);
         }
 
     }
@@ -93,6 +93,17 @@ namespace QuantLib {
         Quintic Hermite Interpolation"
         Mathematics Of Computation, v. 52, n. 186, April 1989, pp. 471-494.
 
+        For the Spline scheme without the Hyman filter, update()
+        recognizes a change in a single \f$ y \f$ value since the previous
+        update and corrects the derivatives by the response of the spline
+        to that node, which is computed once and stored, instead of
+        solving the whole system again.  Up to \f$ n \f$ responses of
+        \f$ n \f$ values each are stored, i.e., the memory used grows
+        as \f$ O(n^2) \f$ for \f$ n \f$ nodes as more nodes are moved.
+        To bound the rounding errors that accumulate in the
+        corrections, the system is solved again after a fixed number
+        of incremental updates.
+
         \todo implement missing schemes (FourthOrder and ModifiedParabolic) and
               missing boundary conditions (Periodic and Lagrange).
 
@@ -378,7 +389,8 @@ namespace QuantLib {
               leftType_(leftCondition), rightType_(rightCondition),
               leftValue_(leftConditionValue),
               rightValue_(rightConditionValue),
-              tmp_(n_), dx_(n_-1), S_(n_-1), L_(n_) {
+              tmp_(n_), dx_(n_-1), S_(n_-1), L_(n_),
+              incrementalUpdates_(0) {
                 if (leftType_ == CubicInterpolation::Lagrange
                     || rightType_ == CubicInterpolation::Lagrange) {
                     QL_REQUIRE((xEnd-xBegin) >= 4,
@@ -396,77 +408,15 @@ namespace QuantLib {
 
                 // first derivative approximation
                 if (da_==CubicInterpolation::Spline) {
-                    for (Size i=1; i<n_-1; ++i) {
-                        L_.setMidRow(i, dx_[i], 2.0*(dx_[i]+dx_[i-1]), dx_[i-1]);
-                        tmp_[i] = 3.0*(dx_[i]*S_[i-1] + dx_[i-1]*S_[i]);
-                    }
-
-                    // left boundary condition
-                    switch (leftType_) {
-                      case CubicInterpolation::NotAKnot:
-                        // ignoring end condition value
-                        L_.setFirstRow(dx_[1]*(dx_[1]+dx_[0]),
-                                      (dx_[0]+dx_[1])*(dx_[0]+dx_[1]));
-                        tmp_[0] = S_[0]*dx_[1]*(2.0*dx_[1]+3.0*dx_[0]) +
-                                 S_[1]*dx_[0]*dx_[0];
-                        break;
-                      case CubicInterpolation::FirstDerivative:
-                        L_.setFirstRow(1.0, 0.0);
-                        tmp_[0] = leftValue_;
-                        break;
-                      case CubicInterpolation::SecondDerivative:
-                        L_.setFirstRow(2.0, 1.0);
-                        tmp_[0] = 3.0*S_[0] - leftValue_*dx_[0]/2.0;
-                        break;
-                      case CubicInterpolation::Periodic:
-                        QL_FAIL("this end condition is not implemented yet");
-                      case CubicInterpolation::Lagrange:
-                        L_.setFirstRow(1.0, 0.0);
-                        tmp_[0] = cubicInterpolatingPolynomialDerivative(
-                                            this->xBegin_[0],this->xBegin_[1],
-                                            this->xBegin_[2],this->xBegin_[3],
-                                            this->yBegin_[0],this->yBegin_[1],
-                                            this->yBegin_[2],this->yBegin_[3],
-                                            this->xBegin_[0]);
-                        break;
-                      default:
-                        QL_FAIL("unknown end condition");
+                    if (monotonic_ || !updateSplineIncrementally()) {
+                        setSplineOperator();
+                        splineRightHandSide(this->yBegin_, S_,
+                                            leftValue_, rightValue_, tmp_);
+                        // solve the system
+                        L_.solveFor(tmp_, tmp_);
+                        if (!monotonic_)
+                            cacheSplineNodes();
                     }
-
-                    // right boundary condition
-                    switch (rightType_) {
-                      case CubicInterpolation::NotAKnot:
-                        // ignoring end condition value
-                        L_.setLastRow(-(dx_[n_-2]+dx_[n_-3])*(dx_[n_-2]+dx_[n_-3]),
-                                     -dx_[n_-3]*(dx_[n_-3]+dx_[n_-2]));
-                        tmp_[n_-1] = -S_[n_-3]*dx_[n_-2]*dx_[n_-2] -
-                                     S_[n_-2]*dx_[n_-3]*(3.0*dx_[n_-2]+2.0*dx_[n_-3]);
-                        break;
-                      case CubicInterpolation::FirstDerivative:
-                        L_.setLastRow(0.0, 1.0);
-                        tmp_[n_-1] = rightValue_;
-                        break;
-                      case CubicInterpolation::SecondDerivative:
-                        L_.setLastRow(1.0, 2.0);
-                        tmp_[n_-1] = 3.0*S_[n_-2] + rightValue_*dx_[n_-2]/2.0;
-                        break;
-                      case CubicInterpolation::Periodic:
-                        QL_FAIL("this end condition is not implemented yet");
-                      case CubicInterpolation::Lagrange:
-                        L_.setLastRow(0.0,1.0);
-                        tmp_[n_-1] = cubicInterpolatingPolynomialDerivative(
-                                      this->xBegin_[n_-4],this->xBegin_[n_-3],
-                                      this->xBegin_[n_-2],this->xBegin_[n_-1],
-                                      this->yBegin_[n_-4],this->yBegin_[n_-3],
-                                      this->yBegin_[n_-2],this->yBegin_[n_-1],
-                                      this->xBegin_[n_-1]);
-                        break;
-                      default:
-                        QL_FAIL("unknown end condition");
-                    }
-
-                    // solve the system
-                    L_.solveFor(tmp_, tmp_);
                 } else if (da_==CubicInterpolation::SplineOM1) {
                     Matrix T_(n_-2, n_, 0.0);
                     for (Size i=0; i<n_-2; ++i) {
@@ -766,7 +716,203 @@ namespace QuantLib {
                 Real dx_ = x-this->xBegin_[j];
                 return 2.0*b_[j] + 6.0*c_[j]*dx_;
             }
+            void values(const Real* x, Size n, Real* result,
+                        bool sorted) const {
+                this->evaluateBySegment(
+                    this, &CubicInterpolationImpl::valueKernel,
+                    x, n, result, sorted);
+            }
+            void derivatives(const Real* x, Size n, Real* result,
+                             bool sorted) const {
+                this->evaluateBySegment(
+                    this, &CubicInterpolationImpl::derivativeKernel,
+                    x, n, result, sorted);
+            }
           private:
+            void valueKernel(Size j, const Real* x, Size n,
+                             Real* result) const {
+                const Real x0 = this->xBegin_[j], y0 = this->yBegin_[j];
+                const Real a = a_[j], b = b_[j], c = c_[j];
+                for (Size k=0; k<n; ++k) {
+                    const Real dx_ = x[k]-x0;
+                    result[k] = y0 + dx_*(a + dx_*(b + dx_*c));
+                }
+            }
+            void derivativeKernel(Size j, const Real* x, Size n,
+                                  Real* result) const {
+                const Real x0 = this->xBegin_[j];
+                const Real a = a_[j], b = b_[j], c = c_[j];
+                for (Size k=0; k<n; ++k) {
+                    const Real dx_ = x[k]-x0;
+                    result[k] = a + (2.0*b + 3.0*c*dx_)*dx_;
+                }
+            }
+            void setSplineOperator() {
+                for (Size i=1; i<n_-1; ++i)
+                    L_.setMidRow(i, dx_[i], 2.0*(dx_[i]+dx_[i-1]), dx_[i-1]);
+
+                // left boundary condition
+                switch (leftType_) {
+                  case CubicInterpolation::NotAKnot:
+                    L_.setFirstRow(dx_[1]*(dx_[1]+dx_[0]),
+                                   (dx_[0]+dx_[1])*(dx_[0]+dx_[1]));
+                    break;
+                  case CubicInterpolation::FirstDerivative:
+                  case CubicInterpolation::Lagrange:
+                    L_.setFirstRow(1.0, 0.0);
+                    break;
+                  case CubicInterpolation::SecondDerivative:
+                    L_.setFirstRow(2.0, 1.0);
+                    break;
+                  case CubicInterpolation::Periodic:
+                    QL_FAIL("this end condition is not implemented yet");
+                  default:
+                    QL_FAIL("unknown end condition");
+                }
+
+                // right boundary condition
+                switch (rightType_) {
+                  case CubicInterpolation::NotAKnot:
+                    L_.setLastRow(-(dx_[n_-2]+dx_[n_-3])*(dx_[n_-2]+dx_[n_-3]),
+                                  -dx_[n_-3]*(dx_[n_-3]+dx_[n_-2]));
+                    break;
+                  case CubicInterpolation::FirstDerivative:
+                  case CubicInterpolation::Lagrange:
+                    L_.setLastRow(0.0, 1.0);
+                    break;
+                  case CubicInterpolation::SecondDerivative:
+                    L_.setLastRow(1.0, 2.0);
+                    break;
+                  case CubicInterpolation::Periodic:
+                    QL_FAIL("this end condition is not implemented yet");
+                  default:
+                    QL_FAIL("unknown end condition");
+                }
+            }
+            /*! right-hand side of the spline system for the values y
+                and the slopes S between them; it is linear in
+                (y, S, leftValue, rightValue).
+            */
+            template <class I>
+            void splineRightHandSide(const I& y,
+                                     const std::vector<Real>& S,
+                                     Real leftValue, Real rightValue,
+                                     Array& rhs) const {
+                for (Size i=1; i<n_-1; ++i)
+                    rhs[i] = 3.0*(dx_[i]*S[i-1] + dx_[i-1]*S[i]);
+
+                // left boundary condition
+                switch (leftType_) {
+                  case CubicInterpolation::NotAKnot:
+                    // ignoring end condition value
+                    rhs[0] = S[0]*dx_[1]*(2.0*dx_[1]+3.0*dx_[0]) +
+                             S[1]*dx_[0]*dx_[0];
+                    break;
+                  case CubicInterpolation::FirstDerivative:
+                    rhs[0] = leftValue;
+                    break;
+                  case CubicInterpolation::SecondDerivative:
+                    rhs[0] = 3.0*S[0] - leftValue*dx_[0]/2.0;
+                    break;
+                  case CubicInterpolation::Lagrange:
+                    rhs[0] = cubicInterpolatingPolynomialDerivative(
+                                        this->xBegin_[0],this->xBegin_[1],
+                                        this->xBegin_[2],this->xBegin_[3],
+                                        y[0],y[1],y[2],y[3],
+                                        this->xBegin_[0]);
+                    break;
+                  default:
+                    QL_FAIL("unknown end condition");
+                }
+
+                // right boundary condition
+                switch (rightType_) {
+                  case CubicInterpolation::NotAKnot:
+                    // ignoring end condition value
+                    rhs[n_-1] = -S[n_-3]*dx_[n_-2]*dx_[n_-2] -
+                                S[n_-2]*dx_[n_-3]*(3.0*dx_[n_-2]+2.0*dx_[n_-3]);
+                    break;
+                  case CubicInterpolation::FirstDerivative:
+                    rhs[n_-1] = rightValue;
+                    break;
+                  case CubicInterpolation::SecondDerivative:
+                    rhs[n_-1] = 3.0*S[n_-2] + rightValue*dx_[n_-2]/2.0;
+                    break;
+                  case CubicInterpolation::Lagrange:
+                    rhs[n_-1] = cubicInterpolatingPolynomialDerivative(
+                                  this->xBegin_[n_-4],this->xBegin_[n_-3],
+                                  this->xBegin_[n_-2],this->xBegin_[n_-1],
+                                  y[n_-4],y[n_-3],y[n_-2],y[n_-1],
+                                  this->xBegin_[n_-1]);
+                    break;
+                  default:
+                    QL_FAIL("unknown end condition");
+                }
+            }
+            void cacheSplineNodes() {
+                bool sameNodes = (xNodes_.size() == n_);
+                for (Size i=0; i<n_ && sameNodes; ++i)
+                    sameNodes = (xNodes_[i] == this->xBegin_[i]);
+                if (!sameNodes) {
+                    xNodes_.assign(this->xBegin_, this->xEnd_);
+                    // the responses only depend on the x values
+                    responses_.assign(n_, Array());
+                    factorization_ = TridiagonalFactorization();
+                }
+                yNodes_.resize(n_);
+                std::copy(this->yBegin_, this->yBegin_+n_, yNodes_.begin());
+                incrementalUpdates_ = 0;
+            }
+            /*! The spline derivatives are linear in the y values, so
+                that a change in a single y[i] moves them along the
+                response to a unit change in y[i].  The response is
+                computed once per node with the cached factorization
+                of the system and stored; the correction is then O(n).
+                Returns false, leaving tmp_ unchanged, if anything but
+                a single y value changed since the last update, or if
+                the derivatives are due for a full rebuild.
+            */
+            bool updateSplineIncrementally() {
+                if (xNodes_.size() != n_)
+                    return false;
+                Size changed = n_;
+                for (Size i=0; i<n_; ++i) {
+                    if (xNodes_[i] != this->xBegin_[i])
+                        return false;
+                    if (yNodes_[i] != this->yBegin_[i]) {
+                        if (changed != n_)
+                            return false;
+                        changed = i;
+                    }
+                }
+                if (changed == n_)
+                    return true;
+                if (incrementalUpdates_ >= maxIncrementalUpdates)
+                    return false;
+
+                Array& response = responses_[changed];
+                if (response.empty()) {
+                    if (factorization_.size() != n_)
+                        factorization_ = TridiagonalFactorization(L_);
+                    std::vector<Real> unit(n_, 0.0), unitSlopes(n_-1, 0.0);
+                    unit[changed] = 1.0;
+                    if (changed > 0)
+                        unitSlopes[changed-1] = 1.0/dx_[changed-1];
+                    if (changed < n_-1)
+                        unitSlopes[changed] = -1.0/dx_[changed];
+                    response = Array(n_);
+                    splineRightHandSide(unit.begin(), unitSlopes,
+                                        0.0, 0.0, response);
+                    factorization_.solveFor(response, response);
+                }
+
+                const Real shift = this->yBegin_[changed] - yNodes_[changed];
+                for (Size i=0; i<n_; ++i)
+                    tmp_[i] += shift*response[i];
+                yNodes_[changed] = this->yBegin_[changed];
+                ++incrementalUpdates_;
+                return true;
+            }
             CubicInterpolation::DerivativeApprox da_;
             bool monotonic_;
             CubicInterpolation::BoundaryCondition leftType_, rightType_;
@@ -774,6 +920,15 @@ namespace QuantLib {
             mutable Array tmp_;
             mutable std::vector<Real> dx_, S_;
             mutable TridiagonalOperator L_;
+            // nodes of the last spline update and the responses of
+            // the derivatives to a unit change in each y value
+            std::vector<Real> xNodes_, yNodes_;
+            std::vector<Array> responses_;
+            TridiagonalFactorization factorization_;
+            // incremental updates since the last full rebuild, which
+            // is forced after maxIncrementalUpdates of them
+            static const Size maxIncrementalUpdates = 32;
+            Size incrementalUpdates_;
 
             inline Real cubicInterpolatingPolynomialDerivative(
                                Real a, Real b, Real c, Real d,
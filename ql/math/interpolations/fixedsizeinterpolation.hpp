@@ -0,0 +1,288 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fixedsizeinterpolation.hpp
+    \brief interpolations on a number of nodes fixed at compile time
+*/
+
+#ifndef quantlib_fixed_size_interpolation_hpp
+#define quantlib_fixed_size_interpolation_hpp
+
+#include <ql/math/interpolations/extrapolation.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/errors.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace QuantLib {
+
+    class Linear;
+    class LogLinear;
+    class CubicNaturalSpline;
+
+    namespace detail {
+
+        /* number of the nodes x[1], ..., x[K] not greater than v; the
+           recursion is resolved at compile time, so that the search
+           is fully unrolled and free of branches */
+        template <Size K>
+        struct FixedSizeLocator {
+            static Size count(const Real* x, Real v) {
+                return FixedSizeLocator<K-1>::count(x, v)
+                    + (v >= x[K] ? 1 : 0);
+            }
+        };
+
+        template <>
+        struct FixedSizeLocator<0> {
+            static Size count(const Real*, Real) { return 0; }
+        };
+
+        template <Size N>
+        class FixedSizeInterpolationBase : public Extrapolator {
+            // fails to compile for less than two nodes
+            typedef char at_least_two_nodes_required[N >= 2 ? 1 : -1];
+          public:
+            Real xMin() const { return x_[0]; }
+            Real xMax() const { return x_[N-1]; }
+            bool isInRange(Real x) const {
+                return (x >= x_[0] && x <= x_[N-1])
+                    || close(x, x_[0]) || close(x, x_[N-1]);
+            }
+          protected:
+            template <class I1, class I2>
+            void setNodes(const I1& xBegin, const I1& xEnd,
+                          const I2& yBegin) {
+                QL_REQUIRE(static_cast<Size>(xEnd-xBegin) == N,
+                           N << " points required, "
+                           << static_cast<Size>(xEnd-xBegin)
+                           << " provided");
+                std::copy(xBegin, xEnd, x_);
+                std::copy(yBegin, yBegin+N, y_);
+                for (Size i=1; i<N; ++i)
+                    QL_REQUIRE(x_[i] > x_[i-1], "unsorted x values");
+            }
+            void checkRange(Real x, bool extrapolate) const {
+                QL_REQUIRE(extrapolate || allowsExtrapolation()
+                           || isInRange(x),
+                           "interpolation range is ["
+                           << xMin() << ", " << xMax()
+                           << "]: extrapolation at " << x
+                           << " not allowed");
+            }
+            // same segment as Interpolation::templateImpl::locate
+            Size locate(Real x) const {
+                return FixedSizeLocator<N-2>::count(x_, x);
+            }
+            Real x_[N], y_[N];
+        };
+
+    }
+
+    //! interpolation on a number of nodes fixed at compile time
+    /*! The nodes and values are stored inside the object rather than
+        referenced through iterators, and the evaluation involves
+        neither virtual calls nor run-time sized loops; this allows
+        the compiler to inline it completely in the calling code.
+        The segment lookup is unrolled for the given number of nodes,
+        which makes it suitable for small grids (up to a few tens of
+        nodes) only.
+
+        The Method can be Linear, LogLinear or CubicNaturalSpline;
+        the results are the same as those of LinearInterpolation,
+        LogLinearInterpolation and CubicNaturalSpline on the same
+        nodes, including their extrapolation.
+
+        \test the results are checked against the corresponding
+              Interpolation classes.
+
+        \ingroup interpolations
+    */
+    template <Size N, class Method>
+    class FixedSizeInterpolation;
+
+    //! fixed-size linear interpolation
+    /*! \ingroup interpolations */
+    template <Size N>
+    class FixedSizeInterpolation<N, Linear>
+        : public detail::FixedSizeInterpolationBase<N> {
+      public:
+        /*! \pre the \f$ x \f$ values must be sorted. */
+        template <class I1, class I2>
+        FixedSizeInterpolation(const I1& xBegin, const I1& xEnd,
+                               const I2& yBegin) {
+            this->setNodes(xBegin, xEnd, yBegin);
+            calculate();
+        }
+        //! sets new values at the nodes
+        template <class I>
+        void update(const I& yBegin) {
+            std::copy(yBegin, yBegin+N, this->y_);
+            calculate();
+        }
+        Real operator()(Real x, bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            return this->y_[i] + (x-this->x_[i])*s_[i];
+        }
+        Real derivative(Real x, bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            return s_[this->locate(x)];
+        }
+        Real secondDerivative(Real x,
+                              bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            return 0.0;
+        }
+      private:
+        void calculate() {
+            for (Size i=0; i<N-1; ++i)
+                s_[i] = (this->y_[i+1]-this->y_[i])
+                       /(this->x_[i+1]-this->x_[i]);
+        }
+        Real s_[N-1];
+    };
+
+    //! fixed-size log-linear interpolation
+    /*! \ingroup interpolations */
+    template <Size N>
+    class FixedSizeInterpolation<N, LogLinear>
+        : public detail::FixedSizeInterpolationBase<N> {
+      public:
+        /*! \pre the \f$ x \f$ values must be sorted and the
+                 \f$ y \f$ values positive.
+        */
+        template <class I1, class I2>
+        FixedSizeInterpolation(const I1& xBegin, const I1& xEnd,
+                               const I2& yBegin) {
+            this->setNodes(xBegin, xEnd, yBegin);
+            calculate();
+        }
+        //! sets new values at the nodes
+        template <class I>
+        void update(const I& yBegin) {
+            std::copy(yBegin, yBegin+N, this->y_);
+            calculate();
+        }
+        Real operator()(Real x, bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            return std::exp(logY_[i] + (x-this->x_[i])*s_[i]);
+        }
+        Real derivative(Real x, bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            return std::exp(logY_[i] + (x-this->x_[i])*s_[i]) * s_[i];
+        }
+        Real secondDerivative(Real x,
+                              bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            return std::exp(logY_[i] + (x-this->x_[i])*s_[i])
+                * s_[i] * s_[i];
+        }
+      private:
+        void calculate() {
+            for (Size i=0; i<N; ++i) {
+                QL_REQUIRE(this->y_[i] > 0.0,
+                           "invalid value (" << this->y_[i]
+                           << ") at index " << i);
+                logY_[i] = std::log(this->y_[i]);
+            }
+            for (Size i=0; i<N-1; ++i)
+                s_[i] = (logY_[i+1]-logY_[i])/(this->x_[i+1]-this->x_[i]);
+        }
+        Real logY_[N], s_[N-1];
+    };
+
+    //! fixed-size natural cubic spline
+    /*! \ingroup interpolations */
+    template <Size N>
+    class FixedSizeInterpolation<N, CubicNaturalSpline>
+        : public detail::FixedSizeInterpolationBase<N> {
+      public:
+        /*! \pre the \f$ x \f$ values must be sorted. */
+        template <class I1, class I2>
+        FixedSizeInterpolation(const I1& xBegin, const I1& xEnd,
+                               const I2& yBegin) {
+            this->setNodes(xBegin, xEnd, yBegin);
+            calculate();
+        }
+        //! sets new values at the nodes
+        template <class I>
+        void update(const I& yBegin) {
+            std::copy(yBegin, yBegin+N, this->y_);
+            calculate();
+        }
+        Real operator()(Real x, bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            const Real dx = x-this->x_[i];
+            return this->y_[i] + dx*(a_[i] + dx*(b_[i] + dx*c_[i]));
+        }
+        Real derivative(Real x, bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            const Real dx = x-this->x_[i];
+            return a_[i] + (2.0*b_[i] + 3.0*c_[i]*dx)*dx;
+        }
+        Real secondDerivative(Real x,
+                              bool allowExtrapolation = false) const {
+            this->checkRange(x, allowExtrapolation);
+            const Size i = this->locate(x);
+            const Real dx = x-this->x_[i];
+            return 2.0*b_[i] + 6.0*c_[i]*dx;
+        }
+      private:
+        // coefficients of the polynomial on each segment, as in
+        // CubicInterpolation; the second derivatives at the nodes
+        // solve a tridiagonal system with zero boundary values
+        void calculate() {
+            const Real* x = this->x_;
+            const Real* y = this->y_;
+            Real h[N-1], s[N-1], m[N], diag[N];
+            for (Size i=0; i<N-1; ++i) {
+                h[i] = x[i+1]-x[i];
+                s[i] = (y[i+1]-y[i])/h[i];
+            }
+            m[0] = m[N-1] = 0.0;
+            // forward elimination...
+            for (Size i=1; i<N-1; ++i) {
+                diag[i] = 2.0*(h[i-1]+h[i]);
+                m[i] = 6.0*(s[i]-s[i-1]);
+                if (i > 1) {
+                    const Real w = h[i-1]/diag[i-1];
+                    diag[i] -= w*h[i-1];
+                    m[i] -= w*m[i-1];
+                }
+            }
+            // ...and back substitution
+            for (Size i=N-2; i>0; --i)
+                m[i] = (m[i] - h[i]*m[i+1])/diag[i];
+            for (Size i=0; i<N-1; ++i) {
+                a_[i] = s[i] - h[i]*(2.0*m[i]+m[i+1])/6.0;
+                b_[i] = m[i]/2.0;
+                c_[i] = (m[i+1]-m[i])/(6.0*h[i]);
+            }
+        }
+        Real a_[N-1], b_[N-1], c_[N-1];
+    };
+
+}
+
+
+#endif
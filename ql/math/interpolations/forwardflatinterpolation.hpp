@@ -97,7 +97,24 @@ namespace QuantLib {
             Real secondDerivative(Real) const {
                 return 0.0;
             }
+            void values(const Real* x, Size n, Real* result,
+                        bool sorted) const {
+                this->evaluateBySegment(
+                    this, &ForwardFlatInterpolationImpl::valueKernel,
+                    x, n, result, sorted);
+            }
+            void derivatives(const Real*, Size n, Real* result,
+                             bool) const {
+                std::fill(result, result+n, 0.0);
+            }
           private:
+            void valueKernel(Size i, const Real* x, Size n,
+                             Real* result) const {
+                const Real xMax = this->xBegin_[n_-1];
+                const Real y = this->yBegin_[i], yMax = this->yBegin_[n_-1];
+                for (Size k=0; k<n; ++k)
+                    result[k] = (x[k] >= xMax) ? yMax : y;
+            }
             std::vector<Real> primitive_;
             Size n_;
         };
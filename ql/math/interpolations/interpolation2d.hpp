@@ -59,6 +59,11 @@ namespace QuantLib {
             virtual const Matrix& zData() const = 0;
             virtual bool isInRange(Real x, Real y) const = 0;
             virtual Real value(Real x, Real y) const = 0;
+            virtual void values(const Real* x, const Real* y, Size n,
+                                Real* result) const {
+                for (Size k=0; k<n; ++k)
+                    result[k] = value(x[k], y[k]);
+            }
         };
         boost::shared_ptr<Impl> impl_;
       public:
@@ -156,6 +161,20 @@ namespace QuantLib {
             checkRange(x,y,allowExtrapolation);
             return impl_->value(x,y);
         }
+        /*! sets result[k] to the interpolated value at
+            (xBegin[k], yBegin[k]) for all k in [0, xEnd-xBegin).
+            Implementations storing per-cell coefficients evaluate
+            the points without further virtual calls.
+        */
+        void values(const Real* xBegin, const Real* xEnd,
+                    const Real* yBegin, Real* result,
+                    bool allowExtrapolation = false) const {
+            const Size n = xEnd-xBegin;
+            if (!allowExtrapolation && !allowsExtrapolation())
+                for (Size k=0; k<n; ++k)
+                    checkRange(xBegin[k], yBegin[k], false);
+            impl_->values(xBegin, yBegin, n, result);
+        }
         Real xMin() const {
             return impl_->xMin();
         }
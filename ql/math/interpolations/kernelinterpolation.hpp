@@ -23,6 +23,7 @@
 
 #include <ql/math/interpolation.hpp>
 #include <ql/math/matrixutilities/qrdecomposition.hpp>
+#include <vector>
 
 /*! \file kernelinterpolation.hpp
     \brief Kernel interpolation
@@ -32,6 +33,278 @@ namespace QuantLib {
 
     namespace detail {
 
+        /*! assembles and solves K a = b for the symmetric matrix K of
+            the kernel values between the nodes.
+
+            The lower triangle of K is passed row by row to add().  As
+            long as less than a tenth of the entries are non-zero, as
+            for compactly supported kernels, only the non-zero entries
+            are stored and the system is solved by conjugate gradients
+            with a Jacobi preconditioner.  Otherwise, K is stored as a
+            dense matrix and solved by a Cholesky decomposition.  The
+            storage is reused across assemblies.
+
+            solve() returns false if K turns out not to be positive
+            definite, or if the conjugate gradients do not converge;
+            the caller is expected to fall back to a general solver in
+            that case.
+        */
+        class KernelSystemSolver {
+          public:
+            enum Method { None, ConjugateGradient, Cholesky };
+            KernelSystemSolver();
+            //! starts the assembly of a new n x n system
+            void reset(Size n);
+            /*! sets K[i][j] and K[j][i] to the given value
+                \pre the entries are given for j <= i, row by row and
+                     with increasing j, each row ending with the
+                     diagonal entry.
+            */
+            void add(Size i, Size j, Real value);
+            //! \name Inspectors
+            //@{
+            Size size() const { return n_; }
+            bool sparse() const { return sparse_; }
+            //! the sums of the rows of K
+            const Array& rowSums() const { return rowSums_; }
+            //! the method used by the last successful solve
+            Method method() const { return method_; }
+            //! the conjugate-gradient iterations of the last solve
+            Size iterations() const { return iterations_; }
+            //@}
+            //! sets y = K x
+            void apply(const Array& x, Array& y) const;
+            //! dense copy of K
+            Disposable<Matrix> matrix() const;
+            /*! the conjugate gradients are allowed 10n iterations
+                unless maxIterations is given */
+            bool solve(const Array& b, Real relativeTolerance, Array& a,
+                       Size maxIterations = Null<Size>());
+          private:
+            void densify();
+            bool solveCholesky(const Array& b, Array& a);
+            bool solveConjugateGradient(const Array& b,
+                                        Real relativeTolerance,
+                                        Size maxIterations, Array& a);
+            Size n_;
+            bool sparse_;
+            // lower triangle in compressed sparse row format
+            std::vector<Size> rowOffsets_, columns_;
+            std::vector<Real> values_;
+            Matrix K_, L_;
+            Array rowSums_, r_, z_, p_, q_;
+            Method method_;
+            Size iterations_;
+        };
+
+        inline KernelSystemSolver::KernelSystemSolver()
+        : n_(0), sparse_(true), rowOffsets_(1, 0),
+          method_(None), iterations_(0) {}
+
+        inline void KernelSystemSolver::reset(Size n) {
+            n_ = n;
+            sparse_ = true;
+            rowOffsets_.assign(1, 0);
+            columns_.clear();
+            values_.clear();
+            rowSums_ = Array(n, 0.0);
+            method_ = None;
+            iterations_ = 0;
+        }
+
+        inline void KernelSystemSolver::add(Size i, Size j, Real value) {
+            rowSums_[i] += value;
+            if (j != i)
+                rowSums_[j] += value;
+
+            if (!sparse_) {
+                K_[i][j] = K_[j][i] = value;
+                return;
+            }
+            // the diagonal is always stored for the preconditioner
+            if (value != 0.0 || j == i) {
+                columns_.push_back(j);
+                values_.push_back(value);
+            }
+            if (j == i)
+                rowOffsets_.push_back(values_.size());
+            if (2*values_.size() >= n_*n_/10)
+                densify();
+        }
+
+        inline void KernelSystemSolver::densify() {
+            if (K_.rows() != n_)
+                K_ = Matrix(n_, n_);
+            std::fill(K_.begin(), K_.end(), 0.0);
+            // the last row might be incomplete
+            for (Size i=0, k=0; k<values_.size(); ++i) {
+                const Size end = i+1 < rowOffsets_.size() ?
+                    rowOffsets_[i+1] : values_.size();
+                for (; k<end; ++k)
+                    K_[i][columns_[k]] = K_[columns_[k]][i] = values_[k];
+            }
+            sparse_ = false;
+            rowOffsets_.assign(1, 0);
+            columns_.clear();
+            values_.clear();
+        }
+
+        inline void KernelSystemSolver::apply(const Array& x,
+                                              Array& y) const {
+            if (sparse_) {
+                std::fill(y.begin(), y.end(), 0.0);
+                for (Size i=0; i<n_; ++i) {
+                    Real sum = 0.0;
+                    const Real xi = x[i];
+                    for (Size k=rowOffsets_[i]; k<rowOffsets_[i+1]; ++k) {
+                        const Size j = columns_[k];
+                        sum += values_[k]*x[j];
+                        if (j != i)
+                            y[j] += values_[k]*xi;
+                    }
+                    y[i] += sum;
+                }
+            } else {
+                for (Size i=0; i<n_; ++i) {
+                    const Real* Ki = K_.row_begin(i);
+                    Real sum = 0.0;
+                    for (Size j=0; j<n_; ++j)
+                        sum += Ki[j]*x[j];
+                    y[i] = sum;
+                }
+            }
+        }
+
+        inline Disposable<Matrix> KernelSystemSolver::matrix() const {
+            if (!sparse_) {
+                Matrix K(K_);
+                return K;
+            }
+            Matrix K(n_, n_, 0.0);
+            for (Size i=0; i<n_; ++i)
+                for (Size k=rowOffsets_[i]; k<rowOffsets_[i+1]; ++k)
+                    K[i][columns_[k]] = K[columns_[k]][i] = values_[k];
+            return K;
+        }
+
+        inline bool KernelSystemSolver::solve(const Array& b,
+                                              Real relativeTolerance,
+                                              Array& a,
+                                              Size maxIterations) {
+            QL_REQUIRE(b.size() == n_, "wrong right-hand side size");
+            QL_REQUIRE(!sparse_ || rowOffsets_.size() == n_+1,
+                       "incomplete kernel system");
+            method_ = None;
+            iterations_ = 0;
+            if (a.size() != n_)
+                a = Array(n_);
+            const bool success = sparse_ ?
+                solveConjugateGradient(b, relativeTolerance,
+                                       maxIterations == Null<Size>() ?
+                                       10*n_ : maxIterations, a) :
+                solveCholesky(b, a);
+            if (success)
+                method_ = sparse_ ? ConjugateGradient : Cholesky;
+            return success;
+        }
+
+        inline bool KernelSystemSolver::solveConjugateGradient(
+                                                const Array& b,
+                                                Real relativeTolerance,
+                                                Size maxIterations,
+                                                Array& a) {
+            if (r_.size() != n_) {
+                r_ = Array(n_);
+                z_ = Array(n_);
+                p_ = Array(n_);
+                q_ = Array(n_);
+            }
+            // the diagonal closes each row
+            for (Size i=0; i<n_; ++i)
+                if (!(values_[rowOffsets_[i+1]-1] > 0.0))
+                    return false;
+
+            std::fill(a.begin(), a.end(), 0.0);
+            const Real bNorm = Norm2(b);
+            if (bNorm == 0.0)
+                return true;
+
+            std::copy(b.begin(), b.end(), r_.begin());
+            Real rz = 0.0;
+            for (Size i=0; i<n_; ++i) {
+                z_[i] = r_[i]/values_[rowOffsets_[i+1]-1];
+                rz += r_[i]*z_[i];
+            }
+            std::copy(z_.begin(), z_.end(), p_.begin());
+
+            for (Size k=0; k<maxIterations; ++k) {
+                apply(p_, q_);
+                const Real pq = DotProduct(p_, q_);
+                if (!(pq > 0.0))
+                    return false;
+                const Real alpha = rz/pq;
+                for (Size i=0; i<n_; ++i) {
+                    a[i] += alpha*p_[i];
+                    r_[i] -= alpha*q_[i];
+                }
+                const Real rNorm = Norm2(r_);
+                if (rNorm < relativeTolerance*bNorm || rNorm == 0.0) {
+                    iterations_ = k+1;
+                    return true;
+                }
+                Real rzNew = 0.0;
+                for (Size i=0; i<n_; ++i) {
+                    z_[i] = r_[i]/values_[rowOffsets_[i+1]-1];
+                    rzNew += r_[i]*z_[i];
+                }
+                const Real beta = rzNew/rz;
+                rz = rzNew;
+                for (Size i=0; i<n_; ++i)
+                    p_[i] = z_[i] + beta*p_[i];
+            }
+            iterations_ = maxIterations;
+            return false;
+        }
+
+        inline bool KernelSystemSolver::solveCholesky(const Array& b,
+                                                      Array& a) {
+            if (L_.rows() != n_)
+                L_ = Matrix(n_, n_);
+            for (Size i=0; i<n_; ++i) {
+                const Real* Li = L_.row_begin(i);
+                for (Size j=0; j<=i; ++j) {
+                    const Real* Lj = L_.row_begin(j);
+                    Real sum = K_[i][j];
+                    for (Size k=0; k<j; ++k)
+                        sum -= Li[k]*Lj[k];
+                    if (i == j) {
+                        if (!(sum > 0.0))
+                            return false;
+                        L_[i][i] = std::sqrt(sum);
+                    } else {
+                        L_[i][j] = sum/L_[j][j];
+                    }
+                }
+            }
+
+            std::copy(b.begin(), b.end(), a.begin());
+            // L z = b, then L^T a = z
+            for (Size i=0; i<n_; ++i) {
+                const Real* Li = L_.row_begin(i);
+                Real sum = a[i];
+                for (Size k=0; k<i; ++k)
+                    sum -= Li[k]*a[k];
+                a[i] = sum/Li[i];
+            }
+            for (Size i=n_; i>0; --i) {
+                const Real* Li = L_.row_begin(i-1);
+                a[i-1] /= Li[i-1];
+                for (Size k=0; k<i-1; ++k)
+                    a[k] -= Li[k]*a[i-1];
+            }
+            return true;
+        }
+
         template <class I1, class I2, class Kernel>
         class KernelInterpolationImpl
             : public Interpolation::templateImpl<I1,I2> {
@@ -42,8 +315,8 @@ namespace QuantLib {
                                     const Real epsilon)
             : Interpolation::templateImpl<I1,I2>(xBegin, xEnd, yBegin),
               xSize_(Size(xEnd-xBegin)), invPrec_(epsilon),
-              M_(xSize_,xSize_), alphaVec_(xSize_), yVec_(xSize_),
-              kernel_(kernel) {}
+              alphaVec_(xSize_), yVec_(xSize_),
+              gammaVec_(xSize_), rhs_(xSize_), kernel_(kernel) {}
 
             void update() {
                 updateAlphaVec();
@@ -51,13 +324,17 @@ namespace QuantLib {
 
             Real value(Real x) const {
 
-                Real res=0.0;
+                // numerator and normalization in a single pass,
+                // evaluating the kernel once per node
+                Real res=0.0, gamma=0.0;
 
                 for( Size i=0; i< xSize_;++i){
-                    res+=alphaVec_[i]*kernelAbs(x,this->xBegin_[i]);
+                    const Real k = kernelAbs(x,this->xBegin_[i]);
+                    res+=alphaVec_[i]*k;
+                    gamma+=k;
                 }
 
-                return res/gammaFunc(x);
+                return res/gamma;
             }
 
             Real primitive(Real) const {
@@ -81,53 +358,69 @@ namespace QuantLib {
                 return kernel_(std::fabs(x1-x2));
             }
 
-            Real gammaFunc(Real x)const{
-
-                Real res=0.0;
-
-                for(Size i=0; i< xSize_;++i){
-                    res+=kernelAbs(x,this->xBegin_[i]);
+            // whether M*alpha reproduces y up to invPrec_, with
+            // M[i][j] = K[i][j]/gamma[i]
+            bool accurate() const {
+                Array Ka(xSize_);
+                solver_.apply(alphaVec_, Ka);
+                for (Size i=0; i<xSize_; ++i) {
+                    if (!(std::fabs(Ka[i]/gammaVec_[i] - yVec_[i]) < invPrec_))
+                        return false;
                 }
-                return res;
+                return true;
             }
 
             void updateAlphaVec(){
                 // Function calculates the alpha vector with given
                 // fixed pillars+values
 
-                // Write Matrix M
-                Real tmp=0.0;
-
+                // The system y=M*alpha, with M[i][j]=K[i][j]/gamma[i],
+                // is solved as K*alpha=gamma*y, K being symmetric.
+                // Each kernel value is computed once.
+                solver_.reset(xSize_);
                 for(Size rowIt=0; rowIt<xSize_;++rowIt){
+                    for(Size colIt=0; colIt<=rowIt;++colIt){
+                        solver_.add(rowIt, colIt,
+                                    kernelAbs(this->xBegin_[rowIt],
+                                              this->xBegin_[colIt]));
+                    }
+                }
 
+                Real minGamma=QL_MAX_REAL;
+                for(Size rowIt=0; rowIt<xSize_;++rowIt){
+                    gammaVec_[rowIt]=solver_.rowSums()[rowIt];
+                    minGamma=std::min(minGamma,gammaVec_[rowIt]);
                     yVec_[rowIt]=this->yBegin_[rowIt];
-                    tmp=1.0/gammaFunc(this->xBegin_[rowIt]);
-
-                    for(Size colIt=0; colIt<xSize_;++colIt){
-                        M_[rowIt][colIt]=kernelAbs(this->xBegin_[rowIt],
-                                                   this->xBegin_[colIt])*tmp;
-                    }
+                    rhs_[rowIt]=gammaVec_[rowIt]*yVec_[rowIt];
                 }
 
-                // Solve y=M*\alpha for \alpha
-                alphaVec_ = qrSolve(M_, yVec_);
+                // the tolerance on K*alpha-gamma*y ensuring the
+                // required precision on M*alpha-y
+                const Real bNorm=Norm2(rhs_);
+                const Real relTol=
+                    bNorm > 0.0 ? 0.1*invPrec_*minGamma/bNorm : 1.0;
+
+                if (!solver_.solve(rhs_, relTol, alphaVec_)
+                    || !accurate()) {
+                    // fall back to the original formulation
+                    Matrix M = solver_.matrix();
+                    for (Size rowIt=0; rowIt<xSize_; ++rowIt)
+                        for (Size colIt=0; colIt<xSize_; ++colIt)
+                            M[rowIt][colIt]/=gammaVec_[rowIt];
+                    alphaVec_ = qrSolve(M, yVec_);
+                }
 
                 // check if inversion worked up to a reasonable precision.
                 // I've chosen not to check determinant(M_)!=0 before solving
-
-                Array diffVec=Abs(M_*alphaVec_ - yVec_);
-
-                for (Size i=0; i<diffVec.size(); ++i) {
-                    QL_REQUIRE(diffVec[i] < invPrec_,
-                               "Inversion failed in 1d kernel interpolation");
-                }
+                QL_REQUIRE(accurate(),
+                           "Inversion failed in 1d kernel interpolation");
             }
 
             Size xSize_;
             Real invPrec_;
-            Matrix M_;
-            Array alphaVec_,yVec_;
+            Array alphaVec_,yVec_,gammaVec_,rhs_;
             Kernel kernel_;
+            KernelSystemSolver solver_;
         };
 
     } // end namespace detail
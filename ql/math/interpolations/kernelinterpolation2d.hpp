@@ -25,7 +25,7 @@
 #define quantlib_kernel_interpolation2D_hpp
 
 #include <ql/math/interpolations/interpolation2d.hpp>
-#include <ql/math/matrixutilities/qrdecomposition.hpp>
+#include <ql/math/interpolations/kernelinterpolation.hpp>
 
 /*
   Grid Explanation:
@@ -65,7 +65,7 @@ namespace QuantLib {
               xSize_(Size(xEnd-xBegin)), ySize_(Size(yEnd-yBegin)),
               xySize_(xSize_*ySize_), invPrec_(1.0e-10),
               alphaVec_(xySize_), yVec_(xySize_),
-              M_(xySize_,xySize_),
+              gammaVec_(xySize_), rhs_(xySize_),
               kernel_(kernel) {
 
                 QL_REQUIRE(zData.rows()==xSize_,
@@ -80,22 +80,23 @@ namespace QuantLib {
 
             Real value(Real x1, Real x2) const {
 
-                Real res=0.0;
-
-                Array X(2),Xn(2);
-                X[0]=x1;X[1]=x2;
+                // numerator and normalization in a single pass,
+                // evaluating the kernel once per node
+                Real res=0.0, gamma=0.0;
 
                 Size cnt=0; // counter
 
                 for( Size j=0; j< ySize_;++j){
                     for( Size i=0; i< xSize_;++i){
-                        Xn[0]=this->xBegin_[i];
-                        Xn[1]=this->yBegin_[j];
-                        res+=alphaVec_[cnt]*kernelAbs(X,Xn);
+                        const Real k = kernelAbs(x1, x2,
+                                                 this->xBegin_[i],
+                                                 this->yBegin_[j]);
+                        res+=alphaVec_[cnt]*k;
+                        gamma+=k;
                         cnt++;
                     }
                 }
-                return res/gammaFunc(X);
+                return res/gamma;
             }
 
             // the calculation will solve y=M*a for a.  Due to
@@ -108,53 +109,47 @@ namespace QuantLib {
 
         private:
 
-            // returns K(||X-Y||) where X,Y are vectors
-            Real kernelAbs(const Array& X, const Array& Y)const{
-                return kernel_(Norm2(X-Y));
+            // returns K(||X-Y||) where X=(x1,x2), Y=(y1,y2)
+            Real kernelAbs(Real x1, Real x2, Real y1, Real y2) const {
+                const Real d1 = x1-y1, d2 = x2-y2;
+                return kernel_(std::sqrt(d1*d1+d2*d2));
             }
 
-            Real gammaFunc(const Array& X)const{
-
-                Real res=0.0;
-                Array Xn(X.size());
-
-                for(Size j=0; j< ySize_;++j){
-                    for(Size i=0; i< xSize_;++i){
-                        Xn[0]=this->xBegin_[i];
-                        Xn[1]=this->yBegin_[j];
-                        res+=kernelAbs(X,Xn);
-                    }
+            // whether M*alpha reproduces y up to invPrec_, with
+            // M[i][j] = K[i][j]/gamma[i]
+            bool accurate() const {
+                Array Ka(xySize_);
+                solver_.apply(alphaVec_, Ka);
+                for (Size i=0; i<xySize_; ++i) {
+                    if (!(std::fabs(Ka[i]/gammaVec_[i] - yVec_[i]) < invPrec_))
+                        return false;
                 }
-
-                return res;
+                return true;
             }
 
             void updateAlphaVec(){
                 // Function calculates the alpha vector with given
                 // fixed pillars+values
 
-                Array Xk(2),Xn(2);
-
-                Size rowCnt=0,colCnt=0;
-                Real tmpVar=0.0;
-
-                // write y-vector and M-Matrix
+                // The system y=M*alpha, with M[k][n]=K[k][n]/gamma[k],
+                // is solved as K*alpha=gamma*y, K being symmetric.
+                // Each kernel value is computed once.
+                solver_.reset(xySize_);
+                Size rowCnt=0;
                 for(Size j=0; j< ySize_;++j){
                     for(Size i=0; i< xSize_;++i){
 
                         yVec_[rowCnt]=this->zData_[i][j];
-                        // calculate X_k
-                        Xk[0]=this->xBegin_[i];
-                        Xk[1]=this->yBegin_[j];
-
-                        tmpVar=1/gammaFunc(Xk);
-                        colCnt=0;
-
-                        for(Size jM=0; jM< ySize_;++jM){
-                            for(Size iM=0; iM< xSize_;++iM){
-                                Xn[0]=this->xBegin_[iM];
-                                Xn[1]=this->yBegin_[jM];
-                                M_[rowCnt][colCnt]=kernelAbs(Xk,Xn)*tmpVar;
+
+                        Size colCnt=0;
+                        for(Size jM=0; jM<=j;++jM){
+                            for(Size iM=0; iM< xSize_ && colCnt<=rowCnt;
+                                ++iM){
+                                solver_.add(rowCnt, colCnt,
+                                            kernelAbs(this->xBegin_[i],
+                                                      this->yBegin_[j],
+                                                      this->xBegin_[iM],
+                                                      this->yBegin_[jM]));
                                 colCnt++; // increase column counter
                             }// end iM
                         }// end jM
@@ -162,25 +157,42 @@ namespace QuantLib {
                     } // end i
                 }// end j
 
-                alphaVec_=qrSolve(M_, yVec_);
+                Real minGamma=QL_MAX_REAL;
+                for(Size k=0; k<xySize_;++k){
+                    gammaVec_[k]=solver_.rowSums()[k];
+                    minGamma=std::min(minGamma,gammaVec_[k]);
+                    rhs_[k]=gammaVec_[k]*yVec_[k];
+                }
+
+                // the tolerance on K*alpha-gamma*y ensuring the
+                // required precision on M*alpha-y
+                const Real bNorm=Norm2(rhs_);
+                const Real relTol=
+                    bNorm > 0.0 ? 0.1*invPrec_*minGamma/bNorm : 1.0;
+
+                if (!solver_.solve(rhs_, relTol, alphaVec_)
+                    || !accurate()) {
+                    // fall back to the original formulation
+                    Matrix M_ = solver_.matrix();
+                    for (Size k=0; k<xySize_; ++k)
+                        for (Size l=0; l<xySize_; ++l)
+                            M_[k][l]/=gammaVec_[k];
+                    alphaVec_=qrSolve(M_, yVec_);
+                }
 
                 // check if inversion worked up to a reasonable precision.
                 // I've chosen not to check determinant(M_)!=0 before solving
-
-                Array diffVec=Abs(M_*alphaVec_ - yVec_);
-                for (Size i=0; i<diffVec.size(); ++i) {
-                    QL_REQUIRE(diffVec[i]<invPrec_,
-                               "inversion failed in 2d kernel interpolation");
-                }
+                QL_REQUIRE(accurate(),
+                           "inversion failed in 2d kernel interpolation");
             }
 
           private:
 
             Size xSize_,ySize_,xySize_;
             Real invPrec_;
-            Array alphaVec_, yVec_;
-            Matrix M_;
+            Array alphaVec_, yVec_, gammaVec_, rhs_;
             Kernel kernel_;
+            KernelSystemSolver solver_;
         };
 
     } // end namespace detail
@@ -99,7 +99,30 @@ namespace QuantLib {
             Real secondDerivative(Real) const {
                 return 0.0;
             }
+            void values(const Real* x, Size n, Real* result,
+                        bool sorted) const {
+                this->evaluateBySegment(
+                    this, &LinearInterpolationImpl::valueKernel,
+                    x, n, result, sorted);
+            }
+            void derivatives(const Real* x, Size n, Real* result,
+                             bool sorted) const {
+                this->evaluateBySegment(
+                    this, &LinearInterpolationImpl::derivativeKernel,
+                    x, n, result, sorted);
+            }
           private:
+            void valueKernel(Size i, const Real* x, Size n,
+                             Real* result) const {
+                const Real x0 = this->xBegin_[i], y0 = this->yBegin_[i];
+                const Real s = s_[i];
+                for (Size k=0; k<n; ++k)
+                    result[k] = y0 + (x[k]-x0)*s;
+            }
+            void derivativeKernel(Size i, const Real*, Size n,
+                                  Real* result) const {
+                std::fill(result, result+n, s_[i]);
+            }
             std::vector<Real> primitiveConst_, s_;
         };
 
@@ -331,6 +331,22 @@ namespace QuantLib {
                 return derivative(x)*interpolation_.derivative(x, true) +
                             value(x)*interpolation_.secondDerivative(x, true);
             }
+            void values(const Real* x, Size n, Real* result,
+                        bool) const {
+                interpolation_.values(x, x+n, result, true);
+                for (Size k=0; k<n; ++k)
+                    result[k] = std::exp(result[k]);
+            }
+            void derivatives(const Real* x, Size n, Real* result,
+                             bool) const {
+                if (n == 0)
+                    return;
+                std::vector<Real> y(n);
+                values(x, n, &y[0], true);
+                interpolation_.derivatives(x, x+n, result, true);
+                for (Size k=0; k<n; ++k)
+                    result[k] *= y[k];
+            }
           private:
             std::vector<Real> logY_;
             Interpolation interpolation_;
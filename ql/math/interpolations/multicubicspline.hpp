@@ -462,6 +462,11 @@ namespace QuantLib {
 
         \bug cannot interpolate at the grid points on the boundary
              surface of the N-dimensional region
+
+        \note TensorProductInterpolation provides the same natural
+              spline in flat storage, with per-axis choice between
+              linear and cubic interpolation and batch evaluation;
+              it is preferable for repeated evaluations.
     */
     template <Size i> class MultiCubicSpline {
         typedef typename detail::Int2Type<i>::c_spline c_spline;
@@ -0,0 +1,130 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file polynomialsurface.hpp
+    \brief piecewise polynomial surface on a rectangular grid
+*/
+
+#ifndef quantlib_polynomial_surface_hpp
+#define quantlib_polynomial_surface_hpp
+
+#include <ql/errors.hpp>
+#include <ql/types.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace QuantLib {
+
+    namespace detail {
+
+        //! piecewise polynomial surface on a rectangular grid
+        /*! On the cell \f$ [x_i, x_{i+1}] \times [y_j, y_{j+1}] \f$
+            the surface is
+            \f[
+            \sum_{m,n=0}^{d-1} c^{ij}_{mn} (x-x_i)^m (y-y_j)^n
+            \f]
+            where \f$ d \f$ is the order of the polynomials (2 for
+            bilinear, 4 for bicubic surfaces).  The coefficients of
+            each cell are stored contiguously, cells with the same
+            \f$ j \f$ being adjacent, so that the evaluation only
+            needs the cell lookup and a nested Horner scheme.  Outside
+            the grid, the polynomials of the boundary cells are
+            extended.
+        */
+        class PolynomialSurface {
+          public:
+            PolynomialSurface() : order_(0) {}
+            /*! sets the grid and the order of the polynomials; the
+                coefficients are left to be filled through cell().
+                Storage is reused if the sizes do not change.
+            */
+            template <class I1, class I2>
+            void reset(const I1& xBegin, const I1& xEnd,
+                       const I2& yBegin, const I2& yEnd, Size order) {
+                QL_REQUIRE(xEnd-xBegin >= 2 && yEnd-yBegin >= 2,
+                           "at least 2 points required in each direction");
+                x_.assign(xBegin, xEnd);
+                y_.assign(yBegin, yEnd);
+                order_ = order;
+                coefficients_.resize((x_.size()-1)*(y_.size()-1)
+                                     *order_*order_);
+            }
+            Size order() const { return order_; }
+            //! coefficients c[m*order()+n] of the cell (i,j)
+            Real* cell(Size i, Size j) {
+                return &coefficients_[(j*(x_.size()-1)+i)*order_*order_];
+            }
+            const Real* cell(Size i, Size j) const {
+                return &coefficients_[(j*(x_.size()-1)+i)*order_*order_];
+            }
+            Real value(Real x, Real y) const {
+                const Size i = locate(x_, x), j = locate(y_, y);
+                return evaluate(cell(i,j), x-x_[i], y-y_[j]);
+            }
+            /*! sets result[k] to the value at (x[k], y[k]).  The cell
+                of the previous point is checked first, so that runs of
+                points in the same cell skip the binary searches.
+            */
+            void values(const Real* x, const Real* y, Size n,
+                        Real* result) const {
+                Size i = 0, j = 0;
+                for (Size k=0; k<n; ++k) {
+                    if (!inSegment(x_, i, x[k]))
+                        i = locate(x_, x[k]);
+                    if (!inSegment(y_, j, y[k]))
+                        j = locate(y_, y[k]);
+                    result[k] = evaluate(cell(i,j), x[k]-x_[i], y[k]-y_[j]);
+                }
+            }
+          private:
+            // same segment as Interpolation2D::templateImpl::locateX
+            static Size locate(const std::vector<Real>& nodes, Real x) {
+                if (x < nodes.front())
+                    return 0;
+                else if (x > nodes.back())
+                    return nodes.size()-2;
+                else
+                    return std::upper_bound(nodes.begin(), nodes.end()-1, x)
+                        - nodes.begin() - 1;
+            }
+            // whether locate(nodes, x) would return i
+            static bool inSegment(const std::vector<Real>& nodes,
+                                  Size i, Real x) {
+                return (i == 0 || x >= nodes[i])
+                    && (i == nodes.size()-2 || x < nodes[i+1]);
+            }
+            Real evaluate(const Real* c, Real dx, Real dy) const {
+                Real result = 0.0;
+                for (Size m=order_; m>0; --m) {
+                    const Real* cm = c + (m-1)*order_;
+                    Real row = cm[order_-1];
+                    for (Size n=order_-1; n>0; --n)
+                        row = row*dy + cm[n-1];
+                    result = result*dx + row;
+                }
+                return result;
+            }
+            Size order_;
+            std::vector<Real> x_, y_, coefficients_;
+        };
+
+    }
+
+}
+
+
+#endif
@@ -56,6 +56,16 @@ class SABRWrapper {
         return shiftedSabrVolatility(x, forward_, t_, params_[0], params_[1],
                                      params_[2], params_[3], shift_);
     }
+    void volatilities(const Real *x, Size n, Real *result) {
+        sabrVolatilities(x, n, forward_, t_, params_[0], params_[1],
+                         params_[2], params_[3], result, shift_);
+    }
+    // returns the volatility and sets its derivatives in the parameters
+    Real volatilityGradient(const Real x, Real *gradient) {
+        return unsafeSabrVolatilityGradient(
+            x + shift_, forward_ + shift_, t_, params_[0], params_[1],
+            params_[2], params_[3], gradient);
+    }
 
   private:
     const Real t_, &forward_;
@@ -133,6 +143,21 @@ struct SABRSpecs {
                    : eps2() * (x[3] > 0.0 ? 1.0 : (-1.0));
         return y;
     }
+    // derivatives of the components of direct(x), each of which
+    // depends on the corresponding component of x only
+    Array directDerivatives(const Array &x, const std::vector<bool> &,
+                            const std::vector<Real> &, const Real) {
+        Array dy(4);
+        dy[0] = std::fabs(x[0]) < 5.0 ? 2.0 * x[0]
+                                      : (x[0] > 0.0 ? 10.0 : -10.0);
+        dy[1] = std::fabs(x[1]) < std::sqrt(-std::log(eps1()))
+                    ? -2.0 * x[1] * std::exp(-(x[1] * x[1]))
+                    : 0.0;
+        dy[2] = std::fabs(x[2]) < 5.0 ? 2.0 * x[2]
+                                      : (x[2] > 0.0 ? 10.0 : -10.0);
+        dy[3] = std::fabs(x[3]) < 2.5 * M_PI ? eps2() * std::cos(x[3]) : 0.0;
+        return dy;
+    }
     Real weight(const Real strike, const Real forward, const Real stdDev,
                 const std::vector<Real> &addParams) {
         return blackFormulaStdDevDerivative(strike, forward, stdDev, 1.0,
@@ -145,6 +170,11 @@ struct SABRSpecs {
         return boost::make_shared<type>(t, forward, params, addParams);
     }
 };
+
+template <> struct XABRModelTraits<SABRSpecs> {
+    typedef boost::true_type batchVolatilities;
+    typedef boost::true_type analyticGradient;
+};
 }
 
 //! %SABR smile interpolation between discrete volatility points.
@@ -0,0 +1,328 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file tensorproductinterpolation.hpp
+    \brief N-dimensional tensor-product interpolation on a grid
+*/
+
+#ifndef quantlib_tensor_product_interpolation_hpp
+#define quantlib_tensor_product_interpolation_hpp
+
+#include <ql/math/interpolations/extrapolation.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/methods/finitedifferences/tridiagonaloperator.hpp>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace QuantLib {
+
+    //! N-dimensional tensor-product interpolation on a grid
+    /*! Each axis is interpolated either linearly or by a natural
+        cubic spline; the result is the tensor product of the
+        one-dimensional interpolations, i.e., the same as
+        interpolating along each axis in turn.
+
+        The function values are stored in a single flat array, the
+        last axis running fastest.  For the cubic axes, the second
+        derivatives of the splines along every subset of them are
+        computed on construction (and by update()) and stored next
+        to the value at each node, so that the evaluation of a point
+        only reads the \f$ 2^N \f$ nodes of its cell.  The
+        construction of the second derivatives is distributed among
+        threads if the library is compiled with OpenMP enabled.
+
+        Outside the grid, the polynomials of the boundary cells are
+        extended.
+
+        \pre the values must outlive the interpolation, as in the
+             other interpolation classes.
+
+        \test the interpolation is checked against the nested
+              one-dimensional interpolations in 3 and 4 dimensions.
+
+        \ingroup interpolations
+    */
+    class TensorProductInterpolation : public Extrapolator {
+      public:
+        enum Scheme { Linear, Cubic };
+        /*! \pre the grid values along each axis must be sorted; the
+                 values of the function at the grid points are given
+                 with the last axis running fastest.
+        */
+        TensorProductInterpolation(
+                             const std::vector<std::vector<Real> >& grid,
+                             const std::vector<Real>& values,
+                             const std::vector<Scheme>& schemes);
+        //! \name Inspectors
+        //@{
+        Size dimensions() const { return grid_.size(); }
+        const std::vector<Real>& axis(Size i) const { return grid_[i]; }
+        bool isInRange(const std::vector<Real>& x) const;
+        //@}
+        //! \name Calculations
+        //@{
+        Real operator()(const std::vector<Real>& x,
+                        bool allowExtrapolation = false) const;
+        /*! sets result[k] to the interpolated value at the point
+            whose coordinates are x[k*dimensions()], ...,
+            x[k*dimensions()+dimensions()-1], for k in [0,n).
+        */
+        void values(const Real* x, Size n, Real* result,
+                    bool allowExtrapolation = false) const;
+        //! recalculates the second derivatives after the values change
+        void update();
+        //@}
+      private:
+        bool isInRange(const Real* x) const;
+        void checkRange(const Real* x, bool extrapolate) const;
+        /* k holds the cell of the previous point on entry and that of
+           x on exit; w and weights are workspace of sizes
+           4*dimensions() and the number of slots. */
+        Real value(const Real* x, Size* k, Real* w, Real* weights) const;
+        void addSecondDerivatives(Size axis, Size bit);
+        std::vector<std::vector<Real> > grid_;
+        const std::vector<Real>& values_;
+        std::vector<Scheme> schemes_;
+        std::vector<Size> strides_;
+        // values and second derivatives at each node; slot s holds
+        // the derivatives along the cubic axes whose bit is set in s
+        Size slots_;
+        std::vector<Real> data_;
+    };
+
+
+    // inline definitions
+
+    inline TensorProductInterpolation::TensorProductInterpolation(
+                             const std::vector<std::vector<Real> >& grid,
+                             const std::vector<Real>& values,
+                             const std::vector<Scheme>& schemes)
+    : grid_(grid), values_(values), schemes_(schemes),
+      strides_(grid.size()), slots_(1) {
+        const Size n = grid_.size();
+        QL_REQUIRE(n > 0, "empty grid");
+        QL_REQUIRE(schemes_.size() == n,
+                   "number of schemes (" << schemes_.size()
+                   << ") does not match the grid dimensions ("
+                   << n << ")");
+        Size size = 1;
+        for (Size i=n; i>0; --i) {
+            const std::vector<Real>& x = grid_[i-1];
+            QL_REQUIRE(x.size() >= 2,
+                       "axis " << i-1 << ": at least 2 points required, "
+                       << x.size() << " provided");
+            for (Size j=1; j<x.size(); ++j)
+                QL_REQUIRE(x[j] > x[j-1],
+                           "axis " << i-1 << ": unsorted values");
+            strides_[i-1] = size;
+            size *= x.size();
+            if (schemes_[i-1] == Cubic)
+                slots_ *= 2;
+        }
+        QL_REQUIRE(values_.size() == size,
+                   "number of values (" << values_.size()
+                   << ") does not match the grid size (" << size << ")");
+        update();
+    }
+
+    inline void TensorProductInterpolation::update() {
+        data_.assign(values_.size()*slots_, 0.0);
+        for (Size i=0; i<values_.size(); ++i)
+            data_[i*slots_] = values_[i];
+        Size slot = 1;
+        for (Size i=0; i<grid_.size(); ++i) {
+            if (schemes_[i] == Cubic) {
+                addSecondDerivatives(i, slot);
+                slot *= 2;
+            }
+        }
+    }
+
+    /* For each slot s without the given bit, sets the slot s|bit to
+       the second derivatives along the axis of the spline through
+       slot s.  The interior points of all the lines along the axis
+       within an outer block are interleaved rows, which allows one
+       factorization to solve for all of them at once. */
+    inline void TensorProductInterpolation::addSecondDerivatives(
+                                                     Size axis, Size bit) {
+        const std::vector<Real>& x = grid_[axis];
+        const Size n = x.size();
+        if (n < 3)
+            return;
+        const Size m = n-2;
+        const Size count = strides_[axis]*slots_;
+        const Size blocks = values_.size()/(n*strides_[axis]);
+
+        std::vector<Real> h(n-1);
+        for (Size i=0; i<n-1; ++i)
+            h[i] = x[i+1]-x[i];
+        TridiagonalFactorization factorization;
+        if (m > 1) {
+            TridiagonalOperator L(m);
+            L.setFirstRow(2.0*(h[0]+h[1]), h[1]);
+            for (Size i=1; i<m-1; ++i)
+                L.setMidRow(i, h[i], 2.0*(h[i]+h[i+1]), h[i+1]);
+            L.setLastRow(h[m-1], 2.0*(h[m-1]+h[m]));
+            factorization = TridiagonalFactorization(L);
+        }
+
+        const long nBlocks = static_cast<long>(blocks);
+        #if defined(_OPENMP)
+        #pragma omp parallel for if (data_.size() > 100000)
+        #endif
+        for (long b=0; b<nBlocks; ++b) {
+            Real* block = &data_[b*n*count];
+            Array rhs(m*count);
+            for (Size i=1; i<n-1; ++i) {
+                const Real* y0 = block + (i-1)*count;
+                const Real* y1 = y0 + count;
+                const Real* y2 = y1 + count;
+                Real* r = rhs.begin() + (i-1)*count;
+                for (Size k=0; k<count; ++k)
+                    r[k] = 6.0*((y2[k]-y1[k])/h[i] - (y1[k]-y0[k])/h[i-1]);
+            }
+            if (m > 1)
+                factorization.solveFor(rhs, rhs, count);
+            else
+                rhs /= 2.0*(h[0]+h[1]);
+            for (Size i=1; i<n-1; ++i) {
+                Real* y = block + i*count;
+                const Real* r = rhs.begin() + (i-1)*count;
+                for (Size k=0; k<count; k+=slots_)
+                    for (Size s=0; s<slots_; ++s)
+                        if (!(s & bit))
+                            y[k+(s|bit)] = r[k+s];
+            }
+        }
+    }
+
+    inline bool TensorProductInterpolation::isInRange(
+                                           const std::vector<Real>& x) const {
+        QL_REQUIRE(x.size() == grid_.size(),
+                   "point dimension (" << x.size()
+                   << ") does not match the grid dimensions ("
+                   << grid_.size() << ")");
+        return isInRange(&x[0]);
+    }
+
+    inline bool TensorProductInterpolation::isInRange(const Real* x) const {
+        for (Size i=0; i<grid_.size(); ++i) {
+            const Real x1 = grid_[i].front(), x2 = grid_[i].back();
+            if (!((x[i] >= x1 && x[i] <= x2) ||
+                  close(x[i],x1) || close(x[i],x2)))
+                return false;
+        }
+        return true;
+    }
+
+    inline void TensorProductInterpolation::checkRange(
+                                      const Real* x, bool extrapolate) const {
+        if (extrapolate || allowsExtrapolation() || isInRange(x))
+            return;
+        std::ostringstream point;
+        for (Size i=0; i<grid_.size(); ++i)
+            point << (i == 0 ? "(" : ", ") << x[i];
+        QL_FAIL("extrapolation at " << point.str() << ") not allowed");
+    }
+
+    inline Real TensorProductInterpolation::operator()(
+                                         const std::vector<Real>& x,
+                                         bool allowExtrapolation) const {
+        QL_REQUIRE(x.size() == grid_.size(),
+                   "point dimension (" << x.size()
+                   << ") does not match the grid dimensions ("
+                   << grid_.size() << ")");
+        Real result;
+        values(&x[0], 1, &result, allowExtrapolation);
+        return result;
+    }
+
+    inline void TensorProductInterpolation::values(
+                                          const Real* x, Size n,
+                                          Real* result,
+                                          bool allowExtrapolation) const {
+        const Size dims = grid_.size();
+        std::vector<Size> k(dims, 0);
+        std::vector<Real> w(4*dims), weights(slots_);
+        for (Size i=0; i<n; ++i) {
+            checkRange(x+i*dims, allowExtrapolation);
+            result[i] = value(x+i*dims, &k[0], &w[0], &weights[0]);
+        }
+    }
+
+    inline Real TensorProductInterpolation::value(const Real* x, Size* k,
+                                                  Real* w,
+                                                  Real* weights) const {
+        const Size dims = grid_.size();
+        // cell and weights along each axis: a and b for the values
+        // at the lower and upper node, a2 and b2 for the second
+        // derivatives
+        for (Size i=0; i<dims; ++i) {
+            const std::vector<Real>& v = grid_[i];
+            const Size last = v.size()-2;
+            Size j = k[i];
+            if (!((j == 0 || x[i] >= v[j]) && (j == last || x[i] < v[j+1]))) {
+                if (x[i] < v.front())
+                    j = 0;
+                else if (x[i] > v.back())
+                    j = last;
+                else
+                    j = std::upper_bound(v.begin(), v.end()-1, x[i])
+                        - v.begin() - 1;
+                k[i] = j;
+            }
+            const Real h = v[j+1]-v[j];
+            const Real a = (v[j+1]-x[i])/h, b = (x[i]-v[j])/h;
+            w[4*i] = a;
+            w[4*i+1] = b;
+            w[4*i+2] = (a*a*a-a)*h*h/6.0;
+            w[4*i+3] = (b*b*b-b)*h*h/6.0;
+        }
+
+        Real result = 0.0;
+        const Size corners = Size(1) << dims;
+        for (Size c=0; c<corners; ++c) {
+            Size node = 0, filled = 1;
+            weights[0] = 1.0;
+            for (Size i=0; i<dims; ++i) {
+                const Size upper = (c >> i) & 1;
+                node += (k[i]+upper)*strides_[i];
+                const Real u = w[4*i+upper];
+                if (schemes_[i] == Cubic) {
+                    const Real d = w[4*i+2+upper];
+                    for (Size s=0; s<filled; ++s) {
+                        weights[s+filled] = weights[s]*d;
+                        weights[s] *= u;
+                    }
+                    filled *= 2;
+                } else {
+                    for (Size s=0; s<filled; ++s)
+                        weights[s] *= u;
+                }
+            }
+            const Real* p = &data_[node*slots_];
+            for (Size s=0; s<slots_; ++s)
+                result += weights[s]*p[s];
+        }
+        return result;
+    }
+
+}
+
+
+#endif
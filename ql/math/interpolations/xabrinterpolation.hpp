@@ -42,11 +42,41 @@
 #include <ql/math/optimization/projectedcostfunction.hpp>
 #include <ql/math/optimization/constraint.hpp>
 #include <ql/math/randomnumbers/haltonrsg.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 
 namespace QuantLib {
 
 namespace detail {
 
+/*! Optional capabilities of an XABR model, off by default.  A model
+    can specialize this class to enable them:
+    - batchVolatilities: the model instance provides
+      \code
+          void volatilities(const Real *x, Size n, Real *result);
+      \endcode
+      which is used to compute the calibration residuals;
+    - analyticGradient: the model instance provides
+      \code
+          Real volatilityGradient(const Real x, Real *gradient);
+      \endcode
+      returning the volatility and setting its derivatives in the model
+      parameters, and the model provides
+      \code
+          Array directDerivatives(const Array &x,
+                                  const std::vector<bool> &paramIsFixed,
+                                  const std::vector<Real> &params,
+                                  const Real forward);
+      \endcode
+      returning the derivatives of each component of direct() in the
+      corresponding component of x; they are used to compute the
+      jacobian of the calibration residuals, which is otherwise
+      approximated by finite differences.
+*/
+template <typename Model> struct XABRModelTraits {
+    typedef boost::false_type batchVolatilities;
+    typedef boost::false_type analyticGradient;
+};
+
 template <typename Model> class XABRCoeffHolder {
   public:
     XABRCoeffHolder(const Time t, const Real &forward,
@@ -118,7 +148,9 @@ class XABRInterpolationImpl : public Interpolation::templateImpl<I1, I2>,
         // if no optimization method or endCriteria is provided, we provide one
         if (!optMethod_)
             optMethod_ = boost::shared_ptr<OptimizationMethod>(
-                new LevenbergMarquardt(1e-8, 1e-8, 1e-8));
+                new LevenbergMarquardt(
+                    1e-8, 1e-8, 1e-8,
+                    XABRModelTraits<Model>::analyticGradient::value));
         // optMethod_ = boost::shared_ptr<OptimizationMethod>(new
         //    Simplex(0.01));
         if (!endCriteria_) {
@@ -256,6 +288,11 @@ class XABRInterpolationImpl : public Interpolation::templateImpl<I1, I2>,
 
     // calculate weighted differences
     Disposable<Array> interpolationErrors() const {
+        return interpolationErrors(
+            typename XABRModelTraits<Model>::batchVolatilities());
+    }
+
+    Disposable<Array> interpolationErrors(const boost::false_type &) const {
         Array results(this->xEnd_ - this->xBegin_);
         std::vector<Real>::const_iterator x = this->xBegin_;
         Array::iterator r = results.begin();
@@ -267,6 +304,42 @@ class XABRInterpolationImpl : public Interpolation::templateImpl<I1, I2>,
         return results;
     }
 
+    Disposable<Array> interpolationErrors(const boost::true_type &) const {
+        const std::vector<Real> strikes(this->xBegin_, this->xEnd_);
+        Array results(strikes.size());
+        this->modelInstance_->volatilities(&strikes[0], strikes.size(),
+                                           results.begin());
+        Array::iterator r = results.begin();
+        std::vector<Real>::const_iterator y = this->yBegin_;
+        std::vector<Real>::const_iterator w = this->weights_.begin();
+        for (; r != results.end(); ++r, ++w, ++y) {
+            *r = (*r - *y) * std::sqrt(*w);
+        }
+        return results;
+    }
+
+    /* calculate weighted differences and their derivatives in the
+       transformed parameters x, given the derivatives dydx of the
+       model parameters y = Model().direct(x); only available if
+       XABRModelTraits<Model>::analyticGradient is true */
+    Disposable<Array> interpolationErrorsJacobian(Matrix &jac,
+                                                  const Array &dydx) const {
+        const Size n = this->xEnd_ - this->xBegin_;
+        Array results(n), gradient(dydx.size());
+        std::vector<Real>::const_iterator x = this->xBegin_;
+        std::vector<Real>::const_iterator y = this->yBegin_;
+        std::vector<Real>::const_iterator w = this->weights_.begin();
+        for (Size i = 0; i < n; ++i, ++x, ++y, ++w) {
+            const Real sqrtW = std::sqrt(*w);
+            const Real vol = this->modelInstance_->volatilityGradient(
+                *x, gradient.begin());
+            results[i] = (vol - *y) * sqrtW;
+            for (Size j = 0; j < dydx.size(); ++j)
+                jac[i][j] = gradient[j] * dydx[j] * sqrtW;
+        }
+        return results;
+    }
+
     Real interpolationError() const {
         Size n = this->xEnd_ - this->xBegin_;
         Real squaredError = interpolationSquaredError();
@@ -307,7 +380,52 @@ class XABRInterpolationImpl : public Interpolation::templateImpl<I1, I2>,
             return xabr_->interpolationErrors();
         }
 
+        bool hasAnalyticJacobian() const {
+            return XABRModelTraits<Model>::analyticGradient::value;
+        }
+
+        void jacobian(Matrix &jac, const Array &x) const {
+            jacobian(jac, x,
+                     typename XABRModelTraits<Model>::analyticGradient());
+        }
+
+        Disposable<Array> valuesAndJacobian(Matrix &jac,
+                                            const Array &x) const {
+            return valuesAndJacobian(
+                jac, x, typename XABRModelTraits<Model>::analyticGradient());
+        }
+
       private:
+        void jacobian(Matrix &jac, const Array &x,
+                      const boost::false_type &) const {
+            CostFunction::jacobian(jac, x);
+        }
+
+        void jacobian(Matrix &jac, const Array &x,
+                      const boost::true_type &) const {
+            valuesAndJacobian(jac, x, boost::true_type());
+        }
+
+        Disposable<Array> valuesAndJacobian(Matrix &jac, const Array &x,
+                                            const boost::false_type &) const {
+            return CostFunction::valuesAndJacobian(jac, x);
+        }
+
+        /* the model parameters act on the transformed ones component
+           by component, so that the chain rule only involves the
+           derivatives of Model().direct along the diagonal */
+        Disposable<Array> valuesAndJacobian(Matrix &jac, const Array &x,
+                                            const boost::true_type &) const {
+            const Array y = Model().direct(x, xabr_->paramIsFixed_,
+                                           xabr_->params_, xabr_->forward_);
+            const Array dydx = Model().directDerivatives(
+                x, xabr_->paramIsFixed_, xabr_->params_, xabr_->forward_);
+            for (Size i = 0; i < xabr_->params_.size(); ++i)
+                xabr_->params_[i] = y[i];
+            xabr_->updateModelInstance();
+            return xabr_->interpolationErrorsJacobian(jac, dydx);
+        }
+
         XABRInterpolationImpl *xabr_;
     };
     boost::shared_ptr<EndCriteria> endCriteria_;
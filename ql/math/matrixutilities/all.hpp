@@ -1,6 +1,7 @@
 //#include <ql/math/matrixutilities/basisincompleteordered.hpp> // causes weird compile error
 #include <ql/math/matrixutilities/bicgstab.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 #include <ql/math/matrixutilities/factorreduction.hpp>
 #include <ql/math/matrixutilities/getcovariance.hpp>
 #include <ql/math/matrixutilities/gmres.hpp>
@@ -12,3 +13,4 @@
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <ql/math/matrixutilities/tapcorrelations.hpp>
 #include <ql/math/matrixutilities/tqreigendecomposition.hpp>
+#include <ql/math/matrixutilities/truncatedsvd.hpp>
@@ -26,7 +26,10 @@
 #define quantlib_bicgstab_hpp
 
 #include <ql/math/array.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 #include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
 
 namespace QuantLib {
 
@@ -42,6 +45,10 @@ namespace QuantLib {
         
         BiCGstab(const MatrixMult& A, Size maxIter, Real relTol,
                  const MatrixMult& preConditioner = MatrixMult());
+        /*! the matrix-vector products are performed in place on
+            the given CSR matrix, which is shared and not copied */
+        BiCGstab(const boost::shared_ptr<const CsrMatrix>& A, Size maxIter, Real relTol,
+                 const MatrixMult& preConditioner = MatrixMult());
         
         BiCGStabResult solve(const Array& b, const Array& x0 = Array()) const;
         
@@ -50,9 +57,13 @@ namespace QuantLib {
         QL_DEPRECATED
         Real norm2(const Array& a) const;
 
+        //! sets y = A x
+        void applyA(const Array& x, Array& y) const;
+
         const MatrixMult A_, M_;
         const Size maxIter_;
         const Real relTol_;  
+        boost::shared_ptr<const CsrMatrix> csrA_;
     };
 }
 
@@ -90,6 +101,24 @@ namespace QuantLib {
       maxIter_(maxIter), relTol_(relTol) {
     }
 
+  inline BiCGstab::BiCGstab(const boost::shared_ptr<const CsrMatrix>& A,
+                       Size maxIter, Real relTol,
+                       const BiCGstab::MatrixMult& preConditioner)
+    : M_(preConditioner),
+      maxIter_(maxIter), relTol_(relTol),
+      csrA_(A) {
+        QL_REQUIRE(A, "null CSR matrix");
+        QL_REQUIRE(A->rows() == A->columns(),
+                   "BiCGstab requires a square matrix");
+    }
+
+  inline void BiCGstab::applyA(const Array& x, Array& y) const {
+        if (csrA_)
+            prod(*csrA_, x, y);
+        else
+            y = A_(x);
+    }
+
   inline BiCGStabResult BiCGstab::solve(const Array& b, const Array& x0) const {
         Real bnorm2 = Norm2(b);
         if (bnorm2 == 0.0) {
@@ -97,11 +126,17 @@ namespace QuantLib {
             return result;
         }
 
-        Array x = ((!x0.empty()) ? x0 : Array(b.size(), 0.0));
-        Array r = b - A_(x);
+        const Size n = b.size();
+        Array x = ((!x0.empty()) ? x0 : Array(n, 0.0));
+        Array r(n);
+        applyA(x, r);
+        for (Size k=0; k<n; ++k)
+            r[k] = b[k] - r[k];
 
+        // work arrays, updated in place across the iterations; only
+        // the preconditioner, if any, returns new arrays
         Array rTld = r;
-        Array p, pTld, v, s, sTld, t;
+        Array p(n), pTld(n), v(n), s(n), sTld(n), t(n);
         Real omega = 1.0;
         Real rho, rhoTld=1.0;
         Real alpha = 0.0, beta;
@@ -115,28 +150,39 @@ namespace QuantLib {
 
            if (i) {
               beta = (rho/rhoTld)*(alpha/omega);
-              p = r + beta*(p - omega*v);
+              for (Size k=0; k<n; ++k)
+                  p[k] = r[k] + beta*(p[k] - omega*v[k]);
            }
            else {
-              p = r;
+              std::copy(r.begin(), r.end(), p.begin());
            }
 
-           pTld = ((M_)? M_(p) : p);
-           v     = A_(pTld);
+           if (M_)
+               pTld = M_(p);
+           else
+               std::copy(p.begin(), p.end(), pTld.begin());
+           applyA(pTld, v);
 
            alpha = rho/DotProduct(rTld, v);
-           s     = r-alpha*v;
+           for (Size k=0; k<n; ++k)
+               s[k] = r[k] - alpha*v[k];
            if (Norm2(s) < relTol_*bnorm2) {
-              x += alpha*pTld;
+              for (Size k=0; k<n; ++k)
+                  x[k] += alpha*pTld[k];
               error = Norm2(s)/bnorm2;
               break;
            }
 
-           sTld = ((M_) ? M_(s) : s);
-           t = A_(sTld);
+           if (M_)
+               sTld = M_(s);
+           else
+               std::copy(s.begin(), s.end(), sTld.begin());
+           applyA(sTld, t);
            omega = DotProduct(t,s)/DotProduct(t,t);
-           x += alpha*pTld + omega*sTld;
-           r = s - omega*t;
+           for (Size k=0; k<n; ++k) {
+               x[k] += alpha*pTld[k] + omega*sTld[k];
+               r[k] = s[k] - omega*t[k];
+           }
            error = Norm2(r)/bnorm2;
            rhoTld = rho;
         }
@@ -0,0 +1,227 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file csrmatrix.hpp
+    \brief sparse matrix in compressed sparse row format
+*/
+
+#ifndef quantlib_csr_matrix_hpp
+#define quantlib_csr_matrix_hpp
+
+#include <ql/math/matrix.hpp>
+#if !defined(QL_NO_UBLAS_SUPPORT)
+#include <ql/math/matrixutilities/sparsematrix.hpp>
+#endif
+#include <vector>
+
+namespace QuantLib {
+
+    //! sparse matrix in compressed sparse row (CSR) format
+    /*! The non-zero entries are stored row by row in contiguous
+        arrays, the column indices within each row being sorted in
+        increasing order. Unlike the ublas based SparseMatrix, the
+        layout is fixed at construction, which allows for a tight
+        matrix-vector product that does not allocate (see prod()).
+
+        If the library is compiled with OpenMP enabled, the rows of
+        large matrices are distributed among threads in the
+        matrix-vector product.
+
+        \test the matrix-vector product is checked against the ublas
+              and dense ones, and the matrix is used in the iterative
+              solvers.
+    */
+    class CsrMatrix {
+      public:
+        CsrMatrix();
+        /*! \pre rowOffsets has rows+1 non-decreasing entries starting
+                 at zero; the column indices of each row are sorted
+                 in increasing order.
+        */
+        CsrMatrix(Size rows, Size columns,
+                  const std::vector<Size>& rowOffsets,
+                  const std::vector<Size>& columnIndices,
+                  const std::vector<Real>& values);
+        //! stores the entries of m whose absolute value exceeds threshold
+        explicit CsrMatrix(const Matrix& m, Real threshold = 0.0);
+        #if !defined(QL_NO_UBLAS_SUPPORT)
+        explicit CsrMatrix(const SparseMatrix& m);
+        #endif
+        //! \name Inspectors
+        //@{
+        Size rows() const { return rows_; }
+        Size columns() const { return columns_; }
+        Size nonZeros() const { return values_.size(); }
+        const std::vector<Size>& rowOffsets() const { return rowOffsets_; }
+        const std::vector<Size>& columnIndices() const {
+            return columnIndices_;
+        }
+        const std::vector<Real>& values() const { return values_; }
+        //! element access; zero if the element is not stored
+        Real operator()(Size i, Size j) const;
+        //@}
+        #if !defined(QL_NO_UBLAS_SUPPORT)
+        //! copy to the ublas based sparse matrix
+        void toSparseMatrix(SparseMatrix& m) const;
+        #endif
+      private:
+        Size rows_, columns_;
+        std::vector<Size> rowOffsets_, columnIndices_;
+        std::vector<Real> values_;
+    };
+
+    /*! sets y = A x without allocating memory
+        \pre y.size() == A.rows(); x and y must be different arrays
+        \relates CsrMatrix
+    */
+    void prod(const CsrMatrix& A, const Array& x, Array& y);
+
+    /*! \relates CsrMatrix */
+    Disposable<Array> prod(const CsrMatrix& A, const Array& x);
+
+
+    // inline definitions
+
+    inline CsrMatrix::CsrMatrix()
+    : rows_(0), columns_(0), rowOffsets_(1, 0) {}
+
+    inline CsrMatrix::CsrMatrix(Size rows, Size columns,
+                                const std::vector<Size>& rowOffsets,
+                                const std::vector<Size>& columnIndices,
+                                const std::vector<Real>& values)
+    : rows_(rows), columns_(columns), rowOffsets_(rowOffsets),
+      columnIndices_(columnIndices), values_(values) {
+        QL_REQUIRE(rowOffsets_.size() == rows_+1,
+                   "row offsets size (" << rowOffsets_.size()
+                   << ") must be rows+1 (" << rows_+1 << ")");
+        QL_REQUIRE(rowOffsets_.front() == 0, "first row offset must be 0");
+        QL_REQUIRE(rowOffsets_.back() == values_.size(),
+                   "last row offset (" << rowOffsets_.back()
+                   << ") does not match the number of values ("
+                   << values_.size() << ")");
+        QL_REQUIRE(columnIndices_.size() == values_.size(),
+                   "number of column indices (" << columnIndices_.size()
+                   << ") does not match the number of values ("
+                   << values_.size() << ")");
+        for (Size i=0; i<rows_; ++i) {
+            QL_REQUIRE(rowOffsets_[i] <= rowOffsets_[i+1],
+                       "decreasing row offsets at row " << i);
+            for (Size k=rowOffsets_[i]; k<rowOffsets_[i+1]; ++k) {
+                QL_REQUIRE(columnIndices_[k] < columns_,
+                           "column index " << columnIndices_[k]
+                           << " out of range in row " << i);
+                QL_REQUIRE(k == rowOffsets_[i]
+                           || columnIndices_[k-1] < columnIndices_[k],
+                           "column indices not increasing in row " << i);
+            }
+        }
+    }
+
+    inline CsrMatrix::CsrMatrix(const Matrix& m, Real threshold)
+    : rows_(m.rows()), columns_(m.columns()), rowOffsets_(1, 0) {
+        rowOffsets_.reserve(rows_+1);
+        for (Size i=0; i<rows_; ++i) {
+            for (Size j=0; j<columns_; ++j) {
+                if (std::fabs(m[i][j]) > threshold) {
+                    columnIndices_.push_back(j);
+                    values_.push_back(m[i][j]);
+                }
+            }
+            rowOffsets_.push_back(values_.size());
+        }
+    }
+
+    #if !defined(QL_NO_UBLAS_SUPPORT)
+    inline CsrMatrix::CsrMatrix(const SparseMatrix& m)
+    : rows_(m.size1()), columns_(m.size2()), rowOffsets_(m.size1()+1, 0) {
+        columnIndices_.reserve(m.nnz());
+        values_.reserve(m.nnz());
+        for (SparseMatrix::const_iterator1 i1 = m.begin1();
+             i1 != m.end1(); ++i1) {
+            for (SparseMatrix::const_iterator2 i2 = i1.begin();
+                 i2 != i1.end(); ++i2) {
+                columnIndices_.push_back(i2.index2());
+                values_.push_back(*i2);
+                ++rowOffsets_[i2.index1()+1];
+            }
+        }
+        for (Size i=0; i<rows_; ++i)
+            rowOffsets_[i+1] += rowOffsets_[i];
+    }
+
+    inline void CsrMatrix::toSparseMatrix(SparseMatrix& m) const {
+        m = SparseMatrix(rows_, columns_, values_.size());
+        for (Size i=0; i<rows_; ++i)
+            for (Size k=rowOffsets_[i]; k<rowOffsets_[i+1]; ++k)
+                m.push_back(i, columnIndices_[k], values_[k]);
+    }
+    #endif
+
+    inline Real CsrMatrix::operator()(Size i, Size j) const {
+        QL_REQUIRE(i < rows_ && j < columns_,
+                   "element (" << i << "," << j << ") out of range");
+        std::vector<Size>::const_iterator begin =
+            columnIndices_.begin() + rowOffsets_[i];
+        std::vector<Size>::const_iterator end =
+            columnIndices_.begin() + rowOffsets_[i+1];
+        std::vector<Size>::const_iterator it =
+            std::lower_bound(begin, end, j);
+        return (it != end && *it == j)
+            ? values_[it - columnIndices_.begin()] : 0.0;
+    }
+
+    inline void prod(const CsrMatrix& A, const Array& x, Array& y) {
+        QL_REQUIRE(x.size() == A.columns(),
+                   "array size (" << x.size() << ") does not match the "
+                   "number of columns (" << A.columns() << ")");
+        QL_REQUIRE(y.size() == A.rows(),
+                   "result size (" << y.size() << ") does not match the "
+                   "number of rows (" << A.rows() << ")");
+        if (A.nonZeros() == 0) {
+            std::fill(y.begin(), y.end(), 0.0);
+            return;
+        }
+
+        // raw pointers keep the inner loop free of iterator
+        // overhead so that the compiler can vectorize it
+        const Size* const offsets = &A.rowOffsets()[0];
+        const Size* const columns = &A.columnIndices()[0];
+        const Real* const values = &A.values()[0];
+        const Real* const xp = x.begin();
+        Real* const yp = y.begin();
+        const long n = static_cast<long>(A.rows());
+
+        #if defined(_OPENMP)
+        #pragma omp parallel for schedule(static) if (A.nonZeros() > 100000)
+        #endif
+        for (long i=0; i<n; ++i) {
+            Real t = 0.0;
+            for (Size k=offsets[i]; k<offsets[i+1]; ++k)
+                t += values[k]*xp[columns[k]];
+            yp[i] = t;
+        }
+    }
+
+    inline Disposable<Array> prod(const CsrMatrix& A, const Array& x) {
+        Array y(A.rows());
+        prod(A, x, y);
+        return y;
+    }
+
+}
+
+#endif
@@ -25,7 +25,9 @@
 #define quantlib_gmres_hpp
 
 #include <ql/math/array.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 #include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <list>
 
@@ -57,6 +59,10 @@ namespace QuantLib {
 
         GMRES(const MatrixMult& A, Size maxIter, Real relTol,
                  const MatrixMult& preConditioner = MatrixMult());
+        /*! the matrix-vector products are performed in place on
+            the given CSR matrix, which is shared and not copied */
+        GMRES(const boost::shared_ptr<const CsrMatrix>& A, Size maxIter, Real relTol,
+                 const MatrixMult& preConditioner = MatrixMult());
 
         GMRESResult solve(const Array& b, const Array& x0 = Array()) const;
         GMRESResult solveWithRestart(
@@ -64,10 +70,13 @@ namespace QuantLib {
 
       protected:
         GMRESResult solveImpl(const Array& b, const Array& x0) const;
+        //! sets y = A x
+        void applyA(const Array& x, Array& y) const;
 
         const MatrixMult A_, M_;
         const Size maxIter_;
         const Real relTol_;
+        boost::shared_ptr<const CsrMatrix> csrA_;
     };
 
 }
@@ -113,6 +122,26 @@ namespace QuantLib {
         QL_REQUIRE(maxIter_ > 0, "maxIter must be greater then zero");
     }
 
+  inline GMRES::GMRES(const boost::shared_ptr<const CsrMatrix>& A,
+                 Size maxIter, Real relTol,
+                 const GMRES::MatrixMult& preConditioner)
+    : M_(preConditioner),
+      maxIter_(maxIter), relTol_(relTol),
+      csrA_(A) {
+
+        QL_REQUIRE(maxIter_ > 0, "maxIter must be greater then zero");
+        QL_REQUIRE(A, "null CSR matrix");
+        QL_REQUIRE(A->rows() == A->columns(),
+                   "GMRES requires a square matrix");
+    }
+
+  inline void GMRES::applyA(const Array& x, Array& y) const {
+        if (csrA_)
+            prod(*csrA_, x, y);
+        else
+            y = A_(x);
+    }
+
   inline GMRESResult GMRES::solve(const Array& b, const Array& x0) const {
         const GMRESResult result = solveImpl(b, x0);
 
@@ -148,7 +177,9 @@ namespace QuantLib {
         }
 
         Array x = ((!x0.empty()) ? x0 : Array(b.size(), 0.0));
-        Array r = b - A_(x);
+        Array r(b.size());
+        applyA(x, r);
+        r = b - r;
 
         const Real g = Norm2(r);
         if (g/bn < relTol_) {
@@ -164,13 +195,20 @@ namespace QuantLib {
 
         std::list<Real> errors(1, g/bn);
 
+        // work array for the products, reused across the iterations
+        Array w(b.size());
         for (Size j=0; j < maxIter_ && errors.back() >= relTol_; ++j) {
             h.push_back(Array(maxIter_, 0.0));
-            Array w = A_((M_)? M_(v[j]) : v[j]);
+            if (M_)
+                applyA(M_(v[j]), w);
+            else
+                applyA(v[j], w);
 
             for (Size i=0; i <= j; ++i) {
-                h[i][j] = DotProduct(w, v[i]);
-                w -= h[i][j] * v[i];
+                const Real hij = h[i][j] = DotProduct(w, v[i]);
+                const Array& vi = v[i];
+                for (Size k=0; k < w.size(); ++k)
+                    w[k] -= hij*vi[k];
             }
 
             h[j+1][j] = Norm2(w);
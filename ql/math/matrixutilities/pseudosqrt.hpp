@@ -27,6 +27,7 @@
 #include <ql/math/matrix.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
+#include <ql/math/matrixutilities/truncatedsvd.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/math/optimization/conjugategradient.hpp>
 #include <ql/math/optimization/problem.hpp>
@@ -39,6 +40,11 @@ namespace QuantLib {
         enum Type { None, Spectral, Hypersphere, LowerDiagonal, Higham };
     };
 
+    //! spectral decomposition used for rank-reduced pseudo square roots
+    struct RankReductionAlgorithm {
+        enum Type { FullSpectral, TruncatedSpectral };
+    };
+
     //! Returns the pseudo square root of a real symmetric matrix
     /*! Given a matrix \f$ M \f$, the result \f$ S \f$ is defined
         as the matrix such that \f$ S S^T = M. \f$
@@ -80,14 +86,25 @@ namespace QuantLib {
         approximation of the pseudo square root using a (user selected)
         salvaging algorithm.
 
+        With RankReductionAlgorithm::TruncatedSpectral and maxRank<size
+        only the maxRank dominant eigenpairs are computed (see
+        TruncatedEigenDecomposition), which reduces the cost from
+        \f$ O(n^3) \f$ to \f$ O(n^2 \cdot maxRank) \f$. In this case
+        the sum of the eigenvalues is taken as the trace of the matrix,
+        and the None and Spectral salvaging algorithms only act on the
+        retained eigenvalues.
+
         \pre the given matrix must be symmetric.
 
         \relates Matrix
     */
-    const Disposable<Matrix> rankReducedSqrt(const Matrix&,
-                                             Size maxRank,
-                                             Real componentRetainedPercentage,
-                                             SalvagingAlgorithm::Type);
+    const Disposable<Matrix> rankReducedSqrt(
+                    const Matrix&,
+                    Size maxRank,
+                    Real componentRetainedPercentage,
+                    SalvagingAlgorithm::Type,
+                    RankReductionAlgorithm::Type =
+                                        RankReductionAlgorithm::FullSpectral);
 
     // implementation
 
@@ -410,6 +427,77 @@ namespace QuantLib {
             return Y;
         }
 
+        // number of leading eigenvalues needed to retain the given
+        // percentage of the total
+        inline Size numberOfRetainedFactors(
+                                        const Array& eigenValues,
+                                        Real total,
+                                        Real componentRetainedPercentage) {
+            Real enough = componentRetainedPercentage * total;
+            if (componentRetainedPercentage == 1.0) {
+                // numerical glitches might cause some factors to be discarded
+                enough *= 1.1;
+            }
+            // retain at least one factor
+            Real components = eigenValues[0];
+            Size retained = 1;
+            for (Size i=1; components<enough && i<eigenValues.size(); ++i) {
+                components += eigenValues[i];
+                retained++;
+            }
+            return retained;
+        }
+
+        inline const Disposable<Matrix> truncatedRankReducedSqrt(
+                                        const Matrix& matrix,
+                                        Size maxRank,
+                                        Real componentRetainedPercentage,
+                                        SalvagingAlgorithm::Type sa) {
+            Size size = matrix.rows();
+            Matrix adjustedMatrix;
+            if (sa == SalvagingAlgorithm::Higham)
+                adjustedMatrix = highamImplementation(matrix, 40, 1e-6);
+            const Matrix& target =
+                (sa == SalvagingAlgorithm::Higham ? adjustedMatrix : matrix);
+
+            TruncatedEigenDecomposition ted(target, maxRank);
+            Array eigenValues = ted.eigenvalues();
+
+            // salvaging algorithm, restricted to the retained eigenvalues
+            switch (sa) {
+              case SalvagingAlgorithm::None:
+                QL_REQUIRE(eigenValues[maxRank-1]>=-1e-16,
+                           "negative eigenvalue(s) ("
+                           << std::scientific << eigenValues[maxRank-1]
+                           << ")");
+                break;
+              case SalvagingAlgorithm::Spectral:
+                for (Size i=0; i<maxRank; ++i)
+                    eigenValues[i] = std::max<Real>(eigenValues[i], 0.0);
+                break;
+              case SalvagingAlgorithm::Higham:
+                break;
+              default:
+                QL_FAIL("unknown or invalid salvaging algorithm");
+            }
+
+            Real trace = 0.0;
+            for (Size i=0; i<size; ++i)
+                trace += target[i][i];
+            Size retained = numberOfRetainedFactors(
+                                    eigenValues, trace,
+                                    componentRetainedPercentage);
+
+            Matrix result(size, retained);
+            for (Size i=0; i<size; ++i)
+                for (Size j=0; j<retained; ++j)
+                    result[i][j] = ted.eigenvectors()[i][j] *
+                                   std::sqrt(eigenValues[j]);
+
+            normalizePseudoRoot(matrix, result);
+            return result;
+        }
+
     }
 
 
@@ -494,10 +582,12 @@ namespace QuantLib {
     }
 
 
-    inline const Disposable<Matrix> rankReducedSqrt(const Matrix& matrix,
-                                             Size maxRank,
-                                             Real componentRetainedPercentage,
-                                             SalvagingAlgorithm::Type sa) {
+    inline const Disposable<Matrix> rankReducedSqrt(
+                                    const Matrix& matrix,
+                                    Size maxRank,
+                                    Real componentRetainedPercentage,
+                                    SalvagingAlgorithm::Type sa,
+                                    RankReductionAlgorithm::Type ra) {
         Size size = matrix.rows();
 
         #if defined(QL_EXTRA_SAFETY_CHECKS)
@@ -517,6 +607,10 @@ namespace QuantLib {
         QL_REQUIRE(maxRank>=1,
                    "max rank required < 1");
 
+        if (ra == RankReductionAlgorithm::TruncatedSpectral && maxRank < size)
+            return truncatedRankReducedSqrt(matrix, maxRank,
+                                            componentRetainedPercentage, sa);
+
         // spectral (a.k.a Principal Component) analysis
         SymmetricSchurDecomposition jd(matrix);
         Array eigenValues = jd.eigenvalues();
@@ -549,20 +643,11 @@ namespace QuantLib {
         }
 
         // factor reduction
-        Real enough = componentRetainedPercentage *
-                      std::accumulate(eigenValues.begin(),
-                                      eigenValues.end(), Real(0.0));
-        if (componentRetainedPercentage == 1.0) {
-            // numerical glitches might cause some factors to be discarded
-            enough *= 1.1;
-        }
-        // retain at least one factor
-        Real components = eigenValues[0];
-        Size retainedFactors = 1;
-        for (Size i=1; components<enough && i<size; ++i) {
-            components += eigenValues[i];
-            retainedFactors++;
-        }
+        Size retainedFactors = numberOfRetainedFactors(
+                    eigenValues,
+                    std::accumulate(eigenValues.begin(),
+                                    eigenValues.end(), Real(0.0)),
+                    componentRetainedPercentage);
         // output is granted to have a rank<=maxRank
         retainedFactors=std::min(retainedFactors, maxRank);
 
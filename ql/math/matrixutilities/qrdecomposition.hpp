@@ -26,6 +26,8 @@
 
 #include <ql/math/matrix.hpp>
 #include <ql/math/optimization/lmdif.hpp>
+#include <ql/utilities/null.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -75,6 +77,53 @@ namespace QuantLib {
                               bool pivot = true,
                               const Array& d = Array());
 
+    //! least squares solver based on QR with column pivoting
+    /*! The matrix is factorized once by MINPACK's qrfac; Q is kept
+        in factored form as the Householder vectors, so that each
+        solve costs \f$ O(mn) \f$ operations and allocates no memory.
+        Refactorizing a matrix of the same shape reuses the storage
+        of the previous factorization, which makes a single instance
+        suitable for regressions repeated over many dates.
+
+        Columns whose diagonal element in R falls below the given
+        tolerance (by default \f$ \max(m,n) \epsilon |r_{11}| \f$)
+        are dropped, i.e., for rank-deficient matrices the basic
+        solution with zeros in the dropped components is returned.
+
+        \test the solution is checked against qrSolve and the SVD
+              for full-rank and rank-deficient matrices.
+    */
+    class QRLeastSquares {
+      public:
+        QRLeastSquares();
+        explicit QRLeastSquares(const Matrix& A,
+                                Real tolerance = Null<Real>());
+        //! factorizes A, reusing the storage if possible
+        void factorize(const Matrix& A,
+                       Real tolerance = Null<Real>());
+        //! \name Inspectors
+        //@{
+        Size rows() const { return m_; }
+        Size columns() const { return n_; }
+        //! numerical rank of the factorized matrix
+        Size rank() const { return rank_; }
+        //@}
+        //! \name Solvers
+        //@{
+        //! returns the x minimizing |Ax-b|
+        Disposable<Array> solveFor(const Array& b) const;
+        /*! sets x to the solution without allocating memory; b is
+            overwritten by \f$ Q^T b \f$.
+        */
+        void solveFor(Array& b, Array& x) const;
+        //@}
+      private:
+        Size m_, n_, rank_;
+        // factors in MINPACK's column-major layout
+        std::vector<Real> qr_, rdiag_, acnorm_, wa_;
+        std::vector<int> ipvt_;
+    };
+
     // implementation
 
     inline Disposable<std::vector<Size> > qrDecomposition(const Matrix& M,
@@ -207,6 +256,88 @@ namespace QuantLib {
         return x;
     }
 
+    inline QRLeastSquares::QRLeastSquares() : m_(0), n_(0), rank_(0) {}
+
+    inline QRLeastSquares::QRLeastSquares(const Matrix& A, Real tolerance)
+    : m_(0), n_(0), rank_(0) {
+        factorize(A, tolerance);
+    }
+
+    inline void QRLeastSquares::factorize(const Matrix& A,
+                                          Real tolerance) {
+        m_ = A.rows();
+        n_ = A.columns();
+        QL_REQUIRE(m_ > 0 && n_ > 0, "empty matrix given");
+
+        // resize doesn't reallocate for matrices of the same shape
+        qr_.resize(m_*n_);
+        rdiag_.resize(n_);
+        acnorm_.resize(n_);
+        wa_.resize(n_);
+        ipvt_.resize(n_);
+
+        for (Size i=0; i<m_; ++i) {
+            const Real* row = A.row_begin(i);
+            for (Size j=0; j<n_; ++j)
+                qr_[i + m_*j] = row[j];
+        }
+
+        MINPACK::qrfac(m_, n_, &qr_[0], 0, 1, &ipvt_[0], n_,
+                       &rdiag_[0], &acnorm_[0], &wa_[0]);
+
+        const Real tol = (tolerance == Null<Real>())
+            ? std::max(m_, n_)*QL_EPSILON*std::fabs(rdiag_[0])
+            : tolerance;
+        const Size minmn = std::min(m_, n_);
+        rank_ = 0;
+        while (rank_ < minmn && std::fabs(rdiag_[rank_]) > tol)
+            ++rank_;
+    }
+
+    inline Disposable<Array> QRLeastSquares::solveFor(const Array& b) const {
+        Array qtb = b, x(n_);
+        solveFor(qtb, x);
+        return x;
+    }
+
+    inline void QRLeastSquares::solveFor(Array& b, Array& x) const {
+        QL_REQUIRE(m_ != 0, "no matrix factorized");
+        QL_REQUIRE(b.size() == m_,
+                   "rhs vector of size " << b.size() <<
+                   " instead of " << m_);
+        QL_REQUIRE(x.size() == n_,
+                   "result vector of size " << x.size() <<
+                   " instead of " << n_);
+
+        // apply the Householder transformations I - u u^T/u_j
+        const Size minmn = std::min(m_, n_);
+        for (Size j=0; j<minmn; ++j) {
+            const Real* u = &qr_[m_*j];
+            if (u[j] == 0.0)
+                continue;
+            Real sum = 0.0;
+            for (Size i=j; i<m_; ++i)
+                sum += u[i]*b[i];
+            const Real t = sum/u[j];
+            for (Size i=j; i<m_; ++i)
+                b[i] -= t*u[i];
+        }
+
+        // back substitution on the leading rank x rank block of R,
+        // the result being stored in the leading components of b
+        for (Size k=rank_; k>0; --k) {
+            const Size j = k-1;
+            Real sum = b[j];
+            for (Size l=j+1; l<rank_; ++l)
+                sum -= qr_[j + m_*l]*b[l];
+            b[j] = sum/rdiag_[j];
+        }
+
+        std::fill(x.begin(), x.end(), 0.0);
+        for (Size j=0; j<rank_; ++j)
+            x[ipvt_[j]] = b[j];
+    }
+
 }
 
 #endif
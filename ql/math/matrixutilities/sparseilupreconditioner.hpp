@@ -30,6 +30,7 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 
 #include <ql/math/array.hpp>
 #include <ql/math/matrixutilities/sparsematrix.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
 
 namespace QuantLib {
 
@@ -40,18 +41,26 @@ namespace QuantLib {
     class SparseILUPreconditioner  {
       public:
         SparseILUPreconditioner(const SparseMatrix& A, Integer lfil = 1);
+        SparseILUPreconditioner(const CsrMatrix& A, Integer lfil = 1);
 
         const SparseMatrix& L() const;
         const SparseMatrix& U() const;
 
         Disposable<Array> apply(const Array& b) const;
+        /*! sets x = (LU)^{-1} b without allocating memory
+            \pre x.size() == b.size(); x and b must be different arrays
+        */
+        void apply(const Array& b, Array& x) const;
 
       private:
         SparseMatrix L_, U_;
-        std::vector<Size> lBands_, uBands_;
+        CsrMatrix csrL_, csrU_;
 
+        void initialize(const SparseMatrix& A, Integer lfil);
         Disposable<Array> forwardSolve(const Array& b) const;
         Disposable<Array> backwardSolve(const Array& y) const;
+        void forwardSolveInPlace(Array& y) const;
+        void backwardSolveInPlace(Array& x) const;
     };
 
 }
@@ -95,6 +104,20 @@ namespace QuantLib {
                                                      Integer lfil)
     : L_(A.size1(),A.size2()),
       U_(A.size1(),A.size2()) {
+        initialize(A, lfil);
+    }
+
+  inline SparseILUPreconditioner::SparseILUPreconditioner(const CsrMatrix& A,
+                                                     Integer lfil)
+    : L_(A.rows(),A.columns()),
+      U_(A.rows(),A.columns()) {
+        SparseMatrix a;
+        A.toSparseMatrix(a);
+        initialize(a, lfil);
+    }
+
+  inline void SparseILUPreconditioner::initialize(const SparseMatrix& A,
+                                                  Integer lfil) {
 
         QL_REQUIRE(A.size1() == A.size2(),
                    "sparse ILU preconditioner works only with square matrices");
@@ -103,7 +126,7 @@ namespace QuantLib {
             L_(i,i) = 1.0;
 
         const Integer n = A.size1();
-        std::set<Integer> lBandSet, uBandSet;
+        std::set<Integer> uBandSet;
 
         compressed_matrix<Integer> levs(n,n);
         Integer lfilp = lfil + 1;
@@ -194,7 +217,6 @@ namespace QuantLib {
                 Integer j = wNonZeros[k];
                 if (j < ii) {
                     L_(ii,j) = wNonZeroEntries[k];
-                    lBandSet.insert(ii-j);
                 }
                 else {
                     U_(ii,j) = wNonZeroEntries[k];
@@ -205,10 +227,9 @@ namespace QuantLib {
                 }
             }
         }
-        lBands_.resize(lBandSet.size());
-        uBands_.resize(uBandSet.size());
-        std::copy(lBandSet.begin(), lBandSet.end(), lBands_.begin());
-        std::copy(uBandSet.begin(), uBandSet.end(), uBands_.begin());
+        // row-wise copies for fast triangular solves
+        csrL_ = CsrMatrix(L_);
+        csrU_ = CsrMatrix(U_);
     }
 
   inline const SparseMatrix& SparseILUPreconditioner::L() const {
@@ -220,40 +241,68 @@ namespace QuantLib {
     }
 
   inline Disposable<Array> SparseILUPreconditioner::apply(const Array& b) const {
-        return backwardSolve(forwardSolve(b));
+        Array x(b.size());
+        apply(b, x);
+        return x;
+    }
+
+  inline void SparseILUPreconditioner::apply(const Array& b, Array& x) const {
+        QL_REQUIRE(b.size() == csrL_.rows() && x.size() == b.size(),
+                   "array sizes (" << b.size() << ", " << x.size()
+                   << ") do not match the preconditioner size ("
+                   << csrL_.rows() << ")");
+        std::copy(b.begin(), b.end(), x.begin());
+        forwardSolveInPlace(x);
+        backwardSolveInPlace(x);
     }
 
   inline Disposable<Array> SparseILUPreconditioner::forwardSolve(
                                                        const Array& b) const {
-        Integer n = b.size();
-        Array y(n, 0.0);
-        y[0]=b[0]/L_(0,0);
-        for (Integer i=1; i<=n-1; ++i) {
-            y[i] = b[i]/L_(i,i);
-            for (Integer j=lBands_.size()-1;
-                 j>=0 && i-Integer(lBands_[j]) <= i-1; --j) {
-                const Integer k = i-Integer(lBands_[j]);
-                if (k >= 0)
-                    y[i]-=L_(i,k)*y[k]/L_(i,i);
-            }
-        }
+        Array y(b);
+        forwardSolveInPlace(y);
         return y;
     }
 
   inline Disposable<Array> SparseILUPreconditioner::backwardSolve(
                                                        const Array& y) const {
-        Size n = y.size();
-        Array x(n, 0.0);
-        x[n-1] = y[n-1]/U_(n-1,n-1);
-        for (Integer i=n-2; i>=0; --i) {
-            x[i] = y[i]/U_(i,i);
-            for (Size j=0; j<uBands_.size() && i+uBands_[j] <= n-1; ++j) {
-                x[i] -= U_(i,i+uBands_[j])*x[i+uBands_[j]]/U_(i,i);
-            }
-        }
+        Array x(y);
+        backwardSolveInPlace(x);
         return x;
     }
 
+  inline void SparseILUPreconditioner::forwardSolveInPlace(Array& y) const {
+        // L is lower triangular, the last entry of each row being
+        // the diagonal
+        const std::vector<Size>& offsets = csrL_.rowOffsets();
+        const std::vector<Size>& columns = csrL_.columnIndices();
+        const std::vector<Real>& values  = csrL_.values();
+        const Size n = y.size();
+        for (Size i=0; i<n; ++i) {
+            const Size diag = offsets[i+1]-1;
+            Real t = y[i];
+            for (Size k=offsets[i]; k<diag; ++k)
+                t -= values[k]*y[columns[k]];
+            y[i] = t/values[diag];
+        }
+    }
+
+  inline void SparseILUPreconditioner::backwardSolveInPlace(Array& x) const {
+        // U is upper triangular, the first entry of each row being
+        // the diagonal
+        const std::vector<Size>& offsets = csrU_.rowOffsets();
+        const std::vector<Size>& columns = csrU_.columnIndices();
+        const std::vector<Real>& values  = csrU_.values();
+        for (Size i=x.size(); i-- > 0;) {
+            const Size diag = offsets[i];
+            QL_REQUIRE(diag < offsets[i+1] && columns[diag] == i,
+                       "zero pivot in row " << i);
+            Real t = x[i];
+            for (Size k=diag+1; k<offsets[i+1]; ++k)
+                t -= values[k]*x[columns[k]];
+            x[i] = t/values[diag];
+        }
+    }
+
 }
 
 #endif
@@ -0,0 +1,339 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file truncatedsvd.hpp
+    \brief truncated singular value and symmetric eigen decompositions
+*/
+
+#ifndef quantlib_math_truncated_svd_hpp
+#define quantlib_math_truncated_svd_hpp
+
+#include <ql/math/matrixutilities/svd.hpp>
+#include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+namespace QuantLib {
+
+    //! truncated eigen decomposition of a real symmetric matrix
+    /*! Returns the k dominant eigenvalues (sorted in decreasing
+        order) and the corresponding eigenvectors of a real symmetric
+        \f$ n \times n \f$ matrix without computing the full
+        decomposition.
+
+        The dominant subspace is found by a randomized range finder
+        refined by subspace (power) iteration; the eigenpairs are
+        extracted at each step by a Rayleigh-Ritz projection on a
+        \f$ (k+p) \times (k+p) \f$ matrix, \f$ p \f$ being the
+        oversampling. The iteration stops when the residuals
+        \f$ \| S v_i - \lambda_i v_i \| \f$ of all the k Ritz pairs
+        are below the given tolerance times the largest eigenvalue.
+        Each step costs \f$ O(n^2 (k+p)) \f$ instead of the
+        \f$ O(n^3) \f$ of a full decomposition.
+
+        See N. Halko, P. G. Martinsson, J. A. Tropp, "Finding
+        structure with randomness: probabilistic algorithms for
+        constructing approximate matrix decompositions", SIAM Review
+        53(2), 2011.
+
+        The random test matrix is generated from the given seed, so
+        that the results are reproducible.
+
+        \pre s must be symmetric
+
+        \warning dominance is measured on the absolute value of the
+                 eigenvalues; the decomposition is meant for positive
+                 semi-definite (e.g. covariance or correlation)
+                 matrices.
+
+        \test the eigenpairs are checked against the full symmetric
+              Schur decomposition.
+    */
+    class TruncatedEigenDecomposition {
+      public:
+        TruncatedEigenDecomposition(const Matrix& s,
+                                    Size k,
+                                    Real tolerance = 1.0e-10,
+                                    Size maxIterations = 100,
+                                    Size oversampling = 10,
+                                    unsigned long seed = 42);
+        const Array& eigenvalues() const { return diagonal_; }
+        //! the \f$ n \times k \f$ matrix of the eigenvectors
+        const Matrix& eigenvectors() const { return eigenVectors_; }
+        Size iterations() const { return iterations_; }
+      private:
+        Array diagonal_;
+        Matrix eigenVectors_;
+        Size iterations_;
+    };
+
+    //! truncated singular value decomposition
+    /*! Returns the k largest singular values of a real
+        \f$ m \times n \f$ matrix together with the corresponding
+        left and right singular vectors, using the same randomized
+        subspace iteration as TruncatedEigenDecomposition; here the
+        residuals are \f$ \| M v_i - \sigma_i u_i \| \f$. Each
+        step costs \f$ O(mn(k+p)) \f$.
+
+        \test the singular values are checked against the full SVD.
+    */
+    class TruncatedSVD {
+      public:
+        TruncatedSVD(const Matrix& M,
+                     Size k,
+                     Real tolerance = 1.0e-10,
+                     Size maxIterations = 100,
+                     Size oversampling = 10,
+                     unsigned long seed = 42);
+        //! the \f$ m \times k \f$ matrix of left singular vectors
+        const Matrix& U() const { return U_; }
+        //! the \f$ n \times k \f$ matrix of right singular vectors
+        const Matrix& V() const { return V_; }
+        const Array& singularValues() const { return s_; }
+        Disposable<Matrix> S() const;
+        Size iterations() const { return iterations_; }
+      private:
+        Matrix U_, V_;
+        Array s_;
+        Size iterations_;
+    };
+
+    // implementation
+
+    namespace detail {
+
+        inline void fillWithGaussianDraws(Matrix::row_iterator begin,
+                                          Matrix::row_iterator end,
+                                          MersenneTwisterUniformRng& rng) {
+            for (; begin != end; ++begin)
+                *begin =
+                    InverseCumulativeNormal::standard_value(rng.nextReal());
+        }
+
+        /* Orthonormalizes the rows of q in place by modified
+           Gram-Schmidt with one reorthogonalization pass. Rows
+           becoming numerically dependent on the previous ones are
+           replaced by random directions, so that q always has full
+           row rank; this is what happens when the input matrix has a
+           rank lower than the sampled subspace. */
+        inline void orthonormalizeRows(Matrix& q,
+                                       MersenneTwisterUniformRng& rng) {
+            const Size l = q.rows();
+            const Real tolerance = 1.0e-10;
+            for (Size i=0; i<l; ++i) {
+                Real initialNorm = std::sqrt(
+                    std::inner_product(q.row_begin(i), q.row_end(i),
+                                       q.row_begin(i), Real(0.0)));
+                Size redraws = 0;
+                for (;;) {
+                    for (Size pass=0; pass<2; ++pass) {
+                        for (Size j=0; j<i; ++j) {
+                            Real d = std::inner_product(q.row_begin(i),
+                                                        q.row_end(i),
+                                                        q.row_begin(j),
+                                                        Real(0.0));
+                            Matrix::const_row_iterator qj = q.row_begin(j);
+                            for (Matrix::row_iterator qi = q.row_begin(i);
+                                 qi != q.row_end(i); ++qi, ++qj)
+                                *qi -= d * (*qj);
+                        }
+                    }
+                    Real norm = std::sqrt(
+                        std::inner_product(q.row_begin(i), q.row_end(i),
+                                           q.row_begin(i), Real(0.0)));
+                    if (norm > tolerance*initialNorm) {
+                        for (Matrix::row_iterator qi = q.row_begin(i);
+                             qi != q.row_end(i); ++qi)
+                            *qi /= norm;
+                        break;
+                    }
+                    QL_REQUIRE(++redraws <= 10,
+                               "unable to complete the orthonormal basis");
+                    fillWithGaussianDraws(q.row_begin(i), q.row_end(i),
+                                          rng);
+                    initialNorm = std::sqrt(
+                        std::inner_product(q.row_begin(i), q.row_end(i),
+                                           q.row_begin(i), Real(0.0)));
+                }
+            }
+        }
+
+    }
+
+    inline TruncatedEigenDecomposition::TruncatedEigenDecomposition(
+                                                    const Matrix& s,
+                                                    Size k,
+                                                    Real tolerance,
+                                                    Size maxIterations,
+                                                    Size oversampling,
+                                                    unsigned long seed)
+    : iterations_(0) {
+        const Size n = s.rows();
+        QL_REQUIRE(n > 0, "null matrix given");
+        QL_REQUIRE(n == s.columns(), "input matrix must be square");
+        QL_REQUIRE(k > 0 && k <= n,
+                   "number of eigenpairs (" << k << ") must be in [1, "
+                   << n << "]");
+        QL_REQUIRE(maxIterations > 0, "at least one iteration required");
+
+        const Size l = std::min(k + oversampling, n);
+        MersenneTwisterUniformRng rng(seed);
+
+        // the rows of qt form an orthonormal basis of the sampled
+        // subspace; as s is symmetric, qt * s is the transpose of
+        // s * transpose(qt)
+        Matrix qt(l, n);
+        for (Size i=0; i<l; ++i)
+            detail::fillWithGaussianDraws(qt.row_begin(i), qt.row_end(i),
+                                          rng);
+        qt = qt * s;
+        detail::orthonormalizeRows(qt, rng);
+
+        Array residual(n);
+        for (;;) {
+            ++iterations_;
+            Matrix z = qt * s;
+
+            // Rayleigh-Ritz projection
+            Matrix b = z * transpose(qt);
+            for (Size i=0; i<l; ++i)
+                for (Size j=0; j<i; ++j)
+                    b[i][j] = b[j][i] = 0.5*(b[i][j] + b[j][i]);
+            SymmetricSchurDecomposition jd(b);
+            const Array& lambda = jd.eigenvalues();
+            const Matrix& w = jd.eigenvectors();
+
+            // the residual of the j-th Ritz pair is (z - lambda_j qt)^T w_j
+            Real maxResidual = 0.0;
+            for (Size j=0; j<k; ++j) {
+                std::fill(residual.begin(), residual.end(), 0.0);
+                for (Size r=0; r<l; ++r) {
+                    const Real wr = w[r][j];
+                    for (Size i=0; i<n; ++i)
+                        residual[i] += (z[r][i] - lambda[j]*qt[r][i]) * wr;
+                }
+                maxResidual = std::max(maxResidual, Norm2(residual));
+            }
+
+            if (maxResidual <= tolerance * std::fabs(lambda[0]) ||
+                iterations_ >= maxIterations) {
+                diagonal_ = Array(lambda.begin(), lambda.begin() + k);
+                eigenVectors_ = Matrix(n, k, 0.0);
+                for (Size r=0; r<l; ++r) {
+                    for (Size i=0; i<n; ++i) {
+                        const Real q = qt[r][i];
+                        for (Size j=0; j<k; ++j)
+                            eigenVectors_[i][j] += q * w[r][j];
+                    }
+                }
+                break;
+            }
+
+            qt.swap(z);
+            detail::orthonormalizeRows(qt, rng);
+        }
+    }
+
+    inline TruncatedSVD::TruncatedSVD(const Matrix& M,
+                                      Size k,
+                                      Real tolerance,
+                                      Size maxIterations,
+                                      Size oversampling,
+                                      unsigned long seed)
+    : iterations_(0) {
+        const Size m = M.rows(), n = M.columns();
+        QL_REQUIRE(m > 0 && n > 0, "null matrix given");
+        QL_REQUIRE(k > 0 && k <= std::min(m, n),
+                   "number of singular values (" << k << ") must be in "
+                   "[1, " << std::min(m, n) << "]");
+        QL_REQUIRE(maxIterations > 0, "at least one iteration required");
+
+        const Size l = std::min(k + oversampling, std::min(m, n));
+        MersenneTwisterUniformRng rng(seed);
+        const Matrix Mt = transpose(M);
+
+        // the rows of qt form an orthonormal basis of the sampled
+        // subspace of the range of M
+        Matrix omega(l, n);
+        for (Size i=0; i<l; ++i)
+            detail::fillWithGaussianDraws(omega.row_begin(i),
+                                          omega.row_end(i), rng);
+        Matrix qt = omega * Mt;
+        detail::orthonormalizeRows(qt, rng);
+
+        Array residual(m);
+        for (;;) {
+            ++iterations_;
+
+            // M ~ Q B with B = Q^T M; the SVD of the small l x n
+            // matrix B gives the Ritz triplets of M
+            Matrix b = qt * M;
+            SVD svd(b);
+            const Array& sigma = svd.singularValues();
+            const Matrix& ub = svd.U();
+            const Matrix& vb = svd.V();
+
+            // residual of the j-th triplet is M v_j - sigma_j Q u_j
+            Real maxResidual = 0.0;
+            for (Size j=0; j<k; ++j) {
+                for (Size i=0; i<m; ++i) {
+                    Real mv = 0.0;
+                    for (Size c=0; c<n; ++c)
+                        mv += M[i][c] * vb[c][j];
+                    Real qu = 0.0;
+                    for (Size r=0; r<l; ++r)
+                        qu += qt[r][i] * ub[r][j];
+                    residual[i] = mv - sigma[j]*qu;
+                }
+                maxResidual = std::max(maxResidual, Norm2(residual));
+            }
+
+            if (maxResidual <= tolerance * sigma[0] ||
+                iterations_ >= maxIterations) {
+                s_ = Array(sigma.begin(), sigma.begin() + k);
+                U_ = Matrix(m, k, 0.0);
+                for (Size r=0; r<l; ++r) {
+                    for (Size i=0; i<m; ++i) {
+                        const Real q = qt[r][i];
+                        for (Size j=0; j<k; ++j)
+                            U_[i][j] += q * ub[r][j];
+                    }
+                }
+                V_ = Matrix(n, k);
+                for (Size i=0; i<n; ++i)
+                    std::copy(vb.row_begin(i), vb.row_begin(i) + k,
+                              V_.row_begin(i));
+                break;
+            }
+
+            // one step of subspace iteration on M M^T
+            detail::orthonormalizeRows(b, rng);
+            qt = b * Mt;
+            detail::orthonormalizeRows(qt, rng);
+        }
+    }
+
+    inline Disposable<Matrix> TruncatedSVD::S() const {
+        Matrix S(s_.size(), s_.size(), 0.0);
+        for (Size i=0; i<s_.size(); ++i)
+            S[i][i] = s_[i];
+        return S;
+    }
+
+}
+
+#endif
@@ -12,6 +12,7 @@
 #include <ql/math/optimization/linesearchbasedmethod.hpp>
 #include <ql/math/optimization/lmdif.hpp>
 #include <ql/math/optimization/method.hpp>
+#include <ql/math/optimization/multistart.hpp>
 #include <ql/math/optimization/problem.hpp>
 #include <ql/math/optimization/projectedconstraint.hpp>
 #include <ql/math/optimization/projectedcostfunction.hpp>
@@ -27,6 +27,7 @@
 
 #include <ql/math/array.hpp>
 #include <ql/math/matrix.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -39,6 +40,28 @@ namespace QuantLib {
         //! method to overload to compute the cost function values in x
         virtual Disposable<Array> values(const Array& x) const =0;
 
+        //! method to overload to compute the cost function values in x
+        /*! The values are written into the given array, which is
+            resized if needed; the default implementation copies the
+            result of values().  Cost functions evaluated in tight
+            loops can override it to avoid allocating memory.
+        */
+        virtual void fillValues(Array& values, const Array& x) const {
+            values = this->values(x);
+        }
+
+        //! method to overload to compute the cost function value at several points
+        /*! The i-th element of the result is the value in x[i]; the
+            default implementation calls value() on each point in turn.
+        */
+        virtual Disposable<Array> valueBatch(
+                                     const std::vector<Array>& x) const {
+            Array result(x.size());
+            for (Size i=0; i<x.size(); ++i)
+                result[i] = value(x[i]);
+            return result;
+        }
+
         //! method to overload to compute grad_f, the first derivative of
         //  the cost function with respect to x
         virtual void gradient(Array& grad, const Array& x) const {
@@ -87,6 +110,14 @@ namespace QuantLib {
             return values(x);
         }
 
+        //! whether jacobian() is computed analytically
+        /*! Cost functions overriding jacobian() and valuesAndJacobian()
+            with an analytic implementation should return true, so that
+            proxies such as ProjectedCostFunction forward to it instead
+            of using finite differences on their own parameters.
+        */
+        virtual bool hasAnalyticJacobian() const { return false; }
+
         //! Default epsilon for finite difference method :
         virtual Real finiteDifferenceEpsilon() const { return 1e-8; }
     };
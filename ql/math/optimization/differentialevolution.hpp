@@ -28,6 +28,8 @@
 #include <ql/math/optimization/constraint.hpp>
 #include <ql/math/optimization/problem.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <algorithm>
+#include <string>
 
 namespace QuantLib {
 
@@ -50,6 +52,13 @@ namespace QuantLib {
         3) various weights distributions for the differences (dither etc.)
         4) printFullInfo parameter usage to track the algorithm
 
+        The cost function is evaluated on the whole population at
+        once in each generation: member by member (the default), in
+        parallel, or through CostFunction::valueBatch().  All the
+        random numbers are drawn on the calling thread before the
+        evaluation, so that the result does not depend on the
+        evaluation mode or on the number of threads.
+
         \warning This was reported to fail tests on Mac OS X 10.8.4.
     */
 
@@ -72,6 +81,17 @@ namespace QuantLib {
             Binomial,
             Exponential
         };
+        /*! Parallel evaluation distributes the members among
+            threads if the library is compiled with OpenMP enabled,
+            and requires a cost function that can be called
+            concurrently; it falls back to sequential evaluation
+            otherwise.
+        */
+        enum Evaluation {
+            Sequential,
+            Parallel,
+            Batch
+        };
 
         struct Candidate {
             Array values;
@@ -83,6 +103,7 @@ namespace QuantLib {
           public:
             Strategy strategy;
             CrossoverType crossoverType;
+            Evaluation evaluation;
             Size populationMembers;
             Real stepsizeWeight, crossoverProbability;
             unsigned long seed;
@@ -91,6 +112,7 @@ namespace QuantLib {
             Configuration()
             : strategy(BestMemberWithJitter),
               crossoverType(Normal),
+              evaluation(Sequential),
               populationMembers(100),
               stepsizeWeight(0.2),
               crossoverProbability(0.9),
@@ -144,6 +166,11 @@ namespace QuantLib {
                 strategy = s;
                 return *this;
             }
+
+            Configuration& withEvaluation(Evaluation e) {
+                evaluation = e;
+                return *this;
+            }
         };
 
 
@@ -188,6 +215,17 @@ namespace QuantLib {
                        const std::vector<Candidate>& mutantPopulation,
                        const std::vector<Candidate>& mirrorPopulation,
                        const CostFunction& costFunction) const;
+
+        /* sets the cost of each member; if failedAsMax is true,
+           members whose evaluation raises an Error get QL_MAX_REAL,
+           otherwise the error is propagated. */
+        void evaluate(std::vector<Candidate>& population,
+                      const CostFunction& costFunction,
+                      bool failedAsMax) const;
+
+        Real memberCost(const Array& values,
+                        const CostFunction& costFunction,
+                        bool failedAsMax) const;
     };
 
 }
@@ -452,12 +490,85 @@ namespace QuantLib {
                                - lowerBound_[memIter]);
                 }
             }
-            // evaluate objective function as soon as possible to avoid unnecessary loops
-            try {
-                population[popIter].cost = costFunction.value(population[popIter].values);
-            } catch (Error&) {
-                population[popIter].cost = QL_MAX_REAL;
-            }
+        }
+        evaluate(population, costFunction, true);
+    }
+
+    inline void DifferentialEvolution::evaluate(
+                                     std::vector<Candidate>& population,
+                                     const CostFunction& costFunction,
+                                     bool failedAsMax) const {
+        const Size n = population.size();
+        switch (configuration().evaluation) {
+          case Sequential:
+            for (Size popIter = 0; popIter < n; popIter++)
+                population[popIter].cost =
+                    memberCost(population[popIter].values, costFunction,
+                               failedAsMax);
+            break;
+          case Parallel: {
+              // exceptions must not leave the parallel region
+              std::vector<std::string> errors(n);
+              const long members = static_cast<long>(n);
+              #if defined(_OPENMP)
+              #pragma omp parallel for schedule(dynamic)
+              #endif
+              for (long popIter = 0; popIter < members; popIter++) {
+                  try {
+                      population[popIter].cost =
+                          memberCost(population[popIter].values,
+                                     costFunction, failedAsMax);
+                  } catch (std::exception& e) {
+                      errors[popIter] = e.what();
+                  } catch (...) {
+                      errors[popIter] = "unknown error";
+                  }
+              }
+              for (Size popIter = 0; popIter < n; popIter++)
+                  QL_REQUIRE(errors[popIter].empty(),
+                             "could not evaluate population member "
+                             << popIter << ": " << errors[popIter]);
+          }
+            break;
+          case Batch: {
+              std::vector<Array> values(n);
+              for (Size popIter = 0; popIter < n; popIter++)
+                  values[popIter] = population[popIter].values;
+              Array costs;
+              try {
+                  costs = costFunction.valueBatch(values);
+              } catch (Error&) {
+                  if (!failedAsMax)
+                      throw;
+                  // find out which members failed
+                  for (Size popIter = 0; popIter < n; popIter++)
+                      population[popIter].cost =
+                          memberCost(values[popIter], costFunction, true);
+                  break;
+              }
+              QL_REQUIRE(costs.size() == n,
+                         "wrong number of costs (" << costs.size()
+                         << ") returned for " << n << " members");
+              for (Size popIter = 0; popIter < n; popIter++)
+                  population[popIter].cost = costs[popIter];
+          }
+            break;
+          default:
+            QL_FAIL("Unknown evaluation ("
+                    << Integer(configuration().evaluation) << ")");
+        }
+    }
+
+    inline Real DifferentialEvolution::memberCost(
+                                     const Array& values,
+                                     const CostFunction& costFunction,
+                                     bool failedAsMax) const {
+        if (!failedAsMax)
+            return costFunction.value(values);
+        try {
+            return costFunction.value(values);
+        } catch (Error&) {
+            return QL_MAX_REAL;
         }
     }
 
@@ -537,15 +648,14 @@ namespace QuantLib {
 
         // use initial values provided by the user
         population.front().values = p.currentValue();
-        population.front().cost = p.costFunction().value(population.front().values);
         // rest of the initial population is random
         for (Size j = 1; j < population.size(); ++j) {
             for (Size i = 0; i < p.currentValue().size(); ++i) {
                 Real l = lowerBound_[i], u = upperBound_[i];
                 population[j].values[i] = l + (u-l)*rng_.nextReal();
             }
-            population[j].cost = p.costFunction().value(population[j].values);
         }
+        evaluate(population, p.costFunction(), false);
     }
 
 }
@@ -30,6 +30,10 @@
 #include <ql/math/optimization/constraint.hpp>
 #include <ql/math/optimization/lmdif.hpp>
 #include <ql/math/optimization/levenbergmarquardt.hpp>
+#include <ql/patterns/singleton.hpp>
+#if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+#include <boost/thread/mutex.hpp>
+#endif
 #if defined(__GNUC__) && (((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8)) || (__GNUC__ > 4))
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
@@ -54,7 +58,27 @@ namespace QuantLib {
         in CostFunction uses a central difference
         (oder 2, but requiring more function
         evaluations) compared to the forward
-        difference implemented here (order 1).
+        difference implemented here (order 1);
+        cost functions providing an analytic
+        jacobian should override it and set
+        useCostFunctionsJacobian.
+
+        The state of a minimization is local to
+        the call of minimize(), so that the same
+        instance can be used by several
+        minimizations at the same time, either
+        nested or on different threads. In that
+        case, getInfo() returns the MINPACK info
+        of whichever minimization ended last;
+        the overload of minimize() taking an
+        info argument returns the info of each
+        call instead. The function values and
+        the jacobian are passed to MINPACK
+        through workspaces allocated once per
+        minimization; the values are obtained
+        through CostFunction::fillValues(), which
+        cost functions can override to avoid
+        allocating memory at each evaluation.
 
         \ingroup optimizers
     */
@@ -68,27 +92,48 @@ namespace QuantLib {
                                            const EndCriteria& endCriteria //= EndCriteria()
                                            );
                                            //      = EndCriteria(400, 1.0e-8, 1.0e-8)
+        //! minimize P and return the MINPACK info of this call in info
+        EndCriteria::Type minimize(Problem& P,
+                                   const EndCriteria& endCriteria,
+                                   Integer& info);
         virtual Integer getInfo() const;
-        void fcn(int m,
-                 int n,
-                 Real* x,
-                 Real* fvec,
-                 int* iflag);
-        void jacFcn(int m,
-                 int n,
-                 Real* x,
-                 Real* fjac,
-                 int* iflag);
+
+        #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+        LevenbergMarquardt(const LevenbergMarquardt&);
+        #endif
 
       private:
-        Problem* currentProblem_;
-        Array initCostValues_;
-        Matrix initJacobian_;
-        mutable Integer info_;
+        void setInfo(Integer info);
+        Integer info_;
+        #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+        mutable boost::mutex mutex_;
+        #endif
         const Real epsfcn_, xtol_, gtol_;
         bool useCostFunctionsJacobian_;
     };
 
+    namespace detail {
+
+        /* the cost function of a problem and its jacobian in the
+           form required by MINPACK::lmdif */
+        class LevenbergMarquardtFunction {
+          public:
+            LevenbergMarquardtFunction(Problem& P,
+                                       const Array& initCostValues,
+                                       const Matrix& initJacobian);
+            void fcn(int m, int n, Real* x, Real* fvec, int* iflag);
+            void jacFcn(int m, int n, Real* x, Real* fjac, int* iflag);
+          private:
+            Problem& problem_;
+            const Array& initCostValues_;
+            const Matrix& initJacobian_;
+            // workspaces
+            Array x_, values_;
+            Matrix jacobian_;
+        };
+
+    }
+
     // implementation
 
     inline LevenbergMarquardt::LevenbergMarquardt(Real epsfcn,
@@ -98,22 +143,58 @@ namespace QuantLib {
         : info_(0), epsfcn_(epsfcn), xtol_(xtol), gtol_(gtol),
           useCostFunctionsJacobian_(useCostFunctionsJacobian) {}
 
+    #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+    inline LevenbergMarquardt::LevenbergMarquardt(
+                                             const LevenbergMarquardt& other)
+    : OptimizationMethod(other), info_(other.getInfo()),
+      epsfcn_(other.epsfcn_), xtol_(other.xtol_), gtol_(other.gtol_),
+      useCostFunctionsJacobian_(other.useCostFunctionsJacobian_) {}
+    #endif
+
     inline Integer LevenbergMarquardt::getInfo() const {
-        return info_;
+        Integer result;
+        #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+        boost::mutex::scoped_lock guard(mutex_);
+        #elif defined(_OPENMP)
+        #pragma omp critical(ql_levenberg_marquardt_info)
+        #endif
+        {
+            result = info_;
+        }
+        return result;
+    }
+
+    inline void LevenbergMarquardt::setInfo(Integer info) {
+        #if defined(QL_SINGLETON_THREAD_SAFE_INIT)
+        boost::mutex::scoped_lock guard(mutex_);
+        #elif defined(_OPENMP)
+        #pragma omp critical(ql_levenberg_marquardt_info)
+        #endif
+        {
+            info_ = info;
+        }
     }
 
     inline EndCriteria::Type LevenbergMarquardt::minimize(Problem& P,
                                                    const EndCriteria& endCriteria) {
+        Integer info;
+        return minimize(P, endCriteria, info);
+    }
+
+    inline EndCriteria::Type LevenbergMarquardt::minimize(
+                                              Problem& P,
+                                              const EndCriteria& endCriteria,
+                                              Integer& minpackInfo) {
         EndCriteria::Type ecType = EndCriteria::None;
         P.reset();
         Array x_ = P.currentValue();
-        currentProblem_ = &P;
-        initCostValues_ = P.costFunction().values(x_);
-        int m = initCostValues_.size();
+        Array initCostValues = P.costFunction().values(x_);
+        int m = initCostValues.size();
         int n = x_.size();
+        Matrix initJacobian;
         if(useCostFunctionsJacobian_) {
-            initJacobian_ = Matrix(m,n);
-            P.costFunction().jacobian(initJacobian_, x_);
+            initJacobian = Matrix(m,n);
+            P.costFunction().jacobian(initJacobian, x_);
         }
         boost::scoped_array<Real> xx(new Real[n]);
         std::copy(x_.begin(), x_.end(), xx.get());
@@ -146,12 +227,15 @@ namespace QuantLib {
 
         // call lmdif to minimize the sum of the squares of m functions
         // in n variables by the Levenberg-Marquardt algorithm.
+        detail::LevenbergMarquardtFunction f(P, initCostValues,
+                                             initJacobian);
         MINPACK::LmdifCostFunction lmdifCostFunction =
-            boost::bind(&LevenbergMarquardt::fcn, this, _1, _2, _3, _4, _5);
+            boost::bind(&detail::LevenbergMarquardtFunction::fcn, &f,
+                        _1, _2, _3, _4, _5);
         MINPACK::LmdifCostFunction lmdifJacFunction =
             useCostFunctionsJacobian_
-                ? boost::bind(&LevenbergMarquardt::jacFcn, this, _1, _2, _3,
-                              _4, _5)
+                ? boost::bind(&detail::LevenbergMarquardtFunction::jacFcn,
+                              &f, _1, _2, _3, _4, _5)
                 : MINPACK::LmdifCostFunction(NULL);
         MINPACK::lmdif(m, n, xx.get(), fvec.get(),
                        endCriteria.functionEpsilon(),
@@ -165,7 +249,8 @@ namespace QuantLib {
                        wa1.get(), wa2.get(), wa3.get(), wa4.get(),
                        lmdifCostFunction,
                        lmdifJacFunction);
-        info_ = info;
+        minpackInfo = info;
+        setInfo(info);
         // check requirements & endCriteria evaluation
         QL_REQUIRE(info != 0, "MINPACK: improper input parameters");
         //QL_REQUIRE(info != 6, "MINPACK: ftol is too small. no further "
@@ -189,33 +274,47 @@ namespace QuantLib {
         return ecType;
     }
 
-    inline void LevenbergMarquardt::fcn(int, int n, Real* x, Real* fvec, int*) {
-        Array xt(n);
-        std::copy(x, x+n, xt.begin());
-        // constraint handling needs some improvement in the future:
-        // starting point should not be close to a constraint violation
-        if (currentProblem_->constraint().test(xt)) {
-            const Array& tmp = currentProblem_->values(xt);
-            std::copy(tmp.begin(), tmp.end(), fvec);
-        } else {
-            std::copy(initCostValues_.begin(), initCostValues_.end(), fvec);
+    namespace detail {
+
+        inline LevenbergMarquardtFunction::LevenbergMarquardtFunction(
+                                               Problem& P,
+                                               const Array& initCostValues,
+                                               const Matrix& initJacobian)
+        : problem_(P), initCostValues_(initCostValues),
+          initJacobian_(initJacobian), x_(P.currentValue().size()),
+          values_(initCostValues.size()), jacobian_(initJacobian.rows(), initJacobian.columns()) {}
+
+        inline void LevenbergMarquardtFunction::fcn(int, int n, Real* x,
+                                                    Real* fvec, int*) {
+            std::copy(x, x+n, x_.begin());
+            // constraint handling needs some improvement in the future:
+            // starting point should not be close to a constraint violation
+            if (problem_.constraint().test(x_)) {
+                problem_.fillValues(values_, x_);
+                std::copy(values_.begin(), values_.end(), fvec);
+            } else {
+                std::copy(initCostValues_.begin(), initCostValues_.end(),
+                          fvec);
+            }
         }
-    }
 
-    inline void LevenbergMarquardt::jacFcn(int m, int n, Real* x, Real* fjac, int*) {
-        Array xt(n);
-        std::copy(x, x+n, xt.begin());
-        // constraint handling needs some improvement in the future:
-        // starting point should not be close to a constraint violation
-        if (currentProblem_->constraint().test(xt)) {
-            Matrix tmp(m,n);
-            currentProblem_->costFunction().jacobian(tmp, xt);
-            Matrix tmpT = transpose(tmp);
-            std::copy(tmpT.begin(), tmpT.end(), fjac);
-        } else {
-            Matrix tmpT = transpose(initJacobian_);
-            std::copy(tmpT.begin(), tmpT.end(), fjac);
+        inline void LevenbergMarquardtFunction::jacFcn(int m, int n,
+                                                       Real* x, Real* fjac,
+                                                       int*) {
+            std::copy(x, x+n, x_.begin());
+            // constraint handling needs some improvement in the future:
+            // starting point should not be close to a constraint violation
+            const Matrix* jacobian = &initJacobian_;
+            if (problem_.constraint().test(x_)) {
+                problem_.costFunction().jacobian(jacobian_, x_);
+                jacobian = &jacobian_;
+            }
+            // MINPACK stores the jacobian by columns
+            for (int j=0; j<n; ++j)
+                for (int i=0; i<m; ++i)
+                    fjac[j*m+i] = (*jacobian)[i][j];
         }
+
     }
 
 
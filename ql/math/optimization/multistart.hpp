@@ -0,0 +1,309 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file multistart.hpp
+    \brief multi-start global optimization
+*/
+
+#ifndef quantlib_optimization_multi_start_hpp
+#define quantlib_optimization_multi_start_hpp
+
+#include <ql/math/optimization/problem.hpp>
+#include <ql/math/optimization/constraint.hpp>
+#include <ql/math/randomnumbers/haltonrsg.hpp>
+#include <ql/utilities/null.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+
+    //! multi-start global optimization
+    /*! A local optimization method is run from several starting
+        points, and the best of the minima found is returned.  The
+        first local search starts from the current value of the
+        problem, the others from the points of a Halton sequence
+        (with a random start drawn from the given seed; a null seed
+        is replaced by one from the SeedGenerator, as elsewhere in
+        the library) scaled to the given bounds.  If no bounds are
+        given, those of the constraint of the problem are used; they
+        must be finite.
+
+        The local searches are performed in rounds of startsPerRound
+        points.  The optimization stops after maxStarts local
+        searches, or earlier if the best value changed by no more
+        than functionEpsilon during maxStationaryRounds consecutive
+        rounds.  Local searches raising a QuantLib::Error are
+        discarded; other exceptions are propagated.  The function and
+        gradient evaluations of all the local searches are added to
+        those of the problem.
+
+        If parallel is true and the library is compiled with OpenMP
+        enabled, the local searches of each round are distributed
+        among threads.  This requires a local method and a cost
+        function that can be used concurrently: LevenbergMarquardt
+        can (its getInfo() then refers to whichever search ended
+        last), while Simplex and the line-search based methods keep
+        the state of the minimization in the instance and cannot.
+        In all cases, the results do not depend on the number of
+        threads.
+
+        The minima found are grouped into clusters of points closer
+        than clusterDistance, relative to the size of the bounds, in
+        each coordinate; each cluster is represented by its lowest
+        point.  The clusters of the last minimization are available
+        through minima().
+
+        \ingroup optimizers
+
+        \test the global minimum of a function with many local minima
+              is found, and the results of sequential and parallel
+              runs are checked to be the same.
+    */
+    class MultiStartOptimization : public OptimizationMethod {
+      public:
+        //! cluster of minima found by the local searches
+        struct Minimum {
+            Array values;
+            Real cost;
+            //! number of local searches that ended in the cluster
+            Size hits;
+            Minimum() : cost(0.0), hits(0) {}
+        };
+        MultiStartOptimization(
+                   const boost::shared_ptr<OptimizationMethod>& localMethod,
+                   Size maxStarts = 50,
+                   Size startsPerRound = 10,
+                   Size maxStationaryRounds = 2,
+                   Real functionEpsilon = 1.0e-8,
+                   Real clusterDistance = 1.0e-4,
+                   bool parallel = false,
+                   unsigned long seed = 42,
+                   const Array& lowerBound = Array(),
+                   const Array& upperBound = Array());
+        /*! The end criteria are passed to the local searches; the
+            returned type is the one of the search that found the
+            best minimum.
+        */
+        virtual EndCriteria::Type minimize(Problem& P,
+                                           const EndCriteria& endCriteria);
+        //! \name Inspectors
+        //@{
+        //! minima found by the last minimization, best first
+        const std::vector<Minimum>& minima() const { return minima_; }
+        //! number of local searches performed by the last minimization
+        Size starts() const { return starts_; }
+        //@}
+      private:
+        static bool lowerCost(const Minimum& m1, const Minimum& m2) {
+            return m1.cost < m2.cost;
+        }
+        void addMinimum(const Array& values, Real cost,
+                        const Array& scale);
+        boost::shared_ptr<OptimizationMethod> localMethod_;
+        Size maxStarts_, startsPerRound_, maxStationaryRounds_;
+        Real functionEpsilon_, clusterDistance_;
+        bool parallel_;
+        unsigned long seed_;
+        Array lowerBound_, upperBound_;
+        std::vector<Minimum> minima_;
+        Size starts_;
+    };
+
+
+    // inline definitions
+
+    inline MultiStartOptimization::MultiStartOptimization(
+                   const boost::shared_ptr<OptimizationMethod>& localMethod,
+                   Size maxStarts, Size startsPerRound,
+                   Size maxStationaryRounds, Real functionEpsilon,
+                   Real clusterDistance, bool parallel, unsigned long seed,
+                   const Array& lowerBound, const Array& upperBound)
+    : localMethod_(localMethod), maxStarts_(maxStarts),
+      startsPerRound_(startsPerRound),
+      maxStationaryRounds_(maxStationaryRounds),
+      functionEpsilon_(functionEpsilon), clusterDistance_(clusterDistance),
+      parallel_(parallel), seed_(seed), lowerBound_(lowerBound),
+      upperBound_(upperBound), starts_(0) {
+        QL_REQUIRE(localMethod_, "no local optimization method given");
+        QL_REQUIRE(maxStarts_ > 0, "at least one start required");
+        QL_REQUIRE(startsPerRound_ > 0,
+                   "at least one start per round required");
+        QL_REQUIRE(maxStationaryRounds_ > 0,
+                   "at least one stationary round required");
+        QL_REQUIRE(lowerBound_.size() == upperBound_.size(),
+                   "lower bound size (" << lowerBound_.size()
+                   << ") not equal to upper bound size ("
+                   << upperBound_.size() << ")");
+    }
+
+    inline EndCriteria::Type MultiStartOptimization::minimize(
+                                        Problem& P,
+                                        const EndCriteria& endCriteria) {
+        const Array x0 = P.currentValue();
+        const Size n = x0.size();
+        const Array lower =
+            lowerBound_.empty() ? P.constraint().lowerBound(x0) : lowerBound_;
+        const Array upper =
+            upperBound_.empty() ? P.constraint().upperBound(x0) : upperBound_;
+        QL_REQUIRE(lower.size() == n,
+                   "bounds size (" << lower.size()
+                   << ") not equal to params size (" << n << ")");
+        Array scale(n);
+        for (Size i=0; i<n; ++i) {
+            QL_REQUIRE(lower[i] > -QL_MAX_REAL && upper[i] < QL_MAX_REAL,
+                       "finite bounds required for parameter " << i);
+            QL_REQUIRE(lower[i] < upper[i],
+                       "empty range [" << lower[i] << ", " << upper[i]
+                       << "] for parameter " << i);
+            scale[i] = upper[i] - lower[i];
+        }
+
+        P.reset();
+        minima_.clear();
+        starts_ = 0;
+        HaltonRsg halton(n, seed_);
+        Real bestCost = QL_MAX_REAL;
+        EndCriteria::Type bestType = EndCriteria::None;
+        Size stationaryRounds = 0;
+
+        while (starts_ < maxStarts_) {
+            const Size count = std::min(startsPerRound_, maxStarts_-starts_);
+            // the starting points are drawn before the local searches,
+            // so that they do not depend on the order of the latter
+            std::vector<Array> points(count, Array(n));
+            for (Size k=0; k<count; ++k) {
+                if (starts_ + k == 0) {
+                    points[k] = x0;
+                } else {
+                    const std::vector<Real>& u = halton.nextSequence().value;
+                    for (Size i=0; i<n; ++i)
+                        points[k][i] = lower[i] + scale[i]*u[i];
+                }
+            }
+
+            std::vector<Real> costs(count, Null<Real>());
+            std::vector<EndCriteria::Type> types(count, EndCriteria::None);
+            std::vector<Integer> functionEvaluations(count, 0),
+                                 gradientEvaluations(count, 0);
+            #if defined(_OPENMP)
+            // exceptions cannot leave the parallel region; the first
+            // one other than QuantLib::Error is rethrown after it
+            bool badAlloc = false, failed = false;
+            std::string error;
+            #endif
+            const long searches = static_cast<long>(count);
+            #if defined(_OPENMP)
+            #pragma omp parallel for schedule(dynamic) if (parallel_)
+            #endif
+            for (long k=0; k<searches; ++k) {
+                Problem problem(P.costFunction(), P.constraint(),
+                                points[k]);
+                problem.reset();
+                try {
+                    types[k] = localMethod_->minimize(problem, endCriteria);
+                    points[k] = problem.currentValue();
+                    costs[k] = problem.functionValue();
+                } catch (Error&) {
+                    costs[k] = Null<Real>();
+                }
+                #if defined(_OPENMP)
+                catch (std::bad_alloc&) {
+                    #pragma omp critical(ql_multi_start_error)
+                    if (!failed) {
+                        failed = badAlloc = true;
+                    }
+                } catch (std::exception& e) {
+                    #pragma omp critical(ql_multi_start_error)
+                    if (!failed) {
+                        failed = true;
+                        error = e.what();
+                    }
+                }
+                #endif
+                functionEvaluations[k] = problem.functionEvaluation();
+                gradientEvaluations[k] = problem.gradientEvaluation();
+            }
+            #if defined(_OPENMP)
+            if (badAlloc)
+                throw std::bad_alloc();
+            QL_REQUIRE(!failed, error);
+            #endif
+            starts_ += count;
+            for (Size k=0; k<count; ++k)
+                P.addEvaluations(functionEvaluations[k],
+                                 gradientEvaluations[k]);
+
+            const Real previousCost = bestCost;
+            for (Size k=0; k<count; ++k) {
+                if (costs[k] == Null<Real>())
+                    continue;
+                addMinimum(points[k], costs[k], scale);
+                if (costs[k] < bestCost) {
+                    bestCost = costs[k];
+                    bestType = types[k];
+                }
+            }
+
+            if (previousCost != QL_MAX_REAL
+                && std::fabs(bestCost - previousCost) <= functionEpsilon_) {
+                if (++stationaryRounds >= maxStationaryRounds_)
+                    break;
+            } else {
+                stationaryRounds = 0;
+            }
+        }
+
+        QL_REQUIRE(!minima_.empty(),
+                   "all the " << starts_ << " local searches failed");
+        std::stable_sort(minima_.begin(), minima_.end(), lowerCost);
+        P.setCurrentValue(minima_.front().values);
+        P.setFunctionValue(minima_.front().cost);
+        return bestType;
+    }
+
+    inline void MultiStartOptimization::addMinimum(const Array& values,
+                                                   Real cost,
+                                                   const Array& scale) {
+        for (Size j=0; j<minima_.size(); ++j) {
+            Minimum& m = minima_[j];
+            bool close = true;
+            for (Size i=0; i<values.size() && close; ++i)
+                close = std::fabs(values[i] - m.values[i])
+                    <= clusterDistance_*scale[i];
+            if (close) {
+                ++m.hits;
+                if (cost < m.cost) {
+                    m.values = values;
+                    m.cost = cost;
+                }
+                return;
+            }
+        }
+        Minimum m;
+        m.values = values;
+        m.cost = cost;
+        m.hits = 1;
+        minima_.push_back(m);
+    }
+
+}
+
+
+#endif
@@ -58,6 +58,10 @@ namespace QuantLib {
         //! call cost values computation and increment evaluation counter
         Disposable<Array> values(const Array& x);
 
+        //! call cost values computation in place and increment
+        //  evaluation counter
+        void fillValues(Array& values, const Array& x);
+
         //! call cost function gradient computation and increment
         //  evaluation counter
         void gradient(Array& grad_f,
@@ -99,6 +103,14 @@ namespace QuantLib {
         //! number of evaluation of cost function gradient
         Integer gradientEvaluation() const { return gradientEvaluation_; }
 
+        //! add the evaluations made on another problem with the same
+        //  cost function, e.g. by local searches on its behalf
+        void addEvaluations(Integer functionEvaluations,
+                            Integer gradientEvaluations) {
+            functionEvaluation_ += functionEvaluations;
+            gradientEvaluation_ += gradientEvaluations;
+        }
+
       protected:
         //! Unconstrained cost function
         CostFunction& costFunction_;
@@ -123,6 +135,11 @@ namespace QuantLib {
         return costFunction_.values(x);
     }
 
+    inline void Problem::fillValues(Array& values, const Array& x) {
+        ++functionEvaluation_;
+        costFunction_.fillValues(values, x);
+    }
+
     inline void Problem::gradient(Array& grad_f,
                                   const Array& x) {
         ++gradientEvaluation_;
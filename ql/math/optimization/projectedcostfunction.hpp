@@ -50,10 +50,18 @@ namespace QuantLib {
             virtual Real value(const Array& freeParameters) const;
             virtual Disposable<Array>
                                    values(const Array& freeParameters) const;
+            virtual void jacobian(Matrix& jac,
+                                  const Array& freeParameters) const;
+            virtual Disposable<Array> valuesAndJacobian(
+                          Matrix& jac, const Array& freeParameters) const;
+            virtual bool hasAnalyticJacobian() const;
             //@}
 
         private:
+            void restrictJacobian(const Matrix& fullJacobian,
+                                  Matrix& jac) const;
             const CostFunction& costFunction_;
+            mutable Matrix fullJacobian_;
     };
 
 }
@@ -103,6 +111,51 @@ namespace QuantLib {
         return costFunction_.values(actualParameters_);
     }
 
+    /* if the underlying cost function has an analytic jacobian, it
+       is restricted to the columns of the free parameters; otherwise,
+       the finite differences are taken on the free parameters only */
+    inline void ProjectedCostFunction::jacobian(
+                        Matrix& jac, const Array& freeParameters) const {
+        if (!costFunction_.hasAnalyticJacobian()) {
+            CostFunction::jacobian(jac, freeParameters);
+            return;
+        }
+        mapFreeParameters(freeParameters);
+        if (fullJacobian_.rows() != jac.rows()
+            || fullJacobian_.columns() != actualParameters_.size())
+            fullJacobian_ = Matrix(jac.rows(), actualParameters_.size());
+        costFunction_.jacobian(fullJacobian_, actualParameters_);
+        restrictJacobian(fullJacobian_, jac);
+    }
+
+    inline Disposable<Array> ProjectedCostFunction::valuesAndJacobian(
+                        Matrix& jac, const Array& freeParameters) const {
+        if (!costFunction_.hasAnalyticJacobian())
+            return CostFunction::valuesAndJacobian(jac, freeParameters);
+        mapFreeParameters(freeParameters);
+        if (fullJacobian_.rows() != jac.rows()
+            || fullJacobian_.columns() != actualParameters_.size())
+            fullJacobian_ = Matrix(jac.rows(), actualParameters_.size());
+        Array result =
+            costFunction_.valuesAndJacobian(fullJacobian_, actualParameters_);
+        restrictJacobian(fullJacobian_, jac);
+        return result;
+    }
+
+    inline bool ProjectedCostFunction::hasAnalyticJacobian() const {
+        return costFunction_.hasAnalyticJacobian();
+    }
+
+    inline void ProjectedCostFunction::restrictJacobian(
+                        const Matrix& fullJacobian, Matrix& jac) const {
+        for (Size i=0; i<jac.rows(); ++i) {
+            Size k = 0;
+            for (Size j=0; j<actualParameters_.size(); ++j)
+                if (!fixParameters_[j])
+                    jac[i][k++] = fullJacobian[i][j];
+        }
+    }
+
 }
 
 
@@ -26,10 +26,29 @@
 #define quantlib_inversecumulative_rsg_h
 
 #include <ql/methods/montecarlo/sample.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
 #include <vector>
 
 namespace QuantLib {
 
+    namespace detail {
+
+        // sets y[i] = ic(x[i]) for i in [0,n)...
+        template <class IC>
+        void inverseCumulativeValues(const IC& ic,
+                                     const Real* x, Real* y, Size n) {
+            for (Size i=0; i<n; ++i)
+                y[i] = ic(x[i]);
+        }
+
+        // ...in a single call for the distributions providing it
+        inline void inverseCumulativeValues(const InverseCumulativeNormal& ic,
+                                            const Real* x, Real* y, Size n) {
+            ic(x, y, n);
+        }
+
+    }
+
     //! Inverse cumulative random sequence generator
     /*! It uses a sequence of uniform deviate in (0, 1) as the
         source of cumulative distribution values.
@@ -51,6 +70,12 @@ namespace QuantLib {
             IC::IC();
             Real IC::operator() const;
         \endcode
+
+        When IC is InverseCumulativeNormal, its array version is used
+        to transform the whole sequence in a single call.
+
+        \test the sequence transformed by InverseCumulativeNormal is
+              checked against the scalar inversion of the uniform one.
     */
     template <class USG, class IC>
     class InverseCumulativeRsg {
@@ -90,9 +115,9 @@ namespace QuantLib {
         typename USG::sample_type sample =
             uniformSequenceGenerator_.nextSequence();
         x_.weight = sample.weight;
-        for (Size i = 0; i < dimension_; i++) {
-            x_.value[i] = ICD_(sample.value[i]);
-        }
+        if (dimension_ > 0)
+            detail::inverseCumulativeValues(ICD_, &sample.value[0],
+                                            &x_.value[0], dimension_);
         return x_;
     }
 
@@ -1,3 +1,5 @@
+#include <ql/math/solvers1d/batchbrent.hpp>
+#include <ql/math/solvers1d/batchnewtonsafe.hpp>
 #include <ql/math/solvers1d/bisection.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 #include <ql/math/solvers1d/falseposition.hpp>
@@ -0,0 +1,176 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file batchbrent.hpp
+    \brief Brent solver for many independent 1-D equations
+*/
+
+#ifndef quantlib_batch_solver1d_brent_h
+#define quantlib_batch_solver1d_brent_h
+
+#include <ql/math/batchsolver1d.hpp>
+
+namespace QuantLib {
+
+    //! %Brent solver for many independent 1-D equations
+    /*! Each lane follows the same iterations as the Brent solver,
+        and its root is the same; the final evaluation that Brent
+        performs at the root is skipped, so that each lane uses one
+        evaluation less.
+
+        \test the roots are checked against those of the Brent
+              solver, and lanes that are not bracketed or exceed the
+              maximum number of evaluations are checked to fail
+              without affecting the others.
+
+        \ingroup solvers
+    */
+    class BatchBrent : public BatchSolver1D<BatchBrent> {
+      public:
+        template <class F>
+        void values(const F& f,
+                    const std::vector<Size>& lanes,
+                    const std::vector<Real>& x,
+                    std::vector<Real>& fx) const {
+            evaluate(f, lanes, x, fx);
+        }
+        template <class F>
+        void solveImpl(const F& f,
+                       Real xAccuracy) const {
+
+            const Size n = root_.size();
+            froot_.resize(n);
+            d_.resize(n);
+            e_.resize(n);
+
+            // as in Brent, we start with root_ on one side of the
+            // bracket and both xMin_ and xMax_ on the other.
+            evaluate(f, lanes_, root_, froot_);
+            for (Size k=0; k<lanes_.size(); ++k) {
+                const Size i = lanes_[k];
+                ++evaluationNumber_[i];
+                if (froot_[i] * fxMin_[i] < 0) {
+                    xMax_[i] = xMin_[i];
+                    fxMax_[i] = fxMin_[i];
+                } else {
+                    xMin_[i] = xMax_[i];
+                    fxMin_[i] = fxMax_[i];
+                }
+                d_[i] = e_[i] = root_[i] - xMax_[i];
+            }
+
+            std::vector<Size> next;
+            next.reserve(lanes_.size());
+            while (!lanes_.empty()) {
+                next.clear();
+                for (Size k=0; k<lanes_.size(); ++k) {
+                    const Size i = lanes_[k];
+                    if (evaluationNumber_[i] > maxEvaluations_)
+                        fail(i, MaxEvaluationsExceeded);
+                    else if (step(i, xAccuracy))
+                        next.push_back(i);
+                }
+                lanes_.swap(next);
+                if (!lanes_.empty()) {
+                    evaluate(f, lanes_, root_, froot_);
+                    for (Size k=0; k<lanes_.size(); ++k)
+                        ++evaluationNumber_[lanes_[k]];
+                }
+            }
+        }
+      private:
+        // one iteration of Brent on the i-th lane, up to the next
+        // evaluation; returns false if the lane converged
+        bool step(Size i, Real xAccuracy) const {
+            Real& root = root_[i];
+            Real& froot = froot_[i];
+            Real& xMin = xMin_[i];
+            Real& fxMin = fxMin_[i];
+            Real& xMax = xMax_[i];
+            Real& fxMax = fxMax_[i];
+            Real& d = d_[i];
+            Real& e = e_[i];
+            Real min1, min2, p, q, r, s, xAcc1, xMid;
+
+            if ((froot > 0.0 && fxMax > 0.0) ||
+                (froot < 0.0 && fxMax < 0.0)) {
+
+                // Rename xMin, root, xMax and adjust bounds
+                xMax=xMin;
+                fxMax=fxMin;
+                e=d=root-xMin;
+            }
+            if (std::fabs(fxMax) < std::fabs(froot)) {
+                xMin=root;
+                root=xMax;
+                xMax=xMin;
+                fxMin=froot;
+                froot=fxMax;
+                fxMax=fxMin;
+            }
+            // Convergence check
+            xAcc1=2.0*QL_EPSILON*std::fabs(root)+0.5*xAccuracy;
+            xMid=(xMax-root)/2.0;
+            if (std::fabs(xMid) <= xAcc1 || (close(froot, 0.0)))
+                return false;
+            if (std::fabs(e) >= xAcc1 &&
+                std::fabs(fxMin) > std::fabs(froot)) {
+
+                // Attempt inverse quadratic interpolation
+                s=froot/fxMin;
+                if (close(xMin,xMax)) {
+                    p=2.0*xMid*s;
+                    q=1.0-s;
+                } else {
+                    q=fxMin/fxMax;
+                    r=froot/fxMax;
+                    p=s*(2.0*xMid*q*(q-r)-(root-xMin)*(r-1.0));
+                    q=(q-1.0)*(r-1.0)*(s-1.0);
+                }
+                if (p > 0.0) q = -q;  // Check whether in bounds
+                p=std::fabs(p);
+                min1=3.0*xMid*q-std::fabs(xAcc1*q);
+                min2=std::fabs(e*q);
+                if (2.0*p < (min1 < min2 ? min1 : min2)) {
+                    e=d;                // Accept interpolation
+                    d=p/q;
+                } else {
+                    d=xMid;  // Interpolation failed, use bisection
+                    e=d;
+                }
+            } else {
+                // Bounds decreasing too slowly, use bisection
+                d=xMid;
+                e=d;
+            }
+            xMin=root;
+            fxMin=froot;
+            if (std::fabs(d) > xAcc1)
+                root += d;
+            else
+                root += sign(xAcc1,xMid);
+            return true;
+        }
+        Real sign(Real a, Real b) const {
+            return b >= 0.0 ? std::fabs(a) : -std::fabs(a);
+        }
+        mutable std::vector<Real> froot_, d_, e_;
+    };
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file batchnewtonsafe.hpp
+    \brief safe Newton solver for many independent 1-D equations
+*/
+
+#ifndef quantlib_batch_solver1d_newtonsafe_h
+#define quantlib_batch_solver1d_newtonsafe_h
+
+#include <ql/math/batchsolver1d.hpp>
+
+namespace QuantLib {
+
+    //! safe %Newton solver for many independent 1-D equations
+    /*! \note This solver requires that the passed function object
+              return the derivatives together with the values, i.e.,
+              that its signature be
+              \code
+              void operator()(const Size* lanes, const Real* x,
+                              Real* fx, Real* dfx, Size n) const
+              \endcode
+
+        Each lane follows the same iterations as the NewtonSafe
+        solver, and its root is the same; the final evaluation that
+        NewtonSafe performs at the root is skipped, so that each lane
+        uses one evaluation less.
+
+        \test the roots are checked against those of the NewtonSafe
+              solver.
+
+        \ingroup solvers
+    */
+    class BatchNewtonSafe : public BatchSolver1D<BatchNewtonSafe> {
+      public:
+        template <class F>
+        void values(const F& f,
+                    const std::vector<Size>& lanes,
+                    const std::vector<Real>& x,
+                    std::vector<Real>& fx) const {
+            dfroot_.resize(x.size());
+            evaluate(f, lanes, x, fx, dfroot_);
+        }
+        template <class F>
+        void solveImpl(const F& f,
+                       Real xAccuracy) const {
+
+            const Size n = root_.size();
+            froot_.resize(n);
+            dfroot_.resize(n);
+            dx_.resize(n);
+            dxold_.resize(n);
+            xl_.resize(n);
+            xh_.resize(n);
+
+            for (Size k=0; k<lanes_.size(); ++k) {
+                const Size i = lanes_[k];
+                // Orient the search so that f(xl) < 0
+                if (fxMin_[i] < 0.0) {
+                    xl_[i] = xMin_[i];
+                    xh_[i] = xMax_[i];
+                } else {
+                    xh_[i] = xMin_[i];
+                    xl_[i] = xMax_[i];
+                }
+                // the "stepsize before last" and the last step
+                dx_[i] = dxold_[i] = xMax_[i]-xMin_[i];
+            }
+
+            evaluate(f, lanes_, root_, froot_, dfroot_);
+            for (Size k=0; k<lanes_.size(); ++k) {
+                const Size i = lanes_[k];
+                QL_REQUIRE(dfroot_[i] != Null<Real>(),
+                           "BatchNewtonSafe requires function's derivative");
+                ++evaluationNumber_[i];
+            }
+
+            std::vector<Size> next;
+            next.reserve(lanes_.size());
+            while (!lanes_.empty()) {
+                next.clear();
+                for (Size k=0; k<lanes_.size(); ++k) {
+                    const Size i = lanes_[k];
+                    if (evaluationNumber_[i] > maxEvaluations_)
+                        fail(i, MaxEvaluationsExceeded);
+                    else if (step(i, xAccuracy))
+                        next.push_back(i);
+                }
+                lanes_.swap(next);
+                if (!lanes_.empty()) {
+                    evaluate(f, lanes_, root_, froot_, dfroot_);
+                    for (Size k=0; k<lanes_.size(); ++k) {
+                        const Size i = lanes_[k];
+                        ++evaluationNumber_[i];
+                        if (froot_[i] < 0.0)
+                            xl_[i] = root_[i];
+                        else
+                            xh_[i] = root_[i];
+                    }
+                }
+            }
+        }
+      private:
+        // one iteration of NewtonSafe on the i-th lane, up to the next
+        // evaluation; returns false if the lane converged
+        bool step(Size i, Real xAccuracy) const {
+            Real& root = root_[i];
+            const Real froot = froot_[i], dfroot = dfroot_[i];
+            const Real xl = xl_[i], xh = xh_[i];
+            Real& dx = dx_[i];
+            Real& dxold = dxold_[i];
+
+            // Bisect if (out of range || not decreasing fast enough)
+            if ((((root-xh)*dfroot-froot)*
+                 ((root-xl)*dfroot-froot) > 0.0)
+                || (std::fabs(2.0*froot) > std::fabs(dxold*dfroot))) {
+
+                dxold = dx;
+                dx = (xh-xl)/2.0;
+                root=xl+dx;
+            } else {
+                dxold = dx;
+                dx = froot/dfroot;
+                root -= dx;
+            }
+            // Convergence criterion
+            return !(std::fabs(dx) < xAccuracy);
+        }
+        mutable std::vector<Real> froot_, dfroot_, dx_, dxold_, xl_, xh_;
+    };
+
+}
+
+#endif
@@ -26,9 +26,39 @@
 #define quantlib_mixed_scheme_hpp
 
 #include <ql/methods/finitedifferences/finitedifferencemodel.hpp>
+#include <ql/methods/finitedifferences/tridiagonaloperator.hpp>
 
 namespace QuantLib {
 
+    namespace detail {
+
+        // solves the implicit part of a step in place
+        template <class Operator>
+        class ImplicitStepSolver {
+          public:
+            void solveFor(const Operator& L,
+                          typename Operator::array_type& a) {
+                L.solveFor(a, a);
+            }
+        };
+
+        // boundary conditions reset the same rows at every step, so
+        // that the factorization of a time-constant operator only
+        // needs to be computed once
+        template <>
+        class ImplicitStepSolver<TridiagonalOperator> {
+          public:
+            void solveFor(const TridiagonalOperator& L, Array& a) {
+                if (!factorization_.factorizes(L))
+                    factorization_ = TridiagonalFactorization(L);
+                factorization_.solveFor(a, a);
+            }
+          private:
+            TridiagonalFactorization factorization_;
+        };
+
+    }
+
     //! Mixed (explicit/implicit) scheme for finite difference methods
     /*! In this implementation, the passed operator must be derived
         from either TimeConstantOperator or TimeDependentOperator.
@@ -97,6 +127,7 @@ namespace QuantLib {
         Time dt_;
         Real theta_;
         bc_set bcs_;
+        detail::ImplicitStepSolver<operator_type> implicitSolver_;
     };
 
 
@@ -125,7 +156,7 @@ namespace QuantLib {
             }
             for (i=0; i<bcs_.size(); i++)
                 bcs_[i]->applyBeforeSolving(implicitPart_,a);
-            implicitPart_.solveFor(a, a);
+            implicitSolver_.solveFor(implicitPart_, a);
             for (i=0; i<bcs_.size(); i++)
                 bcs_[i]->applyAfterSolving(a);
         }
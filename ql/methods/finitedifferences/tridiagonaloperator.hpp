@@ -125,6 +125,52 @@ namespace QuantLib {
     /* \relates TridiagonalOperator */
     void swap(TridiagonalOperator&, TridiagonalOperator&);
 
+    //! LU factorization of a tridiagonal operator
+    /*! The factorization used by the Thomas algorithm is computed
+        once at construction and can be reused for any number of
+        solves.  Unlike TridiagonalOperator::solveFor, the solve
+        methods use no scratch storage and don't allocate; a single
+        instance can therefore be shared among threads.
+
+        Several right-hand sides can be solved for in a single call.
+        They must be stored interleaved, i.e., the \f$ i \f$-th
+        element of the \f$ k \f$-th right-hand side is stored at
+        position \f$ i m + k \f$, \f$ m \f$ being the number of
+        right-hand sides.  This way the innermost loops run over
+        contiguous memory and can be vectorized by the compiler.
+
+        \ingroup findiff
+    */
+    class TridiagonalFactorization {
+      public:
+        TridiagonalFactorization();
+        explicit TridiagonalFactorization(const TridiagonalOperator& L);
+        //! \name Inspectors
+        //@{
+        Size size() const { return n_; }
+        //! whether this is the factorization of the given operator
+        bool factorizes(const TridiagonalOperator& L) const;
+        //@}
+        //! \name Solvers
+        //@{
+        /*! solve linear system for a given right-hand side. The rhs
+            and result parameters can be the same Array.
+        */
+        void solveFor(const Array& rhs,
+                      Array& result) const;
+        /*! solve linear system for count interleaved right-hand
+            sides. The rhs and result parameters can be the same Array.
+        */
+        void solveFor(const Array& rhs,
+                      Array& result,
+                      Size count) const;
+        //@}
+      private:
+        Size n_;
+        Array lowerDiagonal_, diagonal_, upperDiagonal_;
+        Array inversePivots_, upperFactors_;
+    };
+
     inline TridiagonalOperator::TridiagonalOperator(Size size) {
         if (size>=2) {
             n_ = size;
@@ -272,6 +318,84 @@ namespace QuantLib {
         return I;
     }
 
+    inline TridiagonalFactorization::TridiagonalFactorization() : n_(0) {}
+
+    inline TridiagonalFactorization::TridiagonalFactorization(
+                                               const TridiagonalOperator& L)
+    : n_(L.size()), lowerDiagonal_(L.lowerDiagonal()),
+      diagonal_(L.diagonal()), upperDiagonal_(L.upperDiagonal()),
+      inversePivots_(n_), upperFactors_(n_) {
+        QL_REQUIRE(n_!=0,
+                   "uninitialized TridiagonalOperator");
+
+        Real bet = diagonal_[0];
+        QL_REQUIRE(!close(bet, 0.0),
+                   "diagonal's first element (" << bet <<
+                   ") cannot be close to zero");
+        inversePivots_[0] = 1.0/bet;
+        upperFactors_[0] = 0.0;
+        for (Size j=1; j<=n_-1; ++j) {
+            upperFactors_[j] = upperDiagonal_[j-1]*inversePivots_[j-1];
+            bet = diagonal_[j]-lowerDiagonal_[j-1]*upperFactors_[j];
+            QL_ENSURE(!close(bet, 0.0), "division by zero");
+            inversePivots_[j] = 1.0/bet;
+        }
+    }
+
+    inline bool TridiagonalFactorization::factorizes(
+                                        const TridiagonalOperator& L) const {
+        return L.size() == n_
+            && std::equal(diagonal_.begin(), diagonal_.end(),
+                          L.diagonal().begin())
+            && std::equal(lowerDiagonal_.begin(), lowerDiagonal_.end(),
+                          L.lowerDiagonal().begin())
+            && std::equal(upperDiagonal_.begin(), upperDiagonal_.end(),
+                          L.upperDiagonal().begin());
+    }
+
+    inline void TridiagonalFactorization::solveFor(const Array& rhs,
+                                                   Array& result) const {
+        solveFor(rhs, result, 1);
+    }
+
+    inline void TridiagonalFactorization::solveFor(const Array& rhs,
+                                                   Array& result,
+                                                   Size count) const {
+        QL_REQUIRE(n_!=0,
+                   "uninitialized TridiagonalFactorization");
+        QL_REQUIRE(rhs.size()==n_*count,
+                   "rhs vector of size " << rhs.size() <<
+                   " instead of " << n_*count);
+        QL_REQUIRE(result.size()==n_*count,
+                   "result vector of size " << result.size() <<
+                   " instead of " << n_*count);
+
+        const Real* r = rhs.begin();
+        Real* x = result.begin();
+
+        // forward substitution
+        const Real b0 = inversePivots_[0];
+        for (Size k=0; k<count; ++k)
+            x[k] = r[k]*b0;
+        for (Size j=1; j<n_; ++j) {
+            const Real l = lowerDiagonal_[j-1], b = inversePivots_[j];
+            const Real* rj = r + j*count;
+            const Real* xp = x + (j-1)*count;
+            Real* xj = x + j*count;
+            for (Size k=0; k<count; ++k)
+                xj[k] = (rj[k] - l*xp[k])*b;
+        }
+
+        // back substitution
+        for (Size j=n_-1; j>0; --j) {
+            const Real u = upperFactors_[j];
+            const Real* xn = x + j*count;
+            Real* xj = x + (j-1)*count;
+            for (Size k=0; k<count; ++k)
+                xj[k] -= u*xn[k];
+        }
+    }
+
     // inline definitions
 
     inline TridiagonalOperator& TridiagonalOperator::operator=(
@@ -62,7 +62,7 @@ namespace QuantLib {
 */
 
 #include <ql/math/statistics/sequencestatistics.hpp>
-#include <ql/math/matrixutilities/svd.hpp>
+#include <ql/math/matrixutilities/qrdecomposition.hpp>
 
 namespace QuantLib {
 
@@ -73,6 +73,12 @@ namespace QuantLib {
         Size steps = simulationData.size();
         basisCoefficients.resize(steps-1);
 
+        // the normal equations have the same shape at every exercise,
+        // so that the factorization storage can be reused
+        QRLeastSquares solver;
+        Matrix C;
+        Array target, alphas;
+
         for (Size i=steps-1; i!=0; --i) {
 
             std::vector<NodeData>& exerciseData = simulationData[i];
@@ -99,8 +105,11 @@ namespace QuantLib {
             std::vector<Real> means = stats.mean();
             Matrix covariance = stats.covariance();
 
-            Matrix C(N,N);
-            Array target(N);
+            if (C.rows() != N) {
+                C = Matrix(N,N);
+                target = Array(N);
+                alphas = Array(N);
+            }
             for (Size k=0; k<N; ++k) {
                 target[k] = covariance[k][N] + means[k]*means[N];
                 for (Size l=0; l<=k; ++l)
@@ -108,7 +117,8 @@ namespace QuantLib {
             }
 
             // 2) solve for least squares regression
-            Array alphas = SVD(C).solveFor(target);
+            solver.factorize(C);
+            solver.solveFor(target, alphas);
             basisCoefficients[i-1].resize(N);
             std::copy(alphas.begin(), alphas.end(),
                       basisCoefficients[i-1].begin());
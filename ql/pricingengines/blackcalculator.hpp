@@ -26,6 +26,7 @@
 #define quantlib_blackcalculator_hpp
 
 #include <ql/instruments/payoffs.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -114,6 +115,46 @@ namespace QuantLib {
         Real x_, DxDs_, DxDstrike_;
     };
 
+    //! Black 1976 calculator for several plain-vanilla options
+    /*! The value, delta, gamma, vega and theta of the options are
+        calculated together on construction, as given by
+        BlackCalculator for the corresponding spot and maturity.
+        The parameters are checked once, and the cumulative normal
+        is evaluated on all the arguments in a single call to its
+        array version; the loops on the options are written without
+        branches on the data, so that the compiler can vectorize
+        them where the math library allows it.
+
+        For the options with null standard deviation or strike,
+        gamma and vega are set to zero and delta to the one of the
+        intrinsic value, instead of the undefined values returned
+        by BlackCalculator.
+
+        \test the results are checked against those of
+              BlackCalculator.
+    */
+    class BatchBlackCalculator {
+      public:
+        BatchBlackCalculator(Option::Type optionType,
+                             const std::vector<Real>& strikes,
+                             const std::vector<Real>& forwards,
+                             const std::vector<Real>& stdDevs,
+                             const std::vector<Real>& discounts,
+                             const std::vector<Real>& spots,
+                             const std::vector<Time>& maturities);
+        Size size() const { return value_.size(); }
+        const std::vector<Real>& value() const { return value_; }
+        //! sensitivities to the spot prices
+        const std::vector<Real>& delta() const { return delta_; }
+        const std::vector<Real>& gamma() const { return gamma_; }
+        //! sensitivities to the volatilities
+        const std::vector<Real>& vega() const { return vega_; }
+        //! sensitivities to the times to maturity
+        const std::vector<Real>& theta() const { return theta_; }
+      private:
+        std::vector<Real> value_, delta_, gamma_, vega_, theta_;
+    };
+
     // inline
     inline Real BlackCalculator::thetaPerDay(Real spot,
                                              Time maturity) const {
@@ -490,6 +531,140 @@ namespace QuantLib {
         return discount_ * temp2;
     }
 
+
+    inline BatchBlackCalculator::BatchBlackCalculator(
+                                         Option::Type optionType,
+                                         const std::vector<Real>& strikes,
+                                         const std::vector<Real>& forwards,
+                                         const std::vector<Real>& stdDevs,
+                                         const std::vector<Real>& discounts,
+                                         const std::vector<Real>& spots,
+                                         const std::vector<Time>& maturities)
+    : value_(strikes.size()), delta_(strikes.size()), gamma_(strikes.size()),
+      vega_(strikes.size()), theta_(strikes.size()) {
+        const Size n = strikes.size();
+        QL_REQUIRE(forwards.size() == n && stdDevs.size() == n
+                   && discounts.size() == n && spots.size() == n
+                   && maturities.size() == n,
+                   "strikes (" << n << "), forwards (" << forwards.size()
+                   << "), standard deviations (" << stdDevs.size()
+                   << "), discounts (" << discounts.size()
+                   << "), spots (" << spots.size()
+                   << ") and maturities (" << maturities.size()
+                   << ") have different sizes");
+        QL_REQUIRE(optionType == Option::Call || optionType == Option::Put,
+                   "invalid option type");
+
+        // options with null standard deviation or strike
+        std::vector<Size> degenerate;
+        for (Size i=0; i<n; ++i) {
+            QL_REQUIRE(strikes[i]>=0.0,
+                       "strike (" << strikes[i] << ") must be non-negative");
+            QL_REQUIRE(forwards[i]>0.0,
+                       "forward (" << forwards[i] << ") must be positive");
+            QL_REQUIRE(stdDevs[i]>=0.0,
+                       "stdDev (" << stdDevs[i] << ") must be non-negative");
+            QL_REQUIRE(discounts[i]>0.0,
+                       "discount (" << discounts[i] << ") must be positive");
+            QL_REQUIRE(spots[i] > 0.0, "positive spot value required: " <<
+                       spots[i] << " not allowed");
+            QL_REQUIRE(maturities[i]>=0.0,
+                       "maturity (" << maturities[i]
+                       << ") must be non-negative");
+            if (stdDevs[i] < QL_EPSILON || close(strikes[i], 0.0))
+                degenerate.push_back(i);
+        }
+
+        // d1 in the first half, d2 in the second
+        std::vector<Real> d(2*n), cum(2*n);
+        for (Size i=0; i<n; ++i) {
+            const Real s = std::max(stdDevs[i], QL_EPSILON);
+            const Real k = std::max(strikes[i], QL_EPSILON);
+            d[i] = std::log(forwards[i]/k)/s + 0.5*s;
+            d[n+i] = d[i] - s;
+        }
+        if (n > 0) {
+            CumulativeNormalDistribution f;
+            f(&d[0], &cum[0], 2*n);
+        }
+
+        // alpha = N(d1) - shift, beta = shift - N(d2)
+        const Real shift = (optionType == Option::Call ? 0.0 : 1.0);
+        const Real norm = M_SQRT_2 * M_1_SQRTPI;
+        for (Size i=0; i<n; ++i) {
+            const Real strike = strikes[i], forward = forwards[i];
+            const Real stdDev = std::max(stdDevs[i], QL_EPSILON);
+            const Real discount = discounts[i], spot = spots[i];
+            const Time maturity = maturities[i];
+            const Real d1 = d[i], d2 = d[n+i];
+
+            const Real alpha = cum[i] - shift, beta = shift - cum[n+i];
+            const Real DalphaDd1 = norm*std::exp(-0.5*d1*d1);
+            const Real DbetaDd2 = -norm*std::exp(-0.5*d2*d2);
+
+            const Real value = discount * (forward * alpha + strike * beta);
+
+            const Real DforwardDs = forward / spot;
+            const Real temp = stdDev*spot;
+            const Real DalphaDs = DalphaDd1/temp;
+            const Real DbetaDs = DbetaDd2/temp;
+            const Real delta = discount * (DalphaDs * forward
+                                           + alpha * DforwardDs
+                                           + DbetaDs * strike);
+
+            const Real D2alphaDs2 = - DalphaDs/spot*(1+d1/stdDev);
+            const Real D2betaDs2  = - DbetaDs /spot*(1+d2/stdDev);
+            const Real gamma = discount * (D2alphaDs2 * forward
+                                           + 2.0 * DalphaDs * DforwardDs
+                                           + D2betaDs2 * strike);
+
+            const Real variance = stdDev*stdDev;
+            const Real temp2 =
+                std::log(std::max(strike, QL_EPSILON)/forward)/variance;
+            const Real vega = discount * std::sqrt(maturity)
+                * (DalphaDd1*(temp2+0.5) * forward
+                   + DbetaDd2*(temp2-0.5) * strike);
+
+            const Real theta = -( std::log(discount) * value
+                                 +std::log(forward/spot) * spot * delta
+                                 +0.5*variance * spot * spot * gamma)
+                / maturity;
+
+            value_[i] = value;
+            delta_[i] = delta;
+            gamma_[i] = gamma;
+            vega_[i] = vega;
+            theta_[i] = theta;
+        }
+
+        for (Size j=0; j<degenerate.size(); ++j) {
+            const Size i = degenerate[j];
+            Real cum_d1, cum_d2;
+            if (stdDevs[i] >= QL_EPSILON)
+                cum_d1 = cum_d2 = 1.0;
+            else if (close(forwards[i], strikes[i]))
+                cum_d1 = cum_d2 = 0.5;
+            else if (forwards[i] > strikes[i])
+                cum_d1 = cum_d2 = 1.0;
+            else
+                cum_d1 = cum_d2 = 0.0;
+            const Real alpha = cum_d1 - shift, beta = shift - cum_d2;
+            value_[i] = discounts[i] * (forwards[i] * alpha
+                                        + strikes[i] * beta);
+            delta_[i] = discounts[i] * alpha * forwards[i] / spots[i];
+            gamma_[i] = 0.0;
+            vega_[i] = 0.0;
+            theta_[i] = -( std::log(discounts[i]) * value_[i]
+                          +std::log(forwards[i]/spots[i])
+                              * spots[i] * delta_[i])
+                / maturities[i];
+        }
+        for (Size i=0; i<n; ++i) {
+            if (close(maturities[i], 0.0))
+                theta_[i] = 0.0;
+        }
+    }
+
 }
 
 #endif
\ No newline at end of file
@@ -34,6 +34,7 @@
 
 #include <ql/option.hpp>
 #include <ql/instruments/payoffs.hpp>
+#include <vector>
 
 namespace QuantLib {
 
@@ -58,6 +59,21 @@ namespace QuantLib {
                       Real discount = 1.0,
                       Real displacement = 0.0);
 
+    /*! Black 1976 formula for several options.  The parameters
+        are checked once for all the options, and the cumulative
+        normal is evaluated on all the arguments in a single call
+        to its array version; the results agree with those of the
+        scalar formula within the accuracy of the latter.
+        \warning instead of volatility it uses standard deviation,
+                 i.e. volatility*sqrt(timeToMaturity)
+    */
+    std::vector<Real> blackFormula(Option::Type optionType,
+                                   const std::vector<Real>& strikes,
+                                   const std::vector<Real>& forwards,
+                                   const std::vector<Real>& stdDevs,
+                                   const std::vector<Real>& discounts,
+                                   Real displacement = 0.0);
+
 
     /*! Approximated Black 1976 implied standard deviation,
         i.e. volatility*sqrt(timeToMaturity).
@@ -211,6 +227,54 @@ namespace QuantLib {
         Real accuracy = 1.0e-6,
         Natural maxIterations = 100);
 
+    /*! Black 1976 implied standard deviation,
+        i.e. volatility*sqrt(timeToMaturity)
+
+        The out-of-the-money option is inverted; starting from the
+        explicit approximation of Radoicic and Stefanica (see
+        blackFormulaImpliedStdDevLiRS), Householder iterations of
+        order three are performed on the logarithm of its
+        normalized price below the inflection point of the price
+        as a function of the standard deviation, and on the
+        logarithm of its distance from the upper bound above it,
+        as in
+
+        "Let's Be Rational"
+        P. Jaeckel, Wilmott, January 2015, pp. 40-53.
+
+        Deep in the lower wing, where the approximation loses
+        accuracy, the iterations start instead from the asymptotic
+        expansion of the price for small standard deviations.  The
+        number of iterations depends on the quote; maxIterations
+        only guards against a failure to converge.  Unlike
+        blackFormulaImpliedStdDev, no upper limit is placed on the
+        standard deviation.
+    */
+    Real blackFormulaImpliedStdDevHouseholder(Option::Type optionType,
+                                              Real strike,
+                                              Real forward,
+                                              Real blackPrice,
+                                              Real discount = 1.0,
+                                              Real displacement = 0.0,
+                                              Real accuracy = 1.0e-12,
+                                              Natural maxIterations = 100);
+
+    /*! Black 1976 implied standard deviations for several options,
+        e.g., the quotes of a volatility surface; see the scalar
+        version above.  The forwards and the discounts are given for
+        each option.  The result is Null<Real>() for the options
+        whose inputs are invalid or admit no solution.
+    */
+    std::vector<Real> blackFormulaImpliedStdDevHouseholder(
+                                    Option::Type optionType,
+                                    const std::vector<Real>& strikes,
+                                    const std::vector<Real>& forwards,
+                                    const std::vector<Real>& blackPrices,
+                                    const std::vector<Real>& discounts,
+                                    Real displacement = 0.0,
+                                    Real accuracy = 1.0e-12,
+                                    Natural maxIterations = 100);
+
     /*! Black 1976 probability of being in the money (in the bond martingale
         measure), i.e. N(d2).
         It is a risk-neutral probability, not the real world one.
@@ -321,6 +385,21 @@ namespace QuantLib {
                         Real forward,
                         Real stdDev,
                         Real discount = 1.0);
+
+    /*! Bachelier formula for several options; see the array
+        version of blackFormula.
+
+        \warning Bachelier model needs absolute volatility, not
+                 percentage volatility. Standard deviation is
+                 absoluteVolatility*sqrt(timeToMaturity)
+    */
+    std::vector<Real> bachelierBlackFormula(
+                                   Option::Type optionType,
+                                   const std::vector<Real>& strikes,
+                                   const std::vector<Real>& forwards,
+                                   const std::vector<Real>& stdDevs,
+                                   const std::vector<Real>& discounts);
+
     /*! Approximated Bachelier implied volatility
 
         It is calculated using  the analytic implied volatility approximation
@@ -335,6 +414,39 @@ namespace QuantLib {
                                    Real bachelierPrice,
                                    Real discount = 1.0);
 
+    /*! Bachelier implied standard deviation, i.e.
+        absoluteVolatility*sqrt(timeToMaturity)
+
+        Starting from the approximation of Choi, Kim and Kwak used
+        by bachelierBlackFormulaImpliedVol, Householder iterations
+        of order three are performed on the logarithm of the price
+        of the out-of-the-money option.  The number of iterations
+        depends on the quote; maxIterations only guards against a
+        failure to converge.
+    */
+    Real bachelierBlackFormulaImpliedStdDevHouseholder(
+                                   Option::Type optionType,
+                                   Real strike,
+                                   Real forward,
+                                   Real bachelierPrice,
+                                   Real discount = 1.0,
+                                   Real accuracy = 1.0e-12,
+                                   Natural maxIterations = 100);
+
+    /*! Bachelier implied standard deviations for several options;
+        see the scalar version above.  The result is Null<Real>()
+        for the options whose inputs are invalid or admit no
+        solution.
+    */
+    std::vector<Real> bachelierBlackFormulaImpliedStdDevHouseholder(
+                                   Option::Type optionType,
+                                   const std::vector<Real>& strikes,
+                                   const std::vector<Real>& forwards,
+                                   const std::vector<Real>& bachelierPrices,
+                                   const std::vector<Real>& discounts,
+                                   Real accuracy = 1.0e-12,
+                                   Natural maxIterations = 100);
+
     /*! Bachelier formula for standard deviation derivative
         \warning instead of volatility it uses standard deviation, i.e.
                  volatility*sqrt(timeToMaturity), and it returns the
@@ -397,6 +509,7 @@ namespace QuantLib {
 #endif
 
 #include <boost/math/special_functions/sign.hpp>
+#include <boost/math/special_functions/erf.hpp>
 
 namespace {
     inline void checkParameters(QuantLib::Real strike,
@@ -466,6 +579,71 @@ namespace QuantLib {
             payoff->strike(), forward, stdDev, discount, displacement);
     }
 
+    inline std::vector<Real> blackFormula(Option::Type optionType,
+                                          const std::vector<Real>& strikes,
+                                          const std::vector<Real>& forwards,
+                                          const std::vector<Real>& stdDevs,
+                                          const std::vector<Real>& discounts,
+                                          Real displacement) {
+        const Size n = strikes.size();
+        QL_REQUIRE(forwards.size() == n && stdDevs.size() == n
+                   && discounts.size() == n,
+                   "strikes (" << n << "), forwards (" << forwards.size()
+                   << "), standard deviations (" << stdDevs.size()
+                   << ") and discounts (" << discounts.size()
+                   << ") have different sizes");
+        for (Size i=0; i<n; ++i) {
+            checkParameters(strikes[i], forwards[i], displacement);
+            QL_REQUIRE(stdDevs[i]>=0.0,
+                       "stdDev (" << stdDevs[i] << ") must be non-negative");
+            QL_REQUIRE(discounts[i]>0.0,
+                       "discount (" << discounts[i] << ") must be positive");
+        }
+
+        std::vector<Real> result(n);
+        CumulativeNormalDistribution phi;
+        // the options are processed in blocks small enough for the
+        // intermediate results to stay in cache
+        const Size blockSize = 256;
+        // d1 in the first half, d2 in the second, both times optionType
+        Real d[2*blockSize], nd[2*blockSize];
+        for (Size i0=0; i0<n; i0+=blockSize) {
+            const Size m = std::min(blockSize, n-i0);
+            for (Size j=0; j<m; ++j) {
+                const Real f = forwards[i0+j] + displacement;
+                const Real k = strikes[i0+j] + displacement;
+                const Real s = stdDevs[i0+j];
+                // the options with null stdDev or strike are patched below
+                const bool regular = s > 0.0 && k > 0.0;
+                const Real d1 = regular ? std::log(f/k)/s + 0.5*s : 0.0;
+                d[j] = optionType*d1;
+                d[m+j] = optionType*(d1-s);
+            }
+            phi(d, nd, 2*m);
+            for (Size j=0; j<m; ++j) {
+                const Real f = forwards[i0+j] + displacement;
+                const Real k = strikes[i0+j] + displacement;
+                result[i0+j] =
+                    discounts[i0+j]*optionType*(f*nd[j] - k*nd[m+j]);
+            }
+        }
+        for (Size i=0; i<n; ++i) {
+            if (stdDevs[i]==0.0)
+                result[i] = std::max((forwards[i]-strikes[i])*optionType,
+                                     Real(0.0))*discounts[i];
+            else if (strikes[i]+displacement==0.0)
+                result[i] = (optionType==Option::Call ?
+                             (forwards[i]+displacement)*discounts[i] : 0.0);
+            QL_ENSURE(result[i]>=0.0,
+                      "negative value (" << result[i] << ") for " <<
+                      stdDevs[i] << " stdDev, " <<
+                      optionType << " option, " <<
+                      strikes[i] << " strike , " <<
+                      forwards[i] << " forward");
+        }
+        return result;
+    }
+
     inline Real blackFormulaImpliedStdDevApproximation(Option::Type optionType,
                                                 Real strike,
                                                 Real forward,
@@ -878,6 +1056,187 @@ namespace QuantLib {
             guess, omega, accuracy, maxIterations);
     }
 
+    namespace detail {
+
+        /* Householder step of order three for g(s) = 0, given
+           nu = -g/g', h2 = g''/g' and h3 = g'''/g' */
+        inline Real householderStep(Real nu, Real h2, Real h3) {
+            return nu*(1.0+0.5*h2*nu)/(1.0+nu*(h2+h3*nu/6.0));
+        }
+
+        /* cumulative normal with full relative accuracy in the left
+           tail, where the prices of out-of-the-money options are
+           differences of small terms */
+        inline Real tailCumulativeNormal(Real z) {
+            return 0.5*boost::math::erfc(-z*M_SQRT1_2);
+        }
+
+        /* normalized out-of-the-money call price
+           b = exp(x/2) N(x/s+s/2) - exp(-x/2) N(x/s-s/2), x <= 0,
+           and its distance from the upper bound exp(x/2), which is
+           calculated as a sum to avoid cancellation */
+        inline void normalizedBlackCall(Real x, Real s,
+                                        Real& b, Real& bUpper) {
+            const Real d1 = x/s + 0.5*s, d2 = d1 - s;
+            const Real ex = std::exp(0.5*x);
+            const Real n2 = tailCumulativeNormal(d2);
+            b = std::max(ex*tailCumulativeNormal(d1) - n2/ex, Real(0.0));
+            bUpper = ex*tailCumulativeNormal(-d1) + n2/ex;
+        }
+
+    }
+
+    inline Real blackFormulaImpliedStdDevHouseholder(Option::Type optionType,
+                                                     Real strike,
+                                                     Real forward,
+                                                     Real blackPrice,
+                                                     Real discount,
+                                                     Real displacement,
+                                                     Real accuracy,
+                                                     Natural maxIterations) {
+        checkParameters(strike, forward, displacement);
+        QL_REQUIRE(strike + displacement > 0.0,
+                   "strike + displacement (" << strike << " + "
+                   << displacement << ") must be positive");
+        QL_REQUIRE(discount>0.0,
+                   "discount (" << discount << ") must be positive");
+        QL_REQUIRE(blackPrice>=0.0,
+                   "option price (" << blackPrice << ") must be non-negative");
+        // check the price of the "other" option implied by put-call parity
+        Real otherOptionPrice = blackPrice - optionType*(forward-strike)*discount;
+        QL_REQUIRE(otherOptionPrice>=0.0,
+                   "negative " << Option::Type(-1*optionType) <<
+                   " price (" << otherOptionPrice <<
+                   ") implied by put-call parity. No solution exists for " <<
+                   optionType << " strike " << strike <<
+                   ", forward " << forward <<
+                   ", price " << blackPrice <<
+                   ", deflator " << discount);
+
+        strike = strike + displacement;
+        forward = forward + displacement;
+
+        // the out-of-the-money price is normalized as a call with
+        // x = log(F/K) <= 0; a put with x > 0 has the same price as
+        // a call with -x
+        const Real otmPrice =
+            (optionType == Option::Call) == (strike >= forward)
+            ? blackPrice : otherOptionPrice;
+        const Real x = -std::fabs(std::log(forward/strike));
+        const Real beta = otmPrice/(discount*std::sqrt(forward*strike));
+        const Real bMax = std::exp(0.5*x);
+        QL_REQUIRE(beta < bMax,
+                   "out-of-the-money price (" << otmPrice
+                   << ") must be lower than "
+                   << discount*std::min(forward, strike));
+        if (beta == 0.0)
+            return 0.0;
+
+        Real b, bUpper;
+        // below the inflection point sqrt(-2x) the logarithm of the
+        // price is close to linear, above it the logarithm of the
+        // distance from the upper bound
+        bool lower = false;
+        if (x < 0.0) {
+            detail::normalizedBlackCall(x, std::sqrt(-2.0*x), b, bUpper);
+            lower = beta <= b;
+        }
+
+        Real s = blackFormulaImpliedStdDevApproximationRS(
+                                Option::Call, 1.0/bMax, bMax, beta, 1.0, 0.0);
+        if (!(s > 0.0 && s < QL_MAX_REAL))
+            s = std::sqrt(-2.0*x) + 1.0;
+        if (lower) {
+            // deep in the lower wing, b ~ phi(x/s) s^3/x^2 for small s;
+            // the guess is kept if it reproduces the price better
+            const Real logBeta = std::log(beta);
+            Real sw = -x/std::sqrt(-2.0*logBeta);
+            for (Size k=0; k<3; ++k) {
+                const Real l = 3.0*std::log(sw) - 2.0*std::log(-x)
+                    - 0.5*std::log(2.0*M_PI) - logBeta;
+                if (!(l > 0.0))
+                    break;
+                sw = -x/std::sqrt(2.0*l);
+            }
+            Real bw, bs, upper;
+            detail::normalizedBlackCall(x, sw, bw, upper);
+            detail::normalizedBlackCall(x, s, bs, upper);
+            if (bw > 0.0 && (bs == 0.0
+                || std::fabs(std::log(bw/beta))
+                   < std::fabs(std::log(bs/beta))))
+                s = sw;
+        }
+
+        for (Natural i=0; i<maxIterations; ++i) {
+            detail::normalizedBlackCall(x, s, b, bUpper);
+            if (lower && b == 0.0) {
+                // underflow: the guess is far too low
+                s *= 2.0;
+                continue;
+            }
+            const Real x2 = x*x/(s*s);
+            // b', b''/b' and b'''/b'
+            const Real vega =
+                M_1_SQRTPI*M_SQRT1_2*std::exp(-0.5*(x2+0.25*s*s));
+            const Real r2 = x2/s - 0.25*s;
+            const Real r3 = r2*r2 - 3.0*x2/(s*s) - 0.25;
+            Real nu, h2, h3;
+            if (lower) {
+                // g = log(b) - log(beta)
+                const Real q = vega/b;
+                nu = -std::log(b/beta)/q;
+                h2 = r2 - q;
+                h3 = r3 - 3.0*r2*q + 2.0*q*q;
+            } else {
+                // g = log(bMax-beta) - log(bMax-b)
+                const Real q = vega/bUpper;
+                nu = std::log(bUpper/(bMax-beta))/q;
+                h2 = r2 + q;
+                h3 = r3 + 3.0*r2*q + 2.0*q*q;
+            }
+            const Real ds = detail::householderStep(nu, h2, h3);
+            if (s + ds <= 0.0) {
+                s *= 0.5;
+                continue;
+            }
+            s += ds;
+            if (std::fabs(ds) < accuracy)
+                return s;
+        }
+        QL_FAIL("maximum number of iterations (" << maxIterations
+                << ") exceeded");
+    }
+
+    inline std::vector<Real> blackFormulaImpliedStdDevHouseholder(
+                                    Option::Type optionType,
+                                    const std::vector<Real>& strikes,
+                                    const std::vector<Real>& forwards,
+                                    const std::vector<Real>& blackPrices,
+                                    const std::vector<Real>& discounts,
+                                    Real displacement,
+                                    Real accuracy,
+                                    Natural maxIterations) {
+        const Size n = strikes.size();
+        QL_REQUIRE(forwards.size() == n && blackPrices.size() == n
+                   && discounts.size() == n,
+                   "strikes (" << n << "), forwards (" << forwards.size()
+                   << "), prices (" << blackPrices.size()
+                   << ") and discounts (" << discounts.size()
+                   << ") have different sizes");
+        std::vector<Real> stdDevs(n);
+        for (Size i=0; i<n; ++i) {
+            try {
+                stdDevs[i] = blackFormulaImpliedStdDevHouseholder(
+                                optionType, strikes[i], forwards[i],
+                                blackPrices[i], discounts[i], displacement,
+                                accuracy, maxIterations);
+            } catch (Error&) {
+                stdDevs[i] = Null<Real>();
+            }
+        }
+        return stdDevs;
+    }
+
 
     inline Real blackFormulaCashItmProbability(Option::Type optionType,
                                         Real strike,
@@ -1020,6 +1379,60 @@ namespace QuantLib {
             payoff->strike(), forward, stdDev, discount);
     }
 
+    inline std::vector<Real> bachelierBlackFormula(
+                                   Option::Type optionType,
+                                   const std::vector<Real>& strikes,
+                                   const std::vector<Real>& forwards,
+                                   const std::vector<Real>& stdDevs,
+                                   const std::vector<Real>& discounts) {
+        const Size n = strikes.size();
+        QL_REQUIRE(forwards.size() == n && stdDevs.size() == n
+                   && discounts.size() == n,
+                   "strikes (" << n << "), forwards (" << forwards.size()
+                   << "), standard deviations (" << stdDevs.size()
+                   << ") and discounts (" << discounts.size()
+                   << ") have different sizes");
+        for (Size i=0; i<n; ++i) {
+            QL_REQUIRE(stdDevs[i]>=0.0,
+                       "stdDev (" << stdDevs[i] << ") must be non-negative");
+            QL_REQUIRE(discounts[i]>0.0,
+                       "discount (" << discounts[i] << ") must be positive");
+        }
+
+        std::vector<Real> result(n);
+        CumulativeNormalDistribution phi;
+        // the options are processed in blocks small enough for the
+        // intermediate results to stay in cache
+        const Size blockSize = 256;
+        Real h[blockSize], nh[blockSize];
+        for (Size i0=0; i0<n; i0+=blockSize) {
+            const Size m = std::min(blockSize, n-i0);
+            for (Size j=0; j<m; ++j) {
+                const Real d = (forwards[i0+j]-strikes[i0+j])*optionType;
+                h[j] = stdDevs[i0+j] > 0.0 ? d/stdDevs[i0+j] : 0.0;
+            }
+            phi(h, nh, m);
+            for (Size j=0; j<m; ++j) {
+                const Size i = i0+j;
+                const Real d = (forwards[i]-strikes[i])*optionType;
+                // stdDev times the normal density at h
+                const Real sn =
+                    stdDevs[i]*M_SQRT_2*M_1_SQRTPI*std::exp(-0.5*h[j]*h[j]);
+                result[i] = stdDevs[i] > 0.0 ?
+                    discounts[i]*(sn + d*nh[j]) :
+                    discounts[i]*std::max(d, 0.0);
+            }
+        }
+        for (Size i=0; i<n; ++i)
+            QL_ENSURE(result[i]>=0.0,
+                      "negative value (" << result[i] << ") for " <<
+                      stdDevs[i] << " stdDev, " <<
+                      optionType << " option, " <<
+                      strikes[i] << " strike , " <<
+                      forwards[i] << " forward");
+        return result;
+    }
+
     static Real h(Real eta) {
 
         const static Real  A0          = 3.994961687345134e-1;
@@ -1094,6 +1507,103 @@ namespace QuantLib {
         return impliedBpvol;
     }
 
+    inline Real bachelierBlackFormulaImpliedStdDevHouseholder(
+                                   Option::Type optionType,
+                                   Real strike,
+                                   Real forward,
+                                   Real bachelierPrice,
+                                   Real discount,
+                                   Real accuracy,
+                                   Natural maxIterations) {
+        QL_REQUIRE(discount>0.0,
+                   "discount (" << discount << ") must be positive");
+        QL_REQUIRE(bachelierPrice>=0.0,
+                   "option price (" << bachelierPrice
+                   << ") must be non-negative");
+        // check the price of the "other" option implied by put-call parity
+        Real otherOptionPrice =
+            bachelierPrice - optionType*(forward-strike)*discount;
+        QL_REQUIRE(otherOptionPrice>=0.0,
+                   "negative " << Option::Type(-1*optionType) <<
+                   " price (" << otherOptionPrice <<
+                   ") implied by put-call parity. No solution exists for " <<
+                   optionType << " strike " << strike <<
+                   ", forward " << forward <<
+                   ", price " << bachelierPrice <<
+                   ", deflator " << discount);
+
+        // undiscounted out-of-the-money price
+        // p = s phi(d/s) - d N(-d/s)
+        const Real p = ((optionType == Option::Call) == (strike >= forward)
+                        ? bachelierPrice : otherOptionPrice)/discount;
+        const Real d = std::fabs(forward-strike);
+        if (p == 0.0)
+            return 0.0;
+        if (d == 0.0)
+            return p*M_SQRTPI*M_SQRT2;
+
+        Real s = bachelierBlackFormulaImpliedVol(Option::Call, d, 0.0, 1.0, p);
+        if (!(s > 0.0 && s < QL_MAX_REAL))
+            s = d;
+
+        for (Natural i=0; i<maxIterations; ++i) {
+            const Real u = d/s;
+            const Real vega = M_1_SQRTPI*M_SQRT1_2*std::exp(-0.5*u*u);
+            const Real ps = s*vega - d*detail::tailCumulativeNormal(-u);
+            if (ps <= 0.0) {
+                // underflow: the guess is far too low
+                s *= 2.0;
+                continue;
+            }
+            // g = log(ps) - log(p), with p''/p' and p'''/p'
+            const Real r2 = u*u/s;
+            const Real r3 = u*u/(s*s)*(u*u-3.0);
+            const Real q = vega/ps;
+            const Real nu = -std::log(ps/p)/q;
+            const Real h2 = r2 - q;
+            const Real h3 = r3 - 3.0*r2*q + 2.0*q*q;
+            const Real ds = detail::householderStep(nu, h2, h3);
+            if (s + ds <= 0.0) {
+                s *= 0.5;
+                continue;
+            }
+            s += ds;
+            if (std::fabs(ds) < accuracy)
+                return s;
+        }
+        QL_FAIL("maximum number of iterations (" << maxIterations
+                << ") exceeded");
+    }
+
+    inline std::vector<Real> bachelierBlackFormulaImpliedStdDevHouseholder(
+                                   Option::Type optionType,
+                                   const std::vector<Real>& strikes,
+                                   const std::vector<Real>& forwards,
+                                   const std::vector<Real>& bachelierPrices,
+                                   const std::vector<Real>& discounts,
+                                   Real accuracy,
+                                   Natural maxIterations) {
+        const Size n = strikes.size();
+        QL_REQUIRE(forwards.size() == n && bachelierPrices.size() == n
+                   && discounts.size() == n,
+                   "strikes (" << n << "), forwards (" << forwards.size()
+                   << "), prices (" << bachelierPrices.size()
+                   << ") and discounts (" << discounts.size()
+                   << ") have different sizes");
+        std::vector<Real> stdDevs(n);
+        for (Size i=0; i<n; ++i) {
+            try {
+                stdDevs[i] = bachelierBlackFormulaImpliedStdDevHouseholder(
+                                optionType, strikes[i], forwards[i],
+                                bachelierPrices[i], discounts[i],
+                                accuracy, maxIterations);
+            } catch (Error&) {
+                stdDevs[i] = Null<Real>();
+            }
+        }
+        return stdDevs;
+    }
+
 
         inline Real bachelierBlackFormulaStdDevDerivative(Rate strike,
                                       Rate forward,
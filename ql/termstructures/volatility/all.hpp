@@ -8,6 +8,7 @@
 //#include <ql/termstructures/volatility/kahalesmilesection.hpp>
 #include <ql/termstructures/volatility/sabr.hpp>
 //#include <ql/termstructures/volatility/sabrinterpolatedsmilesection.hpp>
+#include <ql/termstructures/volatility/sabrsmilecalibration.hpp>
 #include <ql/termstructures/volatility/sabrsmilesection.hpp>
 #include <ql/termstructures/volatility/smilesection.hpp>
 //#include <ql/termstructures/volatility/smilesectionutils.hpp>
@@ -67,9 +67,24 @@ namespace QuantLib {
         void setInterpolation(const Interpolator& i = Interpolator()) {
             varianceCurve_ = i.interpolate(times_.begin(), times_.end(),
                                            variances_.begin());
+            varianceCurve_.enableLocalityHint(localityHint_);
             varianceCurve_.update();
             notifyObservers();
         }
+        /*! Makes the variance lookups start from the interval of the
+            previous one, which is faster when consecutive queries
+            are at nearby times, as those of LocalVolCurve and
+            LocalVolSurface.
+
+            \warning the hint is cached by the curve, which can then
+                     no longer be used concurrently from several
+                     threads; for this reason it is disabled by
+                     default.
+        */
+        void enableLocalityHint(bool flag = true) {
+            localityHint_ = flag;
+            varianceCurve_.enableLocalityHint(flag);
+        }
         //@}
         //! \name Visitability
         //@{
@@ -83,6 +98,7 @@ namespace QuantLib {
         std::vector<Time> times_;
         std::vector<Real> variances_;
         Interpolation varianceCurve_;
+        bool localityHint_;
     };
 
 
@@ -142,7 +158,8 @@ namespace QuantLib {
                                  const DayCounter& dayCounter,
                                  bool forceMonotoneVariance)
     : BlackVarianceTermStructure(referenceDate),
-      dayCounter_(dayCounter), maxDate_(dates.back()) {
+      dayCounter_(dayCounter), maxDate_(dates.back()),
+      localityHint_(false) {
 
         QL_REQUIRE(dates.size()==blackVolCurve.size(),
                    "mismatch between date vector and black vol vector");
@@ -70,6 +70,46 @@ namespace QuantLib {
                                 Real nu,
                                 Real rho);
 
+    /*! sets result[i] to the %SABR volatility at strikes[i] for i in
+        [0,n); the terms that do not depend on the strike are computed
+        once for all strikes.  The strikes and forward are shifted by
+        the given amount, as in unsafeShiftedSabrVolatility.
+    */
+    void unsafeSabrVolatilities(const Rate* strikes,
+                                Size n,
+                                Rate forward,
+                                Time expiryTime,
+                                Real alpha,
+                                Real beta,
+                                Real nu,
+                                Real rho,
+                                Real* result,
+                                Real shift = 0.0);
+
+    void sabrVolatilities(const Rate* strikes,
+                          Size n,
+                          Rate forward,
+                          Time expiryTime,
+                          Real alpha,
+                          Real beta,
+                          Real nu,
+                          Real rho,
+                          Real* result,
+                          Real shift = 0.0);
+
+    /*! returns the same as unsafeSabrVolatility and sets gradient[0],
+        ..., gradient[3] to its derivatives with respect to alpha,
+        beta, nu and rho.
+    */
+    Real unsafeSabrVolatilityGradient(Rate strike,
+                                      Rate forward,
+                                      Time expiryTime,
+                                      Real alpha,
+                                      Real beta,
+                                      Real nu,
+                                      Real rho,
+                                      Real* gradient);
+
 }
 
 
@@ -207,6 +247,152 @@ namespace QuantLib {
                                              alpha, beta, nu, rho,shift);
     }
 
+    inline void unsafeSabrVolatilities(const Rate* strikes,
+                                       Size n,
+                                       Rate forward,
+                                       Time expiryTime,
+                                       Real alpha,
+                                       Real beta,
+                                       Real nu,
+                                       Real rho,
+                                       Real* result,
+                                       Real shift) {
+        const Real f = forward + shift;
+        const Real oneMinusBeta = 1.0-beta;
+        const Real logF = std::log(f);
+        const Real nuOverAlpha = nu/alpha;
+        const Real d1 = expiryTime *
+            oneMinusBeta*oneMinusBeta*alpha*alpha/24.0;
+        const Real d2 = expiryTime * 0.25*rho*beta*nu*alpha;
+        const Real d3 = 1.0 + expiryTime * (2.0-3.0*rho*rho)*(nu*nu/24.0);
+        static const Real m = 10;
+        for (Size i=0; i<n; ++i) {
+            const Real k = strikes[i] + shift;
+            const Real logK = std::log(k);
+            // A = (fk)^(1-beta) and its square root
+            const Real sqrtA = std::exp(0.5*oneMinusBeta*(logF+logK));
+            const Real A = sqrtA*sqrtA;
+            Real logM;
+            if (!close(f, k))
+                logM = logF - logK;
+            else {
+                const Real epsilon = (f-k)/k;
+                logM = epsilon - .5 * epsilon * epsilon ;
+            }
+            const Real z = nuOverAlpha*sqrtA*logM;
+            const Real C = oneMinusBeta*oneMinusBeta*logM*logM;
+            const Real D = sqrtA*(1.0+C/24.0+C*C/1920.0);
+            const Real d = d3 + d1/A + d2/sqrtA;
+            Real multiplier;
+            if (std::fabs(z*z)>QL_EPSILON * m) {
+                const Real B = 1.0-2.0*rho*z+z*z;
+                const Real xx = std::log((std::sqrt(B)+z-rho)/(1.0-rho));
+                multiplier = z/xx;
+            } else {
+                multiplier = 1.0 - 0.5*rho*z - (3.0*rho*rho-2.0)*z*z/12.0;
+            }
+            result[i] = (alpha/D)*multiplier*d;
+        }
+    }
+
+    inline void sabrVolatilities(const Rate* strikes,
+                                 Size n,
+                                 Rate forward,
+                                 Time expiryTime,
+                                 Real alpha,
+                                 Real beta,
+                                 Real nu,
+                                 Real rho,
+                                 Real* result,
+                                 Real shift) {
+        for (Size i=0; i<n; ++i)
+            QL_REQUIRE(strikes[i] + shift > 0.0,
+                       "strike+shift must be positive: "
+                       << io::rate(strikes[i]) << "+" << io::rate(shift)
+                       << " not allowed");
+        QL_REQUIRE(forward + shift > 0.0,
+                   "at the money forward rate + shift must be "
+                   "positive: " << io::rate(forward) << " "
+                   << io::rate(shift) << " not allowed");
+        QL_REQUIRE(expiryTime>=0.0, "expiry time must be non-negative: "
+                                   << expiryTime << " not allowed");
+        validateSabrParameters(alpha, beta, nu, rho);
+        unsafeSabrVolatilities(strikes, n, forward, expiryTime,
+                               alpha, beta, nu, rho, result, shift);
+    }
+
+    inline Real unsafeSabrVolatilityGradient(Rate strike,
+                                             Rate forward,
+                                             Time expiryTime,
+                                             Real alpha,
+                                             Real beta,
+                                             Real nu,
+                                             Real rho,
+                                             Real* gradient) {
+        const Real oneMinusBeta = 1.0-beta;
+        const Real logFK = std::log(forward*strike);
+        const Real A = std::pow(forward*strike, oneMinusBeta);
+        const Real sqrtA= std::sqrt(A);
+        Real logM;
+        if (!close(forward, strike))
+            logM = std::log(forward/strike);
+        else {
+            const Real epsilon = (forward-strike)/strike;
+            logM = epsilon - .5 * epsilon * epsilon ;
+        }
+        const Real z = (nu/alpha)*sqrtA*logM;
+        const Real C = oneMinusBeta*oneMinusBeta*logM*logM;
+        const Real D0 = 1.0+C/24.0+C*C/1920.0;
+        const Real D = sqrtA*D0;
+        const Real d = 1.0 + expiryTime *
+            (oneMinusBeta*oneMinusBeta*alpha*alpha/(24.0*A)
+                                + 0.25*rho*beta*nu*alpha/sqrtA
+                                    +(2.0-3.0*rho*rho)*(nu*nu/24.0));
+
+        // multiplier and its partial derivatives in z and rho
+        Real multiplier, dMdz, dMdRho;
+        static const Real m = 10;
+        if (std::fabs(z*z)>QL_EPSILON * m) {
+            const Real sqrtB = std::sqrt(1.0-2.0*rho*z+z*z);
+            const Real xx = std::log((sqrtB+z-rho)/(1.0-rho));
+            multiplier = z/xx;
+            dMdz = (xx-z/sqrtB)/(xx*xx);
+            const Real dxxdRho =
+                1.0/(1.0-rho) - (z/sqrtB+1.0)/(sqrtB+z-rho);
+            dMdRho = -z*dxxdRho/(xx*xx);
+        } else {
+            multiplier = 1.0 - 0.5*rho*z - (3.0*rho*rho-2.0)*z*z/12.0;
+            dMdz = -0.5*rho - (3.0*rho*rho-2.0)*z/6.0;
+            dMdRho = -0.5*z - 0.5*rho*z*z;
+        }
+
+        // derivatives of z, D and d
+        const Real dzdAlpha = -z/alpha;
+        const Real dzdBeta = -0.5*z*logFK;
+        const Real dzdNu = sqrtA*logM/alpha;
+        const Real dDdBeta = -0.5*sqrtA*logFK*D0
+            - sqrtA*(1.0/24.0+C/960.0)*2.0*oneMinusBeta*logM*logM;
+        const Real dddAlpha = expiryTime *
+            (oneMinusBeta*oneMinusBeta*alpha/(12.0*A)
+             + 0.25*rho*beta*nu/sqrtA);
+        const Real dddBeta = expiryTime *
+            (alpha*alpha/24.0*oneMinusBeta*(oneMinusBeta*logFK-2.0)/A
+             + 0.25*rho*nu*alpha*(1.0+0.5*beta*logFK)/sqrtA);
+        const Real dddNu = expiryTime *
+            (0.25*rho*beta*alpha/sqrtA + (2.0-3.0*rho*rho)*nu/12.0);
+        const Real dddRho = expiryTime *
+            (0.25*beta*nu*alpha/sqrtA - 0.25*rho*nu*nu);
+
+        const Real g = alpha/D;
+        gradient[0] = multiplier*d/D
+            + g*(dMdz*dzdAlpha*d + multiplier*dddAlpha);
+        gradient[1] = -g*dDdBeta/D*multiplier*d
+            + g*(dMdz*dzdBeta*d + multiplier*dddBeta);
+        gradient[2] = g*(dMdz*dzdNu*d + multiplier*dddNu);
+        gradient[3] = g*(dMdRho*d + multiplier*dddRho);
+        return g*multiplier*d;
+    }
+
 }
 
-#endif
\ No newline at end of file
+#endif
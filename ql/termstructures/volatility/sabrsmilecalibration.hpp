@@ -0,0 +1,269 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file sabrsmilecalibration.hpp
+    \brief SABR calibration of a grid of smiles
+*/
+
+#ifndef quantlib_sabr_smile_calibration_hpp
+#define quantlib_sabr_smile_calibration_hpp
+
+#include <ql/termstructures/volatility/sabrsmilesection.hpp>
+#include <ql/math/interpolations/sabrinterpolation.hpp>
+#include <ql/math/primenumbers.hpp>
+#include <ql/utilities/null.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+
+    //! %SABR calibration of a grid of smiles
+    /*! The smiles are arranged in a grid whose rows correspond to
+        the option expiries and whose columns correspond to, e.g.,
+        the swap tenors of a swaption volatility structure.  Each
+        smile is fitted by a SABRInterpolation; the columns are
+        calibrated independently of each other, while within a
+        column the parameters calibrated at an expiry are used as
+        the starting point of the optimization at the next one.
+        The result is the same whatever the order in which the
+        columns are processed; if the library is compiled with
+        OpenMP enabled, they are distributed among threads.
+
+        The calibrated smiles are returned as SabrSmileSection
+        instances, which can be used as the smile sections of a
+        SwaptionVolatilityStructure.
+
+        \test the calibrated parameters are checked against the ones
+              used to generate the smiles.
+    */
+    class SabrSmileCalibration {
+      public:
+        /*! strikes[i][j] and volatilities[i][j] are the market smile
+            at the expiry i and column j, forwards[i][j] its forward.
+            Null parameters are initialized with the defaults of
+            SABRInterpolation at the first expiry of each column.
+        */
+        SabrSmileCalibration(
+            const std::vector<Time>& expiries,
+            const std::vector<std::vector<Rate> >& forwards,
+            const std::vector<std::vector<std::vector<Rate> > >& strikes,
+            const std::vector<std::vector<std::vector<Volatility> > >&
+                                                              volatilities,
+            Real alpha = Null<Real>(),
+            Real beta = Null<Real>(),
+            Real nu = Null<Real>(),
+            Real rho = Null<Real>(),
+            bool alphaIsFixed = false,
+            bool betaIsFixed = false,
+            bool nuIsFixed = false,
+            bool rhoIsFixed = false,
+            bool vegaWeighted = true,
+            Real errorAccept = 0.0020,
+            bool useMaxError = false,
+            Size maxGuesses = 50,
+            Real shift = 0.0);
+        //! calibrates all the smiles
+        void compute();
+        //! \name Inspectors
+        //@{
+        Size rows() const { return expiries_.size(); }
+        Size columns() const { return forwards_.front().size(); }
+        //! alpha, beta, nu and rho calibrated at the node (i,j)
+        const std::vector<Real>& parameters(Size i, Size j) const;
+        Real rmsError(Size i, Size j) const;
+        Real maxError(Size i, Size j) const;
+        const boost::shared_ptr<SabrSmileSection>&
+        smileSection(Size i, Size j) const;
+        //@}
+      private:
+        void calibrateColumn(Size j);
+        void checkCalibrated() const;
+        std::vector<Time> expiries_;
+        std::vector<std::vector<Rate> > forwards_;
+        std::vector<std::vector<std::vector<Rate> > > strikes_;
+        std::vector<std::vector<std::vector<Volatility> > > volatilities_;
+        std::vector<Real> guess_;
+        std::vector<bool> isFixed_;
+        bool vegaWeighted_;
+        Real errorAccept_;
+        bool useMaxError_;
+        Size maxGuesses_;
+        Real shift_;
+        bool calibrated_;
+        std::vector<std::vector<std::vector<Real> > > parameters_;
+        std::vector<std::vector<Real> > rmsErrors_, maxErrors_;
+        std::vector<std::vector<boost::shared_ptr<SabrSmileSection> > >
+                                                           smileSections_;
+    };
+
+
+    // inline definitions
+
+    inline SabrSmileCalibration::SabrSmileCalibration(
+            const std::vector<Time>& expiries,
+            const std::vector<std::vector<Rate> >& forwards,
+            const std::vector<std::vector<std::vector<Rate> > >& strikes,
+            const std::vector<std::vector<std::vector<Volatility> > >&
+                                                              volatilities,
+            Real alpha, Real beta, Real nu, Real rho,
+            bool alphaIsFixed, bool betaIsFixed,
+            bool nuIsFixed, bool rhoIsFixed,
+            bool vegaWeighted, Real errorAccept, bool useMaxError,
+            Size maxGuesses, Real shift)
+    : expiries_(expiries), forwards_(forwards), strikes_(strikes),
+      volatilities_(volatilities), guess_(4), isFixed_(4),
+      vegaWeighted_(vegaWeighted), errorAccept_(errorAccept),
+      useMaxError_(useMaxError), maxGuesses_(maxGuesses), shift_(shift),
+      calibrated_(false) {
+        QL_REQUIRE(!expiries_.empty(), "no expiries given");
+        QL_REQUIRE(forwards_.size() == expiries_.size()
+                   && strikes_.size() == expiries_.size()
+                   && volatilities_.size() == expiries_.size(),
+                   "number of rows of forwards (" << forwards_.size()
+                   << "), strikes (" << strikes_.size()
+                   << ") and volatilities (" << volatilities_.size()
+                   << ") must match the number of expiries ("
+                   << expiries_.size() << ")");
+        const Size n = forwards_.front().size();
+        QL_REQUIRE(n > 0, "no columns given");
+        for (Size i=0; i<expiries_.size(); ++i) {
+            QL_REQUIRE(forwards_[i].size() == n
+                       && strikes_[i].size() == n
+                       && volatilities_[i].size() == n,
+                       "row " << i << ": the number of columns must be "
+                       << n << " for forwards, strikes and volatilities");
+            for (Size j=0; j<n; ++j)
+                QL_REQUIRE(strikes_[i][j].size()
+                           == volatilities_[i][j].size(),
+                           "node (" << i << "," << j << "): number of "
+                           "strikes (" << strikes_[i][j].size()
+                           << ") does not match the number of "
+                           "volatilities ("
+                           << volatilities_[i][j].size() << ")");
+        }
+        guess_[0] = alpha;
+        guess_[1] = beta;
+        guess_[2] = nu;
+        guess_[3] = rho;
+        isFixed_[0] = alphaIsFixed;
+        isFixed_[1] = betaIsFixed;
+        isFixed_[2] = nuIsFixed;
+        isFixed_[3] = rhoIsFixed;
+    }
+
+    inline void SabrSmileCalibration::compute() {
+        const Size m = rows(), n = columns();
+        parameters_.assign(m, std::vector<std::vector<Real> >(n));
+        rmsErrors_.assign(m, std::vector<Real>(n));
+        maxErrors_.assign(m, std::vector<Real>(n));
+        calibrated_ = false;
+
+        // the lazy initializations of the prime numbers used by the
+        // Halton guesses must not happen concurrently
+        PrimeNumbers::instance().get(guess_.size());
+
+        std::vector<std::string> errors(n);
+        const long nColumns = static_cast<long>(n);
+        #if defined(_OPENMP)
+        #pragma omp parallel for schedule(dynamic) if (nColumns > 1)
+        #endif
+        for (long j=0; j<nColumns; ++j) {
+            try {
+                calibrateColumn(j);
+            } catch (std::exception& e) {
+                errors[j] = e.what();
+            } catch (...) {
+                errors[j] = "unknown error";
+            }
+        }
+        for (Size j=0; j<n; ++j)
+            QL_REQUIRE(errors[j].empty(),
+                       "could not calibrate column " << j << ": "
+                       << errors[j]);
+
+        smileSections_.assign(
+            m, std::vector<boost::shared_ptr<SabrSmileSection> >(n));
+        for (Size i=0; i<m; ++i)
+            for (Size j=0; j<n; ++j)
+                smileSections_[i][j] = boost::shared_ptr<SabrSmileSection>(
+                    new SabrSmileSection(expiries_[i], forwards_[i][j],
+                                         parameters_[i][j], shift_));
+        calibrated_ = true;
+    }
+
+    inline void SabrSmileCalibration::calibrateColumn(Size j) {
+        std::vector<Real> guess(guess_);
+        for (Size i=0; i<rows(); ++i) {
+            SABRInterpolation sabr(strikes_[i][j].begin(),
+                                   strikes_[i][j].end(),
+                                   volatilities_[i][j].begin(),
+                                   expiries_[i], forwards_[i][j],
+                                   guess[0], guess[1], guess[2], guess[3],
+                                   isFixed_[0], isFixed_[1],
+                                   isFixed_[2], isFixed_[3],
+                                   vegaWeighted_,
+                                   boost::shared_ptr<EndCriteria>(),
+                                   boost::shared_ptr<OptimizationMethod>(),
+                                   errorAccept_, useMaxError_,
+                                   maxGuesses_, shift_);
+            sabr.update();
+            std::vector<Real>& p = parameters_[i][j];
+            p.resize(4);
+            p[0] = sabr.alpha();
+            p[1] = sabr.beta();
+            p[2] = sabr.nu();
+            p[3] = sabr.rho();
+            rmsErrors_[i][j] = sabr.rmsError();
+            maxErrors_[i][j] = sabr.maxError();
+            // warm start at the next expiry; null parameters are free
+            for (Size k=0; k<4; ++k)
+                if (!isFixed_[k] || guess_[k] == Null<Real>())
+                    guess[k] = p[k];
+        }
+    }
+
+    inline void SabrSmileCalibration::checkCalibrated() const {
+        QL_REQUIRE(calibrated_, "smiles not calibrated; call compute()");
+    }
+
+    inline const std::vector<Real>&
+    SabrSmileCalibration::parameters(Size i, Size j) const {
+        checkCalibrated();
+        return parameters_[i][j];
+    }
+
+    inline Real SabrSmileCalibration::rmsError(Size i, Size j) const {
+        checkCalibrated();
+        return rmsErrors_[i][j];
+    }
+
+    inline Real SabrSmileCalibration::maxError(Size i, Size j) const {
+        checkCalibrated();
+        return maxErrors_[i][j];
+    }
+
+    inline const boost::shared_ptr<SabrSmileSection>&
+    SabrSmileCalibration::smileSection(Size i, Size j) const {
+        checkCalibrated();
+        return smileSections_[i][j];
+    }
+
+}
+
+
+#endif
@@ -91,6 +91,16 @@
 //#    define QL_ENABLE_PARALLEL_UNIT_TEST_RUNNER
 #endif
 
+/* Define this to evaluate the array version of the cumulative normal
+   distribution, used by the array Black and Bachelier formulas, with
+   branch-free approximations that the compiler can vectorize. This
+   pays off only if the code is compiled with vectorization of exp()
+   enabled (e.g., -O3 -ffast-math with gcc on AVX2 targets); otherwise
+   it is slower than the scalar version. */
+#ifndef QL_ENABLE_VECTORIZED_NORMAL_DISTRIBUTION
+//#   define QL_ENABLE_VECTORIZED_NORMAL_DISTRIBUTION
+#endif
+
 /* Define this to make Singleton initialization thread-safe.
    Note: There is no support for thread safety and multiple sessions.
 */
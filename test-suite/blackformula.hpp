@@ -28,6 +28,11 @@ class BlackFormulaTest {
   public:
     static void testBachelierImpliedVol();
     static void testChambersImpliedVol();
+    static void testHouseholderImpliedStdDev();
+    static void testBachelierHouseholderImpliedStdDev();
+    static void testHouseholderImpliedStdDevInTheWings();
+    static void testArrayFormulas();
+    static void testBatchBlackCalculator();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -54,6 +59,7 @@ class BlackFormulaTest {
 
 #include "utilities.hpp"
 #include <ql/pricingengines/blackformula.hpp>
+#include <ql/pricingengines/blackcalculator.hpp>
 
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
@@ -149,6 +155,353 @@ void BlackFormulaTest::testChambersImpliedVol() {
     }
 }
 
+void BlackFormulaTest::testHouseholderImpliedStdDev() {
+
+    BOOST_TEST_MESSAGE("Testing Householder implied standard deviation...");
+
+    Option::Type types[] = {Option::Call, Option::Put};
+    Real displacements[] = {0.0000, 0.0100};
+    Real forward = 0.0300;
+    Real strikes[] = {0.0150, 0.0250, 0.0300, 0.0350, 0.0500, 0.1000};
+    Real stdDevs[] = {0.20, 0.30, 0.50, 1.00, 2.00};
+    Real discount = 0.95;
+
+    // the premia calculated by blackFormula are less accurate than
+    // the inversion in the wings
+    Real tol = 1.0e-7;
+
+    for (Size i1 = 0; i1 < LENGTH(types); ++i1) {
+        for (Size i2 = 0; i2 < LENGTH(displacements); ++i2) {
+            std::vector<Real> k, f, p, df, expected;
+            for (Size i3 = 0; i3 < LENGTH(strikes); ++i3) {
+                for (Size i4 = 0; i4 < LENGTH(stdDevs); ++i4) {
+                    Real premium = blackFormula(
+                        types[i1], strikes[i3], forward, stdDevs[i4],
+                        discount, displacements[i2]);
+                    Real iStdDev = blackFormulaImpliedStdDevHouseholder(
+                        types[i1], strikes[i3], forward, premium,
+                        discount, displacements[i2]);
+                    Real error = std::fabs(iStdDev - stdDevs[i4]);
+                    if (error > tol*stdDevs[i4])
+                        BOOST_ERROR("failed to recover the standard deviation"
+                                    " for " << types[i1]
+                                    << " displacement=" << displacements[i2]
+                                    << " strike=" << strikes[i3]
+                                    << "\n    expected:   " << stdDevs[i4]
+                                    << "\n    calculated: " << iStdDev
+                                    << "\n    error:      " << error);
+                    k.push_back(strikes[i3]);
+                    f.push_back(forward);
+                    p.push_back(premium);
+                    df.push_back(discount);
+                    expected.push_back(iStdDev);
+                }
+            }
+            // a price above the discounted forward admits no solution
+            k.push_back(0.0300);
+            f.push_back(forward);
+            p.push_back(forward + displacements[i2]);
+            df.push_back(discount);
+            expected.push_back(Null<Real>());
+
+            std::vector<Real> calculated =
+                blackFormulaImpliedStdDevHouseholder(types[i1], k, f, p, df,
+                                                     displacements[i2]);
+            for (Size i = 0; i < calculated.size(); ++i) {
+                if (calculated[i] != expected[i])
+                    BOOST_ERROR("array and scalar versions differ for "
+                                << types[i1] << " strike=" << k[i]
+                                << " price=" << p[i]
+                                << "\n    scalar: " << expected[i]
+                                << "\n    array:  " << calculated[i]);
+            }
+        }
+    }
+}
+
+void BlackFormulaTest::testBachelierHouseholderImpliedStdDev() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing Householder Bachelier implied standard deviation...");
+
+    Option::Type types[] = {Option::Call, Option::Put};
+    Real forward = 0.0100;
+    Real strikes[] = {-0.0050, 0.0050, 0.0100, 0.0150, 0.0300};
+    Real stdDevs[] = {0.0050, 0.0100, 0.0300};
+    Real discount = 0.95;
+
+    Real tol = 1.0e-8;
+
+    for (Size i1 = 0; i1 < LENGTH(types); ++i1) {
+        std::vector<Real> k, f, p, df;
+        for (Size i2 = 0; i2 < LENGTH(strikes); ++i2) {
+            for (Size i3 = 0; i3 < LENGTH(stdDevs); ++i3) {
+                Real premium = bachelierBlackFormula(
+                    types[i1], strikes[i2], forward, stdDevs[i3], discount);
+                Real iStdDev = bachelierBlackFormulaImpliedStdDevHouseholder(
+                    types[i1], strikes[i2], forward, premium, discount);
+                Real error = std::fabs(iStdDev - stdDevs[i3]);
+                if (error > tol*stdDevs[i3])
+                    BOOST_ERROR("failed to recover the standard deviation"
+                                " for " << types[i1]
+                                << " strike=" << strikes[i2]
+                                << "\n    expected:   " << stdDevs[i3]
+                                << "\n    calculated: " << iStdDev
+                                << "\n    error:      " << error);
+                k.push_back(strikes[i2]);
+                f.push_back(forward);
+                p.push_back(premium);
+                df.push_back(discount);
+            }
+        }
+        std::vector<Real> calculated =
+            bachelierBlackFormulaImpliedStdDevHouseholder(types[i1],
+                                                          k, f, p, df);
+        for (Size i = 0; i < calculated.size(); ++i) {
+            Real expected = bachelierBlackFormulaImpliedStdDevHouseholder(
+                types[i1], k[i], f[i], p[i], df[i]);
+            if (calculated[i] != expected)
+                BOOST_ERROR("array and scalar versions differ for "
+                            << types[i1] << " strike=" << k[i]
+                            << "\n    scalar: " << expected
+                            << "\n    array:  " << calculated[i]);
+        }
+    }
+}
+
+namespace {
+
+    // out-of-the-money Black price, accurate in the wings where
+    // blackFormula loses relative accuracy
+    Real outOfTheMoneyBlackPrice(Option::Type type, Real strike,
+                                 Real forward, Real stdDev) {
+        Real d1 = std::log(forward/strike)/stdDev + 0.5*stdDev;
+        Real d2 = d1 - stdDev;
+        Real w = type;
+        return w*(forward*0.5*boost::math::erfc(-w*d1*M_SQRT1_2)
+                  - strike*0.5*boost::math::erfc(-w*d2*M_SQRT1_2));
+    }
+
+}
+
+void BlackFormulaTest::testHouseholderImpliedStdDevInTheWings() {
+
+    BOOST_TEST_MESSAGE("Testing Householder implied standard deviation "
+                       "for deep out-of-the-money options...");
+
+    // out-of-the-money options with low standard deviations, whose
+    // prices can be as low as 1e-260
+    Real forward = 1.0;
+    Real logMoneyness[] = {-3.0, -1.75, -0.75, -0.3, -0.05,
+                           0.05, 0.3, 0.75, 1.75, 3.0};
+    Real stdDevs[] = {0.005, 0.0135, 0.03, 0.0512, 0.0665, 0.1, 0.2};
+
+    Real tol = 1.0e-9;
+
+    std::vector<Real> k, f, p, df, expected;
+    for (Size i1 = 0; i1 < LENGTH(logMoneyness); ++i1) {
+        Real strike = forward*std::exp(logMoneyness[i1]);
+        Option::Type type = strike > forward ? Option::Call : Option::Put;
+        for (Size i2 = 0; i2 < LENGTH(stdDevs); ++i2) {
+            Real premium = outOfTheMoneyBlackPrice(type, strike, forward,
+                                                   stdDevs[i2]);
+            if (premium < 1.0e-290)
+                continue;
+            Real iStdDev = blackFormulaImpliedStdDevHouseholder(
+                                      type, strike, forward, premium);
+            Real error = std::fabs(iStdDev - stdDevs[i2]);
+            if (error > tol*stdDevs[i2])
+                BOOST_ERROR("failed to recover the standard deviation"
+                            " for " << type
+                            << " strike=" << strike
+                            << " price=" << premium
+                            << "\n    expected:   " << stdDevs[i2]
+                            << "\n    calculated: " << iStdDev
+                            << "\n    error:      " << error);
+            k.push_back(strike);
+            f.push_back(forward);
+            p.push_back(premium);
+            df.push_back(1.0);
+            expected.push_back(stdDevs[i2]);
+        }
+    }
+
+    // the array version, the quotes of the other type having no
+    // solution
+    std::vector<Real> calls =
+        blackFormulaImpliedStdDevHouseholder(Option::Call, k, f, p, df);
+    std::vector<Real> puts =
+        blackFormulaImpliedStdDevHouseholder(Option::Put, k, f, p, df);
+    for (Size i = 0; i < k.size(); ++i) {
+        Real recovered = k[i] > f[i] ? calls[i] : puts[i];
+        if (recovered == Null<Real>()
+            || std::fabs(recovered - expected[i]) > tol*expected[i])
+            BOOST_ERROR("array version failed for strike=" << k[i]
+                        << " price=" << p[i]
+                        << "\n    expected:   " << expected[i]
+                        << "\n    calculated: " << recovered);
+    }
+
+    // the same for the Bachelier formula
+    Real strikes[] = {-0.05, -0.02, -0.005, 0.005, 0.02, 0.05};
+    Real bpStdDevs[] = {0.0002, 0.0005, 0.001, 0.003};
+    for (Size i1 = 0; i1 < LENGTH(strikes); ++i1) {
+        Option::Type type = strikes[i1] > 0.0 ? Option::Call : Option::Put;
+        for (Size i2 = 0; i2 < LENGTH(bpStdDevs); ++i2) {
+            Real premium = bachelierBlackFormula(type, strikes[i1], 0.0,
+                                                 bpStdDevs[i2]);
+            if (premium < 1.0e-290)
+                continue;
+            Real iStdDev = bachelierBlackFormulaImpliedStdDevHouseholder(
+                                      type, strikes[i1], 0.0, premium);
+            Real error = std::fabs(iStdDev - bpStdDevs[i2]);
+            if (error > tol*bpStdDevs[i2])
+                BOOST_ERROR("failed to recover the Bachelier standard "
+                            "deviation for " << type
+                            << " strike=" << strikes[i1]
+                            << " price=" << premium
+                            << "\n    expected:   " << bpStdDevs[i2]
+                            << "\n    calculated: " << iStdDev
+                            << "\n    error:      " << error);
+        }
+    }
+}
+
+void BlackFormulaTest::testArrayFormulas() {
+
+    BOOST_TEST_MESSAGE("Testing array Black and Bachelier formulas...");
+
+    Option::Type types[] = {Option::Call, Option::Put};
+    Real displacement = 0.0100;
+    Real forwards[] = {0.0100, 0.0300};
+    Real strikes[] = {-0.0100, 0.0050, 0.0300, 0.0500, 0.1000};
+    Real stdDevs[] = {0.00, 0.05, 0.20, 0.50, 1.00};
+    Real discount = 0.95;
+
+    Real tol = 1.0e-8;
+
+    for (Size i1 = 0; i1 < LENGTH(types); ++i1) {
+        std::vector<Real> k, f, s, df;
+        for (Size i2 = 0; i2 < LENGTH(forwards); ++i2) {
+            for (Size i3 = 0; i3 < LENGTH(strikes); ++i3) {
+                for (Size i4 = 0; i4 < LENGTH(stdDevs); ++i4) {
+                    k.push_back(strikes[i3]);
+                    f.push_back(forwards[i2]);
+                    s.push_back(stdDevs[i4]);
+                    df.push_back(discount);
+                }
+            }
+        }
+
+        std::vector<Real> black =
+            blackFormula(types[i1], k, f, s, df, displacement);
+        for (Size i = 0; i < black.size(); ++i) {
+            Real expected = blackFormula(types[i1], k[i], f[i], s[i],
+                                         df[i], displacement);
+            if (std::fabs(black[i]-expected) > tol*expected + 1.0e-15)
+                BOOST_ERROR("array and scalar Black formulas differ for "
+                            << types[i1] << " strike=" << k[i]
+                            << " forward=" << f[i] << " stdDev=" << s[i]
+                            << std::scientific
+                            << "\n    scalar: " << expected
+                            << "\n    array:  " << black[i]);
+        }
+
+        for (Size i = 0; i < s.size(); ++i)
+            s[i] *= 0.01;
+        std::vector<Real> bachelier =
+            bachelierBlackFormula(types[i1], k, f, s, df);
+        for (Size i = 0; i < bachelier.size(); ++i) {
+            Real expected = bachelierBlackFormula(types[i1], k[i], f[i],
+                                                  s[i], df[i]);
+            if (std::fabs(bachelier[i]-expected) > tol*expected + 1.0e-15)
+                BOOST_ERROR("array and scalar Bachelier formulas differ for "
+                            << types[i1] << " strike=" << k[i]
+                            << " forward=" << f[i] << " stdDev=" << s[i]
+                            << std::scientific
+                            << "\n    scalar: " << expected
+                            << "\n    array:  " << bachelier[i]);
+        }
+    }
+}
+
+void BlackFormulaTest::testBatchBlackCalculator() {
+
+    BOOST_TEST_MESSAGE("Testing batch Black calculator...");
+
+    Option::Type types[] = {Option::Call, Option::Put};
+    Real spot = 100.0;
+    Real forwards[] = {90.0, 100.0, 110.0};
+    Real strikes[] = {50.0, 80.0, 100.0, 120.0, 200.0};
+    Real vols[] = {0.10, 0.30, 0.60};
+    Time maturities[] = {0.25, 1.0, 5.0};
+    Rate r = 0.03;
+
+    Real tol = 1.0e-8;
+
+    for (Size i1 = 0; i1 < LENGTH(types); ++i1) {
+        std::vector<Real> k, f, s, df, x0;
+        std::vector<Time> t;
+        for (Size i2 = 0; i2 < LENGTH(forwards); ++i2) {
+            for (Size i3 = 0; i3 < LENGTH(strikes); ++i3) {
+                for (Size i4 = 0; i4 < LENGTH(vols); ++i4) {
+                    for (Size i5 = 0; i5 < LENGTH(maturities); ++i5) {
+                        k.push_back(strikes[i3]);
+                        f.push_back(forwards[i2]);
+                        s.push_back(vols[i4]*std::sqrt(maturities[i5]));
+                        df.push_back(std::exp(-r*maturities[i5]));
+                        x0.push_back(spot);
+                        t.push_back(maturities[i5]);
+                    }
+                }
+            }
+        }
+
+        BatchBlackCalculator batch(types[i1], k, f, s, df, x0, t);
+        for (Size i = 0; i < batch.size(); ++i) {
+            BlackCalculator black(types[i1], k[i], f[i], s[i], df[i]);
+            Real expected[] = { black.value(), black.delta(x0[i]),
+                                black.gamma(x0[i]), black.vega(t[i]),
+                                black.theta(x0[i], t[i]) };
+            Real calculated[] = { batch.value()[i], batch.delta()[i],
+                                  batch.gamma()[i], batch.vega()[i],
+                                  batch.theta()[i] };
+            const char* names[] = { "value", "delta", "gamma", "vega",
+                                    "theta" };
+            for (Size j = 0; j < LENGTH(expected); ++j) {
+                if (std::fabs(calculated[j]-expected[j])
+                    > tol*std::fabs(expected[j]) + 1.0e-12)
+                    BOOST_ERROR("batch and scalar " << names[j]
+                                << " differ for " << types[i1]
+                                << " strike=" << k[i]
+                                << " forward=" << f[i]
+                                << " stdDev=" << s[i]
+                                << std::scientific
+                                << "\n    scalar: " << expected[j]
+                                << "\n    batch:  " << calculated[j]);
+            }
+        }
+    }
+
+    // null standard deviation: intrinsic value and delta
+    std::vector<Real> k(1, 80.0), f(1, 100.0), s(1, 0.0), df(1, 0.9),
+        x0(1, 100.0);
+    std::vector<Time> t(1, 1.0);
+    BatchBlackCalculator batch(Option::Call, k, f, s, df, x0, t);
+    if (std::fabs(batch.value()[0] - 18.0) > 1.0e-12
+        || std::fabs(batch.delta()[0] - 0.9) > 1.0e-12
+        || batch.gamma()[0] != 0.0 || batch.vega()[0] != 0.0)
+        BOOST_ERROR("wrong results for null standard deviation:"
+                    << "\n    value: " << batch.value()[0]
+                    << " (expected 18)"
+                    << "\n    delta: " << batch.delta()[0]
+                    << " (expected 0.9)"
+                    << "\n    gamma: " << batch.gamma()[0]
+                    << " (expected 0)"
+                    << "\n    vega:  " << batch.vega()[0]
+                    << " (expected 0)");
+}
+
 test_suite* BlackFormulaTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Black formula tests");
 
@@ -156,6 +509,16 @@ test_suite* BlackFormulaTest::suite() {
         &BlackFormulaTest::testBachelierImpliedVol));
     suite->add(QUANTLIB_TEST_CASE(
         &BlackFormulaTest::testChambersImpliedVol));
+    suite->add(QUANTLIB_TEST_CASE(
+        &BlackFormulaTest::testHouseholderImpliedStdDev));
+    suite->add(QUANTLIB_TEST_CASE(
+        &BlackFormulaTest::testBachelierHouseholderImpliedStdDev));
+    suite->add(QUANTLIB_TEST_CASE(
+        &BlackFormulaTest::testHouseholderImpliedStdDevInTheWings));
+    suite->add(QUANTLIB_TEST_CASE(
+        &BlackFormulaTest::testArrayFormulas));
+    suite->add(QUANTLIB_TEST_CASE(
+        &BlackFormulaTest::testBatchBlackCalculator));
 
     return suite;
 }
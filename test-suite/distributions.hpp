@@ -31,6 +31,10 @@
 class DistributionTest {
   public:
     static void testNormal();
+    static void testCumulativeNormalArray();
+    static void testInverseCumulativeNormalArray();
+    static void testInverseCumulativeNormalSequence();
+    static void testGaussianCopulaArray();
     static void testBivariate();
     static void testPoisson();
     static void testCumulativePoisson();
@@ -73,6 +77,10 @@ class DistributionTest {
 #include <ql/math/distributions/chisquaredistribution.hpp>
 #include <ql/math/distributions/poissondistribution.hpp>
 #include <ql/math/randomnumbers/stochasticcollocationinvcdf.hpp>
+#include <ql/math/randomnumbers/inversecumulativersg.hpp>
+#include <ql/math/randomnumbers/randomsequencegenerator.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/math/copulas/gaussiancopula.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/math/functional.hpp>
 
@@ -346,6 +354,201 @@ void DistributionTest::testNormal() {
     }
 }
 
+void DistributionTest::testCumulativeNormalArray() {
+
+    BOOST_TEST_MESSAGE("Testing array cumulative normal distribution...");
+
+    CumulativeNormalDistribution cum(average, sigma);
+    std::vector<Real> x, y;
+    for (Real u=-5.5; u<=8.0; u+=0.01)
+        x.push_back(average + sigma*u);
+    y.resize(x.size());
+    cum(&x[0], &y[0], x.size());
+
+    for (Size i=0; i<x.size(); ++i) {
+        Real expected = cum(x[i]);
+        if (std::fabs(y[i]-expected) > 1.0e-8*expected) {
+            BOOST_ERROR("array cumulative normal differs from scalar one:"
+                        << std::scientific
+                        << "\n    x:          " << x[i]
+                        << "\n    array:      " << y[i]
+                        << "\n    scalar:     " << expected);
+        }
+    }
+
+    // the branch-free approximation, used if enabled in userconfig.hpp
+    std::vector<Real> z(x.size());
+    QuantLib::detail::branchFreeCumulativeNormal(average, sigma,
+                                                 &x[0], &z[0], x.size());
+    for (Size i=0; i<x.size(); ++i) {
+        Real expected = cum(x[i]);
+        if (std::fabs(z[i]-expected) > 1.0e-8*expected) {
+            BOOST_ERROR("branch-free cumulative normal differs from "
+                        "scalar one:"
+                        << std::scientific
+                        << "\n    x:            " << x[i]
+                        << "\n    branch-free:  " << z[i]
+                        << "\n    scalar:       " << expected);
+        }
+    }
+
+    // deep tail, where the scalar version underflows; in place
+    Real u[] = { -10.0, -20.0, -30.0, -37.0 };
+    Real expected[] = { 7.6198530241605261e-24, 2.7536241186062337e-89,
+                        4.9067139271481871e-198, 5.7255712225245768e-300 };
+    QuantLib::detail::branchFreeCumulativeNormal(0.0, 1.0,
+                                                 u, u, LENGTH(u));
+    for (Size i=0; i<LENGTH(u); ++i) {
+        if (std::fabs(u[i]-expected[i]) > 1.0e-12*expected[i]) {
+            BOOST_ERROR("array cumulative normal in the left tail:"
+                        << std::scientific << std::setprecision(16)
+                        << "\n    calculated: " << u[i]
+                        << "\n    expected:   " << expected[i]);
+        }
+    }
+
+    // a NaN is propagated, infinities give the limits
+    Real special[] = { std::numeric_limits<Real>::quiet_NaN(),
+                       -std::numeric_limits<Real>::infinity(),
+                       std::numeric_limits<Real>::infinity() };
+    QuantLib::detail::branchFreeCumulativeNormal(0.0, 1.0, special, special,
+                                                 LENGTH(special));
+    if (special[0] == special[0])
+        BOOST_ERROR("NaN not propagated: " << special[0] << " returned");
+    if (special[1] != 0.0 || special[2] != 1.0)
+        BOOST_ERROR("wrong limits at infinity: "
+                    << special[1] << " and " << special[2] << " returned");
+}
+
+void DistributionTest::testInverseCumulativeNormalArray() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing array inverse cumulative normal distribution...");
+
+    InverseCumulativeNormal invCum(average, sigma);
+    std::vector<Real> x;
+    for (Real p=1.0e-12; p<1.0; p*=1.5)
+        x.push_back(p);
+    for (Real p=0.001; p<1.0; p+=0.001)
+        x.push_back(p);
+    for (Real q=1.0e-12; q<0.5; q*=1.5)
+        x.push_back(1.0-q);
+    std::vector<Real> y(x.size());
+    invCum(&x[0], &y[0], x.size());
+
+    for (Size i=0; i<x.size(); ++i) {
+        Real expected = invCum(x[i]);
+        if (std::fabs(y[i]-expected) > 1.0e-15*std::fabs(expected)) {
+            BOOST_ERROR("array inverse cumulative normal differs from "
+                        "scalar one:"
+                        << std::scientific << std::setprecision(16)
+                        << "\n    x:          " << x[i]
+                        << "\n    array:      " << y[i]
+                        << "\n    scalar:     " << expected);
+        }
+    }
+
+    // in place, with the boundaries recovered as by the scalar version;
+    // both in full blocks and in the remaining elements
+    Real u[] = { 0.0, 0.3, 1.0, 0.01, 0.5, 0.99, 0.7, 0.2,
+                 1.0, 0.0, 0.6 };
+    InverseCumulativeNormal standard;
+    std::vector<Real> v(u, u+LENGTH(u));
+    standard(u, u, LENGTH(u));
+    for (Size i=0; i<LENGTH(u); ++i) {
+        Real expected = v[i] == 0.0 ? QL_MIN_REAL :
+                        v[i] == 1.0 ? QL_MAX_REAL : standard(v[i]);
+        if (u[i] != expected)
+            BOOST_ERROR("array inverse cumulative normal in place:"
+                        << std::scientific << std::setprecision(16)
+                        << "\n    x:          " << v[i]
+                        << "\n    calculated: " << u[i]
+                        << "\n    expected:   " << expected);
+    }
+
+    Real invalid[] = { 0.5, 1.5 };
+    BOOST_CHECK_THROW(standard(invalid, invalid, LENGTH(invalid)), Error);
+    Real invalidInBlock[] = { 0.5, 0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5 };
+    BOOST_CHECK_THROW(standard(invalidInBlock, invalidInBlock,
+                               LENGTH(invalidInBlock)), Error);
+}
+
+void DistributionTest::testInverseCumulativeNormalSequence() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing inverse cumulative normal sequence generator...");
+
+    typedef RandomSequenceGenerator<MersenneTwisterUniformRng> usg_type;
+
+    Size dimensions[] = { 1, 7, 8, 9, 64, 100 };
+    for (Size j=0; j<LENGTH(dimensions); ++j) {
+        Size dim = dimensions[j];
+        InverseCumulativeRsg<usg_type, InverseCumulativeNormal>
+            rsg(usg_type(dim, 42), InverseCumulativeNormal(average, sigma));
+        usg_type usg(dim, 42);
+        InverseCumulativeNormal invCum(average, sigma);
+
+        for (Size k=0; k<100; ++k) {
+            const Sample<std::vector<Real> >& x = rsg.nextSequence();
+            const Sample<std::vector<Real> >& u = usg.nextSequence();
+            if (x.value.size() != dim || x.weight != u.weight)
+                BOOST_FAIL("inverse cumulative normal sequence: "
+                           "wrong size or weight in dimension " << dim);
+            for (Size i=0; i<dim; ++i) {
+                Real expected = invCum(u.value[i]);
+                if (std::fabs(x.value[i]-expected) >
+                                            1.0e-15*std::fabs(expected)) {
+                    BOOST_ERROR("inverse cumulative normal sequence "
+                                "differs from scalar inversion:"
+                                << std::scientific << std::setprecision(16)
+                                << "\n    dimension:  " << dim
+                                << "\n    index:      " << i
+                                << "\n    uniform:    " << u.value[i]
+                                << "\n    calculated: " << x.value[i]
+                                << "\n    expected:   " << expected);
+                }
+            }
+        }
+    }
+}
+
+void DistributionTest::testGaussianCopulaArray() {
+
+    BOOST_TEST_MESSAGE("Testing array Gaussian copula...");
+
+    Real rho[] = { -0.75, 0.0, 0.5 };
+    std::vector<Real> x, y;
+    for (Real u=0.0; u<=1.0; u+=0.125) {
+        for (Real v=0.05; v<1.0; v+=0.1) {
+            x.push_back(u);
+            y.push_back(v);
+        }
+    }
+    std::vector<Real> c(x.size());
+
+    for (Size j=0; j<LENGTH(rho); ++j) {
+        GaussianCopula copula(rho[j]);
+        copula(&x[0], &y[0], &c[0], x.size());
+        for (Size i=0; i<x.size(); ++i) {
+            Real expected = copula(x[i], y[i]);
+            if (std::fabs(c[i]-expected) > 1.0e-15) {
+                BOOST_ERROR("array Gaussian copula differs from scalar one:"
+                            << std::scientific << std::setprecision(16)
+                            << "\n    rho:        " << rho[j]
+                            << "\n    x:          " << x[i]
+                            << "\n    y:          " << y[i]
+                            << "\n    array:      " << c[i]
+                            << "\n    scalar:     " << expected);
+            }
+        }
+    }
+
+    GaussianCopula copula(0.5);
+    Real a[] = { 0.2, 0.4 }, b[] = { 0.3, 1.2 }, r[2];
+    BOOST_CHECK_THROW(copula(a, b, r, 2), Error);
+    BOOST_CHECK_THROW(copula(b, a, r, 2), Error);
+}
+
 void DistributionTest::testBivariate() {
 
     BOOST_TEST_MESSAGE("Testing bivariate cumulative normal distribution...");
@@ -757,6 +960,13 @@ test_suite* DistributionTest::suite(SpeedLevel speed) {
     test_suite* suite = BOOST_TEST_SUITE("Distribution tests");
 
     suite->add(QUANTLIB_TEST_CASE(&DistributionTest::testNormal));
+    suite->add(QUANTLIB_TEST_CASE(
+                               &DistributionTest::testCumulativeNormalArray));
+    suite->add(QUANTLIB_TEST_CASE(
+                        &DistributionTest::testInverseCumulativeNormalArray));
+    suite->add(QUANTLIB_TEST_CASE(
+                     &DistributionTest::testInverseCumulativeNormalSequence));
+    suite->add(QUANTLIB_TEST_CASE(&DistributionTest::testGaussianCopulaArray));
     suite->add(QUANTLIB_TEST_CASE(&DistributionTest::testBivariate));
     suite->add(QUANTLIB_TEST_CASE(&DistributionTest::testPoisson));
     suite->add(QUANTLIB_TEST_CASE(&DistributionTest::testCumulativePoisson));
@@ -39,6 +39,10 @@ class IntegralTest {
     static void testDiscreteIntegrals();
     static void testDiscreteIntegrator();
     static void testPiecewiseIntegral();
+    static void testGaussianQuadratureCache();
+    static void testBatchIntegrand();
+    static void testTensorProductQuadrature();
+    static void testSparseGridQuadrature();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -73,6 +77,8 @@ class IntegralTest {
 #include <ql/math/integrals/kronrodintegral.hpp>
 #include <ql/math/integrals/gausslobattointegral.hpp>
 #include <ql/math/integrals/discreteintegrals.hpp>
+#include <ql/math/integrals/gaussianquadratures.hpp>
+#include <ql/math/integrals/multidimensionalquadrature.hpp>
 #include <ql/math/interpolations/bilinearinterpolation.hpp>
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/termstructures/volatility/abcd.hpp>
@@ -361,6 +367,327 @@ void IntegralTest::testPiecewiseIntegral() {
     pw_check(*piecewise, 9.0, 10.0, 6.0);
 }
 
+namespace {
+
+    void checkSameRule(const std::string& name, Size n,
+                       GaussianQuadrature cached,
+                       GaussianQuadrature calculated) {
+        for (Size i=0; i<n; ++i) {
+            if (cached.x()[i] != calculated.x()[i]
+                || cached.weights()[i] != calculated.weights()[i])
+                BOOST_FAIL("cached " << name << " rule of order " << n
+                           << " differs from the calculated one at node "
+                           << i << std::setprecision(16)
+                           << "\n    cached:     " << cached.x()[i]
+                           << ", " << cached.weights()[i]
+                           << "\n    calculated: " << calculated.x()[i]
+                           << ", " << calculated.weights()[i]);
+        }
+    }
+
+}
+
+void IntegralTest::testGaussianQuadratureCache() {
+    BOOST_TEST_MESSAGE("Testing cached Gaussian quadrature rules...");
+
+    const Size orders[] = { 5, 16, 32, 64 };
+    for (Size i=0; i<LENGTH(orders); ++i) {
+        const Size n = orders[i];
+        // constructed twice: calculated first, then taken from the cache
+        for (Size k=0; k<2; ++k) {
+            checkSameRule("Laguerre", n, GaussLaguerreIntegration(n, 0.5),
+                          GaussianQuadrature(n, GaussLaguerrePolynomial(0.5)));
+            checkSameRule("Hermite", n, GaussHermiteIntegration(n),
+                          GaussianQuadrature(n, GaussHermitePolynomial()));
+            checkSameRule("Legendre", n, GaussLegendreIntegration(n),
+                          GaussianQuadrature(n, GaussLegendrePolynomial()));
+            checkSameRule("Jacobi", n, GaussJacobiIntegration(n, 0.3, 0.7),
+                          GaussianQuadrature(n,
+                                             GaussJacobiPolynomial(0.3, 0.7)));
+            checkSameRule("hyperbolic", n, GaussHyperbolicIntegration(n),
+                          GaussianQuadrature(n, GaussHyperbolicPolynomial()));
+        }
+    }
+
+    // the parameters are part of the key, and a stored rule is
+    // neither calculated nor stored again
+    const Size n = 16;
+    typedef QuantLib::detail::GaussianQuadratureCache cache;
+    GaussLaguerreIntegration laguerre(n, 0.25);
+    GaussChebyshevIntegration chebyshev(n);
+    GaussChebyshev2ndIntegration chebyshev2nd(n);
+    checkSameRule("Laguerre", n, laguerre,
+                  GaussianQuadrature(n, GaussLaguerrePolynomial(0.25)));
+    checkSameRule("Chebyshev", n, chebyshev,
+                  GaussianQuadrature(n, GaussChebyshevPolynomial()));
+    checkSameRule("Chebyshev 2nd kind", n, chebyshev2nd,
+                  GaussianQuadrature(n, GaussChebyshev2ndPolynomial()));
+    boost::shared_ptr<const cache::Rule> stored =
+        cache::instance().rule(cache::Laguerre, 0.25, 0.0, n);
+    if (!stored)
+        BOOST_FAIL("new rule not stored in the cache");
+    if (stored == cache::instance().rule(cache::Laguerre, 0.5, 0.0, n))
+        BOOST_FAIL("same rule stored for different parameters");
+    GaussLaguerreIntegration laguerre2(n, 0.25);
+    boost::shared_ptr<cache::Rule> other(new cache::Rule);
+    if (cache::instance().rule(cache::Laguerre, 0.25, 0.0, n) != stored
+        || cache::instance().add(cache::Laguerre, 0.25, 0.0, n,
+                                 other) != stored)
+        BOOST_FAIL("existing rule replaced in the cache");
+
+    // at most maxSize() rules are stored
+    cache bounded(2);
+    boost::shared_ptr<cache::Rule> rules[3];
+    for (Size i=0; i<3; ++i) {
+        rules[i] = boost::shared_ptr<cache::Rule>(new cache::Rule);
+        if (bounded.add(cache::Laguerre, 0.1*i, 0.0, n, rules[i])
+            != rules[i])
+            BOOST_FAIL("rule " << i << " not returned by the cache");
+    }
+    if (bounded.size() != 2
+        || bounded.rule(cache::Laguerre, 0.0, 0.0, n) != rules[0]
+        || bounded.rule(cache::Laguerre, 0.1, 0.0, n) != rules[1]
+        || bounded.rule(cache::Laguerre, 0.2, 0.0, n))
+        BOOST_FAIL("cache not bounded to " << bounded.maxSize()
+                   << " rules");
+
+    GaussLegendreIntegration legendre(n);
+    // \int_{-1}^{1} x^2 dx = 2/3
+    const Real expected = 2.0/3.0;
+    const Real calculated = legendre(square<Real>());
+    if (std::fabs(calculated - expected) > 1.0e-14)
+        BOOST_FAIL("wrong Gauss-Legendre integral"
+                   << std::setprecision(16)
+                   << "\n    calculated: " << calculated
+                   << "\n    expected:   " << expected);
+}
+
+namespace {
+
+    Real kinked(Real x) {
+        return std::exp(-x*x)*std::cos(3.0*x)
+            + 0.1*std::sqrt(std::fabs(x));
+    }
+
+    class BatchKinked {
+      public:
+        explicit BatchKinked(Size* calls) : calls_(calls) {}
+        void operator()(const Real* x, Real* fx, Size n) const {
+            ++(*calls_);
+            for (Size i=0; i<n; ++i)
+                fx[i] = kinked(x[i]);
+        }
+      private:
+        Size* calls_;
+    };
+
+    void checkBatch(const std::string& name, const Integrator& I,
+                    Real a, Real b) {
+        Size calls = 0;
+        const Real scalar = I(kinked, a, b);
+        const Size scalarEvaluations = I.numberOfEvaluations();
+        const Real batch = I(BatchIntegrand(BatchKinked(&calls)), a, b);
+        if (batch != scalar)
+            BOOST_FAIL(name << ": batch integral differs from the scalar one"
+                       << std::setprecision(16)
+                       << "\n    scalar: " << scalar
+                       << "\n    batch:  " << batch);
+        if (I.numberOfEvaluations() != scalarEvaluations)
+            BOOST_FAIL(name << ": " << I.numberOfEvaluations()
+                       << " batch evaluations, "
+                       << scalarEvaluations << " scalar ones");
+        // points are passed in groups, not one by one
+        if (calls == 0
+            || (scalarEvaluations > 0 && calls*4 > scalarEvaluations))
+            BOOST_FAIL(name << ": " << calls << " batch calls for "
+                       << scalarEvaluations << " evaluations");
+    }
+
+}
+
+void IntegralTest::testBatchIntegrand() {
+    BOOST_TEST_MESSAGE("Testing batch integrands...");
+
+    checkBatch("segment", SegmentIntegral(100), -1.0, 2.0);
+    checkBatch("trapezoid", TrapezoidIntegral<Default>(1.0e-8, 100),
+               -1.0, 2.0);
+    checkBatch("mid-point trapezoid",
+               TrapezoidIntegral<MidPoint>(1.0e-8, 100), -1.0, 2.0);
+    checkBatch("Simpson", SimpsonIntegral(1.0e-8, 100), -1.0, 2.0);
+    checkBatch("non-adaptive Gauss-Kronrod",
+               GaussKronrodNonAdaptive(1.0e-12, 100, 1.0e-12), -1.0, 2.0);
+    checkBatch("adaptive Gauss-Kronrod",
+               GaussKronrodAdaptive(1.0e-10, 100000), -1.0, 2.0);
+    checkBatch("Gauss-Lobatto", GaussLobattoIntegral(100000, 1.0e-10),
+               -1.0, 2.0);
+    checkBatch("Gauss-Lobatto (relative tolerance)",
+               GaussLobattoIntegral(100000, 1.0e-10, 1.0e-8, false),
+               -1.0, 2.0);
+    checkBatch("Gauss-Lobatto (reversed domain)",
+               GaussLobattoIntegral(100000, 1.0e-10), 2.0, -1.0);
+    checkBatch("discrete trapezoid", DiscreteTrapezoidIntegrator(101),
+               -1.0, 2.0);
+    checkBatch("discrete Simpson", DiscreteSimpsonIntegrator(101),
+               -1.0, 2.0);
+    checkBatch("Filon", FilonIntegral(FilonIntegral::Sine, 2.0, 100),
+               -1.0, 2.0);
+
+    Size calls = 0;
+    const BatchIntegrand f = BatchIntegrand(BatchKinked(&calls));
+    GaussHermiteIntegration hermite(20);
+    if (hermite(f) != hermite(kinked) || calls != 1)
+        BOOST_FAIL("batch Gauss-Hermite integral differs from the "
+                   "scalar one");
+    const Size orders[] = { 6, 7, 12, 20 };
+    for (Size i=0; i<LENGTH(orders); ++i) {
+        TabulatedGaussLegendre legendre(orders[i]);
+        if (legendre(f) != legendre(kinked))
+            BOOST_FAIL("batch tabulated Gauss-Legendre integral of order "
+                       << orders[i] << " differs from the scalar one");
+    }
+}
+
+namespace {
+
+    // exp(a.x - |x|^2), with a_i = 0.3 + 0.1 i
+    Real gaussianExponential(const std::vector<Real>& x) {
+        Real s = 0.0;
+        for (Size i=0; i<x.size(); ++i)
+            s += (0.3+0.1*i)*x[i] - x[i]*x[i];
+        return std::exp(s);
+    }
+
+    class BatchGaussianExponential {
+      public:
+        BatchGaussianExponential(Size dimensions, Size* calls)
+        : dimensions_(dimensions), calls_(calls) {}
+        void operator()(const Real* x, Real* fx, Size n) const {
+            ++(*calls_);
+            for (Size k=0; k<n; ++k)
+                fx[k] = gaussianExponential(
+                    std::vector<Real>(x + k*dimensions_,
+                                      x + (k+1)*dimensions_));
+        }
+      private:
+        Size dimensions_;
+        Size* calls_;
+    };
+
+    // pi^(d/2) exp(|a|^2/4)
+    Real gaussianExponentialIntegral(Size dimensions) {
+        Real a2 = 0.0;
+        for (Size i=0; i<dimensions; ++i)
+            a2 += (0.3+0.1*i)*(0.3+0.1*i);
+        return std::pow(M_PI, 0.5*dimensions)*std::exp(0.25*a2);
+    }
+
+    Real gaussianTimesQuadratic(const std::vector<Real>& x) {
+        return std::exp(-x[0]*x[0])*(1.0 + x[1]*x[1]);
+    }
+
+    // x_0^6 + x_0^2 x_1^2 x_2^2 + x_1^4 x_2^3, times exp(-|x|^2)
+    Real gaussianPolynomial(const std::vector<Real>& x) {
+        const Real p = std::pow(x[0], 6) + x[0]*x[0]*x[1]*x[1]*x[2]*x[2]
+            + std::pow(x[1], 4)*std::pow(x[2], 3);
+        Real r2 = 0.0;
+        for (Size i=0; i<x.size(); ++i)
+            r2 += x[i]*x[i];
+        return p*std::exp(-r2);
+    }
+
+}
+
+void IntegralTest::testTensorProductQuadrature() {
+    BOOST_TEST_MESSAGE("Testing tensor-product Gaussian quadrature...");
+
+    const Size dimensions = 4;
+    GaussianTensorProductIntegration quadrature(dimensions,
+                                                GaussHermiteIntegration(10));
+    if (quadrature.size() != 10000 || quadrature.dimensions() != dimensions)
+        BOOST_FAIL("wrong number of points (" << quadrature.size()
+                   << ") or dimensions (" << quadrature.dimensions() << ")");
+
+    const Real expected = gaussianExponentialIntegral(dimensions);
+    const Real calculated = quadrature(gaussianExponential);
+    if (std::fabs(calculated/expected - 1.0) > 1.0e-12)
+        BOOST_FAIL("wrong tensor-product integral"
+                   << std::setprecision(16)
+                   << "\n    calculated: " << calculated
+                   << "\n    expected:   " << expected);
+
+    Size calls = 0;
+    const Real batch = quadrature(
+        BatchIntegrand(BatchGaussianExponential(dimensions, &calls)));
+    if (batch != calculated || calls != 1)
+        BOOST_FAIL("batch integral differs from the scalar one"
+                   << std::setprecision(16)
+                   << "\n    scalar: " << calculated
+                   << "\n    batch:  " << batch
+                   << "\n    calls:  " << calls);
+
+    // different rules along each axis
+    std::vector<GaussianQuadrature> rules;
+    rules.push_back(GaussHermiteIntegration(12));
+    rules.push_back(GaussLegendreIntegration(5));
+    GaussianTensorProductIntegration mixed(rules);
+    // \int exp(-x^2) (1 + y^2) dx dy over R x [-1,1]
+    const Real mixedExpected = std::sqrt(M_PI)*8.0/3.0;
+    const Real mixedCalculated = mixed(gaussianTimesQuadratic);
+    if (std::fabs(mixedCalculated - mixedExpected) > 1.0e-12)
+        BOOST_FAIL("wrong tensor-product integral with mixed rules"
+                   << std::setprecision(16)
+                   << "\n    calculated: " << mixedCalculated
+                   << "\n    expected:   " << mixedExpected);
+}
+
+void IntegralTest::testSparseGridQuadrature() {
+    BOOST_TEST_MESSAGE("Testing sparse-grid Gaussian quadrature...");
+
+    // level 4 with rules of order l at level l: exact up to degree 7
+    std::vector<GaussianQuadrature> rules;
+    for (Size l=1; l<=4; ++l)
+        rules.push_back(GaussHermiteIntegration(l));
+    GaussianSparseGridIntegration sparse(5, rules);
+    GaussianTensorProductIntegration tensor(5, GaussHermiteIntegration(4));
+    if (sparse.size() >= tensor.size())
+        BOOST_FAIL("sparse grid with " << sparse.size()
+                   << " points, tensor product with " << tensor.size());
+
+    // (Gamma(7/2) pi + Gamma(3/2)^3) pi, the odd term vanishing
+    const Real expected = (15.0/8.0*M_PI*std::sqrt(M_PI)
+                           + std::pow(0.5*std::sqrt(M_PI), 3))*M_PI;
+    const Real calculated = sparse(gaussianPolynomial);
+    if (std::fabs(calculated/expected - 1.0) > 1.0e-12)
+        BOOST_FAIL("sparse grid not exact on polynomials"
+                   << std::setprecision(16)
+                   << "\n    calculated: " << calculated
+                   << "\n    expected:   " << expected);
+
+    const Size dimensions = 5;
+    rules.clear();
+    for (Size l=1; l<=6; ++l)
+        rules.push_back(GaussHermiteIntegration(2*l-1));
+    GaussianSparseGridIntegration grid(dimensions, rules);
+    const Real exponential = gaussianExponentialIntegral(dimensions);
+    const Real scalar = grid(gaussianExponential);
+    if (std::fabs(scalar/exponential - 1.0) > 1.0e-8)
+        BOOST_FAIL("wrong sparse-grid integral"
+                   << std::setprecision(16)
+                   << "\n    calculated: " << scalar
+                   << "\n    expected:   " << exponential
+                   << "\n    points:     " << grid.size());
+
+    Size calls = 0;
+    const Real batch = grid(
+        BatchIntegrand(BatchGaussianExponential(dimensions, &calls)));
+    if (batch != scalar || calls != 1)
+        BOOST_FAIL("batch integral differs from the scalar one"
+                   << std::setprecision(16)
+                   << "\n    scalar: " << scalar
+                   << "\n    batch:  " << batch
+                   << "\n    calls:  " << calls);
+}
+
 test_suite* IntegralTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Integration tests");
     suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testSegment));
@@ -375,6 +702,10 @@ test_suite* IntegralTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testDiscreteIntegrals));
     suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testDiscreteIntegrator));
     suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testPiecewiseIntegral));
+    suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testGaussianQuadratureCache));
+    suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testBatchIntegrand));
+    suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testTensorProductQuadrature));
+    suite->add(QUANTLIB_TEST_CASE(&IntegralTest::testSparseGridQuadrature));
     return suite;
 }
 
@@ -58,6 +58,18 @@ public:
 	static void testLagrangeInterpolationDerivative();
 	static void testLagrangeInterpolationOnChebyshevPoints();
 	static void testBSplines();
+	static void testBatchEvaluation();
+	static void testLocalityHint();
+	static void testIncrementalSplineUpdate();
+	static void testKernelInterpolationSolvers();
+	static void testPrecomputedSurfaces();
+	static void testTensorProductInterpolation();
+	static void testSabrGradients();
+	static void testSabrSmileCalibration();
+	static void testFixedSizeInterpolation();
+	static void testConvexMonotoneSections();
+	static void benchmarkLocalVolCurve();
+	static void benchmarkHintedLocalVolCurve();
 
 	static boost::unit_test_framework::test_suite* suite();
 };
@@ -92,19 +104,29 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 #include <ql/utilities/null.hpp>
 #include <ql/math/interpolations/linearinterpolation.hpp>
 #include <ql/math/interpolations/bicubicsplineinterpolation.hpp>
+#include <ql/math/interpolations/bilinearinterpolation.hpp>
 #include <ql/math/interpolations/backwardflatinterpolation.hpp>
 #include <ql/math/interpolations/forwardflatinterpolation.hpp>
 #include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/math/interpolations/multicubicspline.hpp>
+#include <ql/math/interpolations/tensorproductinterpolation.hpp>
+#include <ql/termstructures/volatility/equityfx/blackvariancecurve.hpp>
+#include <ql/termstructures/volatility/equityfx/localvolcurve.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/math/interpolations/fixedsizeinterpolation.hpp>
 #include <ql/math/interpolations/sabrinterpolation.hpp>
+#include <ql/termstructures/volatility/sabrsmilecalibration.hpp>
 #include <ql/math/interpolations/kernelinterpolation.hpp>
 #include <ql/math/interpolations/kernelinterpolation2d.hpp>
 #include <ql/math/interpolations/lagrangeinterpolation.hpp>
+#include <ql/math/interpolations/loginterpolation.hpp>
+#include <ql/math/interpolations/convexmonotoneinterpolation.hpp>
 #include <ql/math/integrals/simpsonintegral.hpp>
 #include <ql/math/bspline.hpp>
 #include <ql/math/kernelfunctions.hpp>
 #include <ql/math/functional.hpp>
 #include <ql/math/richardsonextrapolation.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/math/randomnumbers/sobolrsg.hpp>
 #include <ql/math/optimization/levenbergmarquardt.hpp>
 // #include <ql/experimental/volatility/noarbsabrinterpolation.hpp>
@@ -2423,6 +2445,1036 @@ void InterpolationTest::testBSplines()
 	}
 }
 
+namespace {
+
+	void checkBatchEvaluation(const std::string& name,
+							  const Interpolation& f,
+							  const std::vector<Real>& x,
+							  bool checkDerivatives)
+	{
+		std::vector<Real> values(x.size()), derivatives(x.size());
+		f.values(&x[0], &x[0] + x.size(), &values[0], true);
+		if (checkDerivatives)
+			f.derivatives(&x[0], &x[0] + x.size(), &derivatives[0], true);
+
+		const Real tol = 1e-14;
+		for (Size i = 0; i < x.size(); ++i)
+		{
+			const Real value = f(x[i], true);
+			if (std::fabs(values[i] - value) > tol*std::max(1.0, std::fabs(value)))
+				BOOST_FAIL("failed to reproduce " << name << " value"
+						   << std::setprecision(16)
+						   << "\n    x         : " << x[i]
+						   << "\n    batch     : " << values[i]
+						   << "\n    expected  : " << value);
+			if (!checkDerivatives)
+				continue;
+			const Real derivative = f.derivative(x[i], true);
+			if (std::fabs(derivatives[i] - derivative)
+				> tol*std::max(1.0, std::fabs(derivative)))
+				BOOST_FAIL("failed to reproduce " << name << " derivative"
+						   << std::setprecision(16)
+						   << "\n    x         : " << x[i]
+						   << "\n    batch     : " << derivatives[i]
+						   << "\n    expected  : " << derivative);
+		}
+	}
+
+}
+
+void InterpolationTest::testBatchEvaluation()
+{
+	BOOST_TEST_MESSAGE("Testing batch evaluation of interpolations...");
+
+	const Size n = 12;
+	std::vector<Real> x(n), y(n);
+	for (Size i = 0; i < n; ++i)
+	{
+		x[i] = 0.25*i + 0.05*i*i;
+		y[i] = 0.02 + 0.01*std::sin(0.7*i) + 0.002*i;
+	}
+
+	// sorted points including the nodes and points outside the range,
+	// followed by the same points in scrambled order
+	std::vector<Real> sorted;
+	for (Real t = x.front() - 0.3; t < x.back() + 0.5; t += 0.0137)
+		sorted.push_back(t);
+	sorted.insert(sorted.end(), x.begin(), x.end());
+	std::sort(sorted.begin(), sorted.end());
+	std::vector<Real> scrambled(sorted.size());
+	for (Size i = 0; i < sorted.size(); ++i)
+		scrambled[i] = sorted[(i*7919) % sorted.size()];
+
+	const std::vector<Real>* points[] = { &sorted, &scrambled };
+	for (Size j = 0; j < LENGTH(points); ++j)
+	{
+		const std::vector<Real>& p = *points[j];
+		checkBatchEvaluation("linear",
+			LinearInterpolation(x.begin(), x.end(), y.begin()), p, true);
+		checkBatchEvaluation("log-linear",
+			LogLinearInterpolation(x.begin(), x.end(), y.begin()), p, true);
+		checkBatchEvaluation("cubic spline",
+			CubicNaturalSpline(x.begin(), x.end(), y.begin()), p, true);
+		checkBatchEvaluation("monotonic cubic spline",
+			MonotonicCubicNaturalSpline(x.begin(), x.end(), y.begin()),
+			p, true);
+		checkBatchEvaluation("log-cubic spline",
+			LogCubicNaturalSpline(x.begin(), x.end(), y.begin()), p, true);
+		checkBatchEvaluation("forward-flat",
+			ForwardFlatInterpolation(x.begin(), x.end(), y.begin()), p, true);
+		checkBatchEvaluation("backward-flat",
+			BackwardFlatInterpolation(x.begin(), x.end(), y.begin()), p, true);
+		checkBatchEvaluation("convex-monotone",
+			ConvexMonotoneInterpolation<std::vector<Real>::iterator,
+										std::vector<Real>::iterator>(
+				x.begin(), x.end(), y.begin(), 0.3, 0.7, true),
+			p, false);
+	}
+}
+
+namespace
+{
+	/* local volatilities from a curve of 520 weekly variances,
+	   swept at steps of about 4 hours; returns their sum */
+	Real sweepLocalVolCurve(Size sweeps, bool hinted)
+	{
+		Date today(15, January, 2018);
+		std::vector<Date> dates;
+		std::vector<Volatility> vols;
+		for (Size i = 1; i <= 520; ++i)
+		{
+			dates.push_back(today + Period(i, Weeks));
+			vols.push_back(0.20 + 0.0002*i);
+		}
+		boost::shared_ptr<BlackVarianceCurve> curve(
+			new BlackVarianceCurve(today, dates, vols, Actual365Fixed()));
+		if (hinted)
+			curve->enableLocalityHint();
+		Handle<BlackVarianceCurve> handle(curve);
+		LocalVolCurve localVol(handle);
+
+		Real sum = 0.0;
+		for (Size j = 0; j < sweeps; ++j)
+			for (Time t = 0.01; t < 9.9; t += 0.0005)
+				sum += localVol.localVol(t, 100.0);
+		return sum;
+	}
+}
+
+void InterpolationTest::testLocalityHint()
+{
+	BOOST_TEST_MESSAGE("Testing hinted segment lookup in interpolations...");
+
+	const Size n = 50;
+	std::vector<Real> x(n), y(n);
+	for (Size i = 0; i < n; ++i)
+	{
+		x[i] = 0.1*i + 0.01*i*i;
+		y[i] = std::exp(-0.3*x[i]) + 0.05*std::cos(1.3*x[i]);
+	}
+
+	// forward and backward sweeps hitting the nodes and the points
+	// outside the range, large jumps and scrambled points
+	std::vector<Real> forward;
+	for (Real t = x.front() - 0.2; t < x.back() + 0.3; t += 0.0173)
+		forward.push_back(t);
+	forward.insert(forward.end(), x.begin(), x.end());
+	std::sort(forward.begin(), forward.end());
+	std::vector<Real> backward(forward.rbegin(), forward.rend());
+	std::vector<Real> jumps, scrambled(forward.size());
+	for (Size i = 0; i < n; ++i)
+	{
+		jumps.push_back(x[i]);
+		jumps.push_back(x[n - 1 - i] - 0.001);
+	}
+	for (Size i = 0; i < forward.size(); ++i)
+		scrambled[i] = forward[(i*7919) % forward.size()];
+
+	const std::vector<Real>* points[] = { &forward, &backward,
+										  &jumps, &scrambled };
+
+	LinearInterpolation linear(x.begin(), x.end(), y.begin());
+	LinearInterpolation hintedLinear(x.begin(), x.end(), y.begin());
+	hintedLinear.enableLocalityHint();
+	CubicNaturalSpline cubic(x.begin(), x.end(), y.begin());
+	CubicNaturalSpline hintedCubic(x.begin(), x.end(), y.begin());
+	hintedCubic.enableLocalityHint();
+
+	for (Size j = 0; j < LENGTH(points); ++j)
+	{
+		const std::vector<Real>& p = *points[j];
+		for (Size i = 0; i < p.size(); ++i)
+		{
+			if (hintedLinear(p[i], true) != linear(p[i], true))
+				BOOST_FAIL("failed to reproduce linear interpolation"
+						   << std::setprecision(16)
+						   << "\n    x         : " << p[i]
+						   << "\n    hinted    : " << hintedLinear(p[i], true)
+						   << "\n    expected  : " << linear(p[i], true));
+			if (hintedCubic.derivative(p[i], true)
+				!= cubic.derivative(p[i], true))
+				BOOST_FAIL("failed to reproduce cubic spline derivative"
+						   << std::setprecision(16)
+						   << "\n    x         : " << p[i]
+						   << "\n    hinted    : "
+						   << hintedCubic.derivative(p[i], true)
+						   << "\n    expected  : "
+						   << cubic.derivative(p[i], true));
+		}
+	}
+
+	Real plain = sweepLocalVolCurve(1, false);
+	Real hinted = sweepLocalVolCurve(1, true);
+	if (hinted != plain)
+		BOOST_FAIL("failed to reproduce local volatilities with hint"
+				   << std::setprecision(16)
+				   << "\n    hinted    : " << hinted
+				   << "\n    expected  : " << plain);
+}
+
+void InterpolationTest::benchmarkLocalVolCurve()
+{
+	if (!(sweepLocalVolCurve(500, false) > 0.0))
+		BOOST_FAIL("local volatility sweep failed");
+}
+
+void InterpolationTest::benchmarkHintedLocalVolCurve()
+{
+	if (!(sweepLocalVolCurve(500, true) > 0.0))
+		BOOST_FAIL("hinted local volatility sweep failed");
+}
+
+void InterpolationTest::testIncrementalSplineUpdate()
+{
+	BOOST_TEST_MESSAGE("Testing incremental update of cubic splines...");
+
+	const Size n = 30;
+	std::vector<Real> x(n), y(n);
+	for (Size i = 0; i < n; ++i)
+	{
+		x[i] = 0.5*i + 0.02*i*i;
+		y[i] = 0.03 + 0.01*std::sin(0.4*i) - 0.0003*i;
+	}
+
+	const CubicInterpolation::BoundaryCondition conditions[] = {
+		CubicInterpolation::NotAKnot,
+		CubicInterpolation::FirstDerivative,
+		CubicInterpolation::SecondDerivative,
+		CubicInterpolation::Lagrange
+	};
+
+	for (Size j = 0; j < LENGTH(conditions); ++j)
+	{
+		std::vector<Real> values(y);
+		CubicInterpolation spline(x.begin(), x.end(), values.begin(),
+								  CubicInterpolation::Spline, false,
+								  conditions[j], 0.001,
+								  conditions[(j + 1) % LENGTH(conditions)],
+								  -0.002);
+
+		// single nodes moving repeatedly, across several periodic
+		// full rebuilds, then two nodes at once
+		for (Size k = 0; k < 10*n + 1; ++k)
+		{
+			if (k < 10*n)
+				values[(k*7) % n] += 0.0005*std::cos(Real(k));
+			else
+				values[1] = values[n - 2] = 0.04;
+			spline.update();
+
+			CubicInterpolation rebuilt(x.begin(), x.end(), values.begin(),
+									   CubicInterpolation::Spline, false,
+									   conditions[j], 0.001,
+									   conditions[(j + 1) % LENGTH(conditions)],
+									   -0.002);
+			for (Size i = 0; i < n - 1; ++i)
+			{
+				const Real tol = 1e-12;
+				Real updated[] = { spline.aCoefficients()[i],
+								   spline.bCoefficients()[i],
+								   spline.cCoefficients()[i],
+								   spline.primitiveConstants()[i] };
+				Real expected[] = { rebuilt.aCoefficients()[i],
+									rebuilt.bCoefficients()[i],
+									rebuilt.cCoefficients()[i],
+									rebuilt.primitiveConstants()[i] };
+				for (Size m = 0; m < LENGTH(updated); ++m)
+				{
+					if (std::fabs(updated[m] - expected[m])
+						> tol*std::max(1.0, std::fabs(expected[m])))
+						BOOST_FAIL("incremental update failed to reproduce "
+								   "full rebuild"
+								   << std::setprecision(16)
+								   << "\n    boundary conditions: " << j
+								   << "\n    update:     " << k
+								   << "\n    segment:    " << i
+								   << "\n    coefficient:" << m
+								   << "\n    updated:    " << updated[m]
+								   << "\n    expected:   " << expected[m]);
+				}
+			}
+		}
+	}
+}
+
+namespace {
+
+	// compactly supported Wendland function, positive definite in
+	// up to three dimensions
+	class WendlandKernel
+	{
+	  public:
+		explicit WendlandKernel(Real radius) : radius_(radius) {}
+		Real operator()(Real x) const
+		{
+			const Real r = std::fabs(x) / radius_;
+			return r < 1.0 ? std::pow(1.0 - r, 4)*(4.0*r + 1.0) : 0.0;
+		}
+	  private:
+		Real radius_;
+	};
+
+}
+
+void InterpolationTest::testKernelInterpolationSolvers()
+{
+	BOOST_TEST_MESSAGE("Testing kernel interpolation on larger grids...");
+
+	// the compactly supported kernel gives a sparse system, the
+	// narrow Gaussian a dense positive-definite one
+	const Size n = 400;
+	std::vector<Real> x(n), y(n);
+	for (Size i = 0; i < n; ++i)
+	{
+		x[i] = 0.01*i;
+		y[i] = 0.2 + 0.05*std::sin(3.0*x[i]) + 0.01*x[i];
+	}
+
+	KernelInterpolation sparse(x.begin(), x.end(), y.begin(),
+							   WendlandKernel(0.035));
+	KernelInterpolation dense(x.begin(), x.end(), y.begin(),
+							  GaussianKernel(0.0, 0.006));
+
+	const Real tolerance = 1.0e-7;
+	for (Size i = 0; i < n; ++i)
+	{
+		if (std::fabs(sparse(x[i]) - y[i]) > tolerance)
+			BOOST_FAIL("sparse kernel interpolation failed at x = " << x[i]
+					   << std::scientific
+					   << "\n    interpolated value: " << sparse(x[i])
+					   << "\n    expected value:     " << y[i]);
+		if (std::fabs(dense(x[i]) - y[i]) > tolerance)
+			BOOST_FAIL("dense kernel interpolation failed at x = " << x[i]
+					   << std::scientific
+					   << "\n    interpolated value: " << dense(x[i])
+					   << "\n    expected value:     " << y[i]);
+	}
+
+	// 2D grid with a compactly supported kernel
+	std::vector<Real> u(20), v(15);
+	for (Size i = 0; i < u.size(); ++i)
+		u[i] = 0.1*i;
+	for (Size j = 0; j < v.size(); ++j)
+		v[j] = 0.5 + 0.1*j;
+	Matrix z(u.size(), v.size());
+	for (Size i = 0; i < u.size(); ++i)
+		for (Size j = 0; j < v.size(); ++j)
+			z[i][j] = 0.2 + 0.1*std::exp(-u[i])*std::cos(v[j]);
+
+	KernelInterpolation2D surface(u.begin(), u.end(), v.begin(), v.end(),
+								  z, WendlandKernel(0.25));
+	for (Size i = 0; i < u.size(); ++i)
+	{
+		for (Size j = 0; j < v.size(); ++j)
+		{
+			if (std::fabs(surface(u[i], v[j]) - z[i][j]) > 1.0e-10)
+				BOOST_FAIL("2D kernel interpolation failed at x = " << u[i]
+						   << ", y = " << v[j]
+						   << std::scientific
+						   << "\n    interpolated value: "
+						   << surface(u[i], v[j])
+						   << "\n    expected value:     " << z[i][j]);
+		}
+	}
+
+	// the solver path taken for each kind of system
+	const Size m = 200;
+	Array b(m);
+	for (Size i = 0; i < m; ++i)
+		b[i] = 1.0 + 0.01*i;
+	QuantLib::detail::KernelSystemSolver solver;
+	WendlandKernel compact(0.035);
+	GaussianKernel gaussian(0.0, 0.006);
+	Array a;
+
+	solver.reset(m);
+	for (Size i = 0; i < m; ++i)
+		for (Size j = 0; j <= i; ++j)
+			solver.add(i, j, compact(0.01*i - 0.01*j));
+	if (!solver.solve(b, 1.0e-12, a) || !solver.sparse()
+		|| solver.method() != QuantLib::detail::KernelSystemSolver::ConjugateGradient
+		|| solver.iterations() == 0)
+		BOOST_FAIL("sparse kernel system not solved by conjugate gradients");
+	Array Ka(m);
+	solver.apply(a, Ka);
+	if (Norm2(Ka - b) > 1.0e-10*Norm2(b))
+		BOOST_FAIL("conjugate-gradient solution not accurate: residual "
+				   << Norm2(Ka - b));
+
+	// running out of iterations must be reported, so that the
+	// caller can fall back to a general solver
+	if (solver.solve(b, 1.0e-12, a, 5)
+		|| solver.method() != QuantLib::detail::KernelSystemSolver::None
+		|| solver.iterations() != 5)
+		BOOST_FAIL("non-convergence of conjugate gradients not reported");
+
+	solver.reset(m);
+	for (Size i = 0; i < m; ++i)
+		for (Size j = 0; j <= i; ++j)
+			solver.add(i, j, gaussian(0.01*i - 0.01*j));
+	if (!solver.solve(b, 1.0e-12, a) || solver.sparse()
+		|| solver.method() != QuantLib::detail::KernelSystemSolver::Cholesky)
+		BOOST_FAIL("dense kernel system not solved by Cholesky");
+	solver.apply(a, Ka);
+	if (Norm2(Ka - b) > 1.0e-10*Norm2(b))
+		BOOST_FAIL("Cholesky solution not accurate: residual "
+				   << Norm2(Ka - b));
+
+	// indefinite systems are left to the caller's fallback
+	solver.reset(m);
+	for (Size i = 0; i < m; ++i)
+		for (Size j = 0; j <= i; ++j)
+			solver.add(i, j, i - j == 1 ? 1.0 : 0.0);
+	if (solver.solve(b, 1.0e-12, a)
+		|| solver.method() != QuantLib::detail::KernelSystemSolver::None)
+		BOOST_FAIL("indefinite kernel system not rejected");
+	solver.reset(m);
+	for (Size i = 0; i < m; ++i)
+		for (Size j = 0; j <= i; ++j)
+			solver.add(i, j, i == j ? 1.0 : -1.0);
+	if (solver.solve(b, 1.0e-12, a) || solver.sparse()
+		|| solver.method() != QuantLib::detail::KernelSystemSolver::None)
+		BOOST_FAIL("indefinite dense kernel system not rejected");
+}
+
+void InterpolationTest::testPrecomputedSurfaces()
+{
+	BOOST_TEST_MESSAGE("Testing precomputed bicubic and bilinear surfaces...");
+
+	std::vector<Real> x(7), y(5);
+	for (Size i = 0; i < x.size(); ++i)
+		x[i] = 0.5*i + 0.1*i*i;
+	for (Size j = 0; j < y.size(); ++j)
+		y[j] = 1.0 + 0.7*j;
+	Matrix z(y.size(), x.size());
+	for (Size j = 0; j < y.size(); ++j)
+		for (Size i = 0; i < x.size(); ++i)
+			z[j][i] = 0.2 + 0.05*std::sin(x[i] + 0.3*y[j]) + 0.01*x[i]*y[j];
+
+	BicubicSpline bicubic(x.begin(), x.end(), y.begin(), y.end(), z);
+	BilinearInterpolation bilinear(x.begin(), x.end(), y.begin(), y.end(), z);
+
+	// points inside, on the nodes and outside the grid
+	std::vector<Real> px, py;
+	for (Real u = x.front() - 0.3; u < x.back() + 0.4; u += 0.113)
+	{
+		for (Real v = y.front() - 0.2; v < y.back() + 0.3; v += 0.157)
+		{
+			px.push_back(u);
+			py.push_back(v);
+		}
+	}
+	for (Size i = 0; i < x.size(); ++i)
+	{
+		for (Size j = 0; j < y.size(); ++j)
+		{
+			px.push_back(x[i]);
+			py.push_back(y[j]);
+		}
+	}
+
+	std::vector<Real> bicubicValues(px.size()), bilinearValues(px.size());
+	bicubic.values(&px[0], &px[0] + px.size(), &py[0],
+				   &bicubicValues[0], true);
+	bilinear.values(&px[0], &px[0] + px.size(), &py[0],
+					&bilinearValues[0], true);
+
+	const Real tol = 1.0e-13;
+	std::vector<Real> section(y.size());
+	for (Size k = 0; k < px.size(); ++k)
+	{
+		// the tensor-product spline, computed as sections
+		for (Size j = 0; j < y.size(); ++j)
+			section[j] = CubicNaturalSpline(x.begin(), x.end(),
+											z.row_begin(j))(px[k], true);
+		Real expected = CubicNaturalSpline(y.begin(), y.end(),
+										   section.begin())(py[k], true);
+		Real calculated = bicubic(px[k], py[k], true);
+		if (std::fabs(calculated - expected) > tol
+			|| std::fabs(bicubicValues[k] - expected) > tol)
+			BOOST_FAIL("failed to reproduce bicubic spline"
+					   << std::setprecision(16)
+					   << "\n    point:      (" << px[k] << ", " << py[k] << ")"
+					   << "\n    calculated: " << calculated
+					   << "\n    batch:      " << bicubicValues[k]
+					   << "\n    expected:   " << expected);
+
+		Size i = bilinear.locateX(px[k]), j = bilinear.locateY(py[k]);
+		Real t = (px[k] - x[i]) / (x[i + 1] - x[i]);
+		Real u = (py[k] - y[j]) / (y[j + 1] - y[j]);
+		expected = (1.0 - t)*(1.0 - u)*z[j][i] + t*(1.0 - u)*z[j][i + 1]
+				 + (1.0 - t)*u*z[j + 1][i] + t*u*z[j + 1][i + 1];
+		calculated = bilinear(px[k], py[k], true);
+		if (std::fabs(calculated - expected) > tol
+			|| std::fabs(bilinearValues[k] - expected) > tol)
+			BOOST_FAIL("failed to reproduce bilinear interpolation"
+					   << std::setprecision(16)
+					   << "\n    point:      (" << px[k] << ", " << py[k] << ")"
+					   << "\n    calculated: " << calculated
+					   << "\n    batch:      " << bilinearValues[k]
+					   << "\n    expected:   " << expected);
+	}
+}
+
+namespace {
+
+	// interpolates along the last axis first, then along the
+	// previous ones in turn
+	Real nestedInterpolation(
+		const std::vector<std::vector<Real> >& grid,
+		const std::vector<Real>& values,
+		const std::vector<TensorProductInterpolation::Scheme>& schemes,
+		const std::vector<Real>& x, Size axis, Size offset)
+	{
+		const std::vector<Real>& nodes = grid[axis];
+		Size stride = 1;
+		for (Size i = axis + 1; i < grid.size(); ++i)
+			stride *= grid[i].size();
+		std::vector<Real> section(nodes.size());
+		for (Size j = 0; j < nodes.size(); ++j)
+			section[j] = axis + 1 == grid.size()
+				? values[offset + j]
+				: nestedInterpolation(grid, values, schemes, x, axis + 1,
+									  offset + j*stride);
+		if (schemes[axis] == TensorProductInterpolation::Cubic)
+			return CubicNaturalSpline(nodes.begin(), nodes.end(),
+									  section.begin())(x[axis], true);
+		else
+			return LinearInterpolation(nodes.begin(), nodes.end(),
+									   section.begin())(x[axis], true);
+	}
+
+}
+
+void InterpolationTest::testTensorProductInterpolation()
+{
+	BOOST_TEST_MESSAGE("Testing N-dimensional tensor-product interpolation...");
+
+	typedef TensorProductInterpolation::Scheme Scheme;
+	const Scheme schemes3[] = { TensorProductInterpolation::Cubic,
+								TensorProductInterpolation::Cubic,
+								TensorProductInterpolation::Cubic };
+	const Scheme schemes4[] = { TensorProductInterpolation::Linear,
+								TensorProductInterpolation::Cubic,
+								TensorProductInterpolation::Cubic,
+								TensorProductInterpolation::Linear };
+	const Size sizes3[] = { 5, 4, 6 };
+	const Size sizes4[] = { 4, 3, 7, 5 };
+
+	for (Size test = 0; test < 2; ++test)
+	{
+		const Size dims = test == 0 ? 3 : 4;
+		std::vector<Scheme> schemes(test == 0 ? schemes3 : schemes4,
+									(test == 0 ? schemes3 : schemes4) + dims);
+		std::vector<std::vector<Real> > grid(dims);
+		Size size = 1;
+		for (Size i = 0; i < dims; ++i)
+		{
+			const Size n = test == 0 ? sizes3[i] : sizes4[i];
+			for (Size j = 0; j < n; ++j)
+				grid[i].push_back(0.3*i + 0.4*j + 0.05*j*j);
+			size *= n;
+		}
+		std::vector<Real> values(size);
+		for (Size k = 0; k < size; ++k)
+			values[k] = std::sin(0.37*k) + 0.001*k;
+
+		TensorProductInterpolation f(grid, values, schemes);
+
+		// random points inside and around the grid
+		MersenneTwisterUniformRng rng(42);
+		const Size points = 200;
+		std::vector<Real> x(points*dims), batch(points);
+		for (Size k = 0; k < points; ++k)
+		{
+			for (Size i = 0; i < dims; ++i)
+			{
+				const Real lo = grid[i].front(), hi = grid[i].back();
+				x[k*dims + i] = lo - 0.1 + (hi - lo + 0.2)*rng.next().value;
+			}
+		}
+		f.values(&x[0], points, &batch[0], true);
+
+		const Real tol = 1.0e-12;
+		for (Size k = 0; k < points; ++k)
+		{
+			std::vector<Real> p(x.begin() + k*dims, x.begin() + (k + 1)*dims);
+			const Real expected =
+				nestedInterpolation(grid, values, schemes, p, 0, 0);
+			const Real calculated = f(p, true);
+			if (std::fabs(calculated - expected) > tol
+				|| std::fabs(batch[k] - expected) > tol)
+				BOOST_FAIL("failed to reproduce nested interpolation in "
+						   << dims << " dimensions"
+						   << std::setprecision(16)
+						   << "\n    point:      " << k
+						   << "\n    calculated: " << calculated
+						   << "\n    batch:      " << batch[k]
+						   << "\n    expected:   " << expected);
+		}
+
+		// the values at the nodes are reproduced
+		std::vector<Real> node(dims);
+		for (Size k = 0; k < size; k += 7)
+		{
+			Size rest = k;
+			for (Size i = dims; i > 0; --i)
+			{
+				node[i - 1] = grid[i - 1][rest % grid[i - 1].size()];
+				rest /= grid[i - 1].size();
+			}
+			if (std::fabs(f(node) - values[k]) > tol)
+				BOOST_FAIL("failed to reproduce node value in "
+						   << dims << " dimensions"
+						   << std::setprecision(16)
+						   << "\n    node:       " << k
+						   << "\n    calculated: " << f(node)
+						   << "\n    expected:   " << values[k]);
+		}
+	}
+}
+
+namespace {
+
+	// a Sabr model with only the interface required of XABR models,
+	// i.e., without batch volatilities or analytic gradients
+	class PlainSabrWrapper
+	{
+	  public:
+		PlainSabrWrapper(const Time t, const Real& forward,
+						 const std::vector<Real>& params,
+						 const std::vector<Real>&)
+		: t_(t), forward_(forward), params_(params) {}
+		Real volatility(const Real x)
+		{
+			return sabrVolatility(x, forward_, t_, params_[0], params_[1],
+								  params_[2], params_[3]);
+		}
+	  private:
+		const Real t_, &forward_;
+		const std::vector<Real>& params_;
+	};
+
+	struct PlainSabrSpecs : QuantLib::detail::SABRSpecs
+	{
+		typedef PlainSabrWrapper type;
+		boost::shared_ptr<type> instance(const Time t, const Real& forward,
+										 const std::vector<Real>& params,
+										 const std::vector<Real>& addParams)
+		{
+			return boost::shared_ptr<type>(
+				new PlainSabrWrapper(t, forward, params, addParams));
+		}
+	};
+
+}
+
+void InterpolationTest::testSabrGradients()
+{
+	BOOST_TEST_MESSAGE("Testing Sabr batch volatilities and gradients...");
+
+	const Real alphas[] = { 0.05, 0.3 };
+	const Real betas[] = { 0.0, 0.6, 1.0 };
+	const Real nus[] = { 0.02, 0.8 };
+	const Real rhos[] = { -0.7, 0.01, 0.5 };
+	const Real shifts[] = { 0.0, 0.01 };
+	const Real forward = 0.039, expiry = 2.5;
+	// includes the forward itself, where z vanishes
+	std::vector<Real> strikes;
+	for (Size i = 0; i < 13; ++i)
+		strikes.push_back(0.015 + 0.004*i);
+	strikes.push_back(forward);
+	std::vector<Real> batch(strikes.size());
+
+	for (Size a = 0; a < LENGTH(alphas); ++a)
+	{
+		for (Size b = 0; b < LENGTH(betas); ++b)
+		{
+			for (Size n = 0; n < LENGTH(nus); ++n)
+			{
+				for (Size r = 0; r < LENGTH(rhos); ++r)
+				{
+					const Real p[] = { alphas[a], betas[b], nus[n], rhos[r] };
+					for (Size s = 0; s < LENGTH(shifts); ++s)
+					{
+						sabrVolatilities(&strikes[0], strikes.size(), forward,
+										 expiry, p[0], p[1], p[2], p[3],
+										 &batch[0], shifts[s]);
+						for (Size i = 0; i < strikes.size(); ++i)
+						{
+							const Real expected = shiftedSabrVolatility(
+								strikes[i], forward, expiry, p[0], p[1], p[2],
+								p[3], shifts[s]);
+							if (std::fabs(batch[i] - expected) > 1.0e-11*expected)
+								BOOST_FAIL("failed to reproduce Sabr volatility"
+										   << std::setprecision(16)
+										   << "\n    strike:     " << strikes[i]
+										   << "\n    shift:      " << shifts[s]
+										   << "\n    calculated: " << batch[i]
+										   << "\n    expected:   " << expected);
+						}
+					}
+
+					// gradient against central differences, which lose
+					// some precision for large volatilities
+					Real gradient[4];
+					for (Size i = 0; i < strikes.size(); ++i)
+					{
+						const Real vol = unsafeSabrVolatilityGradient(
+							strikes[i], forward, expiry, p[0], p[1], p[2], p[3],
+							gradient);
+						const Real expectedVol = unsafeSabrVolatility(
+							strikes[i], forward, expiry, p[0], p[1], p[2], p[3]);
+						if (std::fabs(vol - expectedVol) > 1.0e-14*expectedVol)
+							BOOST_FAIL("failed to reproduce Sabr volatility"
+									   << std::setprecision(16)
+									   << "\n    strike:     " << strikes[i]
+									   << "\n    calculated: " << vol
+									   << "\n    expected:   " << expectedVol);
+						for (Size k = 0; k < 4; ++k)
+						{
+							const Real h = 1.0e-6;
+							Real up[4], down[4];
+							std::copy(p, p + 4, up);
+							std::copy(p, p + 4, down);
+							up[k] += h;
+							down[k] -= h;
+							const Real expected =
+								(unsafeSabrVolatility(strikes[i], forward,
+													  expiry, up[0], up[1],
+													  up[2], up[3])
+								 - unsafeSabrVolatility(strikes[i], forward,
+														expiry, down[0],
+														down[1], down[2],
+														down[3])) / (2.0*h);
+							if (std::fabs(gradient[k] - expected)
+								> 1.0e-6*std::max(1.0, vol))
+								BOOST_FAIL("failed to reproduce Sabr gradient"
+										   << std::setprecision(16)
+										   << "\n    parameter:  " << k
+										   << "\n    alpha:      " << p[0]
+										   << "\n    beta:       " << p[1]
+										   << "\n    nu:         " << p[2]
+										   << "\n    rho:        " << p[3]
+										   << "\n    strike:     " << strikes[i]
+										   << "\n    calculated: " << gradient[k]
+										   << "\n    expected:   " << expected);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// the default calibration uses the analytic jacobian
+	std::vector<Real> volatilities(strikes.size());
+	for (Size i = 0; i < strikes.size(); ++i)
+		volatilities[i] = sabrVolatility(strikes[i], forward, expiry,
+										 0.3, 0.6, 0.02, 0.01);
+	SABRInterpolation sabr(strikes.begin(), strikes.end(),
+						   volatilities.begin(), expiry, forward,
+						   std::sqrt(0.2), 0.6, std::sqrt(0.4), 0.0,
+						   false, true, false, false, false,
+						   boost::shared_ptr<EndCriteria>(),
+						   boost::shared_ptr<OptimizationMethod>(), 1.0E-10);
+	sabr.update();
+	const Real expected[] = { 0.3, 0.6, 0.02, 0.01 };
+	const Real calibrated[] = { sabr.alpha(), sabr.beta(), sabr.nu(),
+								sabr.rho() };
+	for (Size k = 0; k < 4; ++k)
+		if (std::fabs(calibrated[k] - expected[k]) > 5.0e-8)
+			BOOST_FAIL("failed to calibrate Sabr parameter " << k
+					   << std::setprecision(16)
+					   << "\n    calibrated: " << calibrated[k]
+					   << "\n    expected:   " << expected[k]);
+
+	// models without the optional interface are calibrated with
+	// finite differences
+	std::vector<Real> guess(4);
+	guess[0] = std::sqrt(0.2);
+	guess[1] = 0.6;
+	guess[2] = std::sqrt(0.4);
+	guess[3] = 0.0;
+	std::vector<bool> isFixed(4, false);
+	isFixed[1] = true;
+	QuantLib::detail::XABRInterpolationImpl<std::vector<Real>::iterator,
+											std::vector<Real>::iterator,
+											PlainSabrSpecs>
+		plain(strikes.begin(), strikes.end(), volatilities.begin(), expiry,
+			  forward, guess, isFixed, false,
+			  boost::shared_ptr<EndCriteria>(),
+			  boost::shared_ptr<OptimizationMethod>(), 1.0E-10, false, 50,
+			  std::vector<Real>(1, 0.0));
+	plain.update();
+	for (Size k = 0; k < 4; ++k)
+		if (std::fabs(plain.params_[k] - expected[k]) > 1.0e-6)
+			BOOST_FAIL("failed to calibrate Sabr parameter " << k
+					   << " with finite differences"
+					   << std::setprecision(16)
+					   << "\n    calibrated: " << plain.params_[k]
+					   << "\n    expected:   " << expected[k]);
+}
+
+
+void InterpolationTest::testSabrSmileCalibration()
+{
+	BOOST_TEST_MESSAGE("Testing Sabr calibration of a grid of smiles...");
+
+	const Size rows = 3, columns = 4;
+	std::vector<Time> expiries(rows);
+	std::vector<std::vector<Rate> > forwards(rows, std::vector<Rate>(columns));
+	std::vector<std::vector<std::vector<Rate> > > strikes(
+		rows, std::vector<std::vector<Rate> >(columns));
+	std::vector<std::vector<std::vector<Volatility> > > volatilities(
+		rows, std::vector<std::vector<Volatility> >(columns));
+	std::vector<std::vector<std::vector<Real> > > parameters(
+		rows, std::vector<std::vector<Real> >(columns, std::vector<Real>(4)));
+	const Real beta = 0.5;
+	for (Size i = 0; i < rows; ++i)
+	{
+		expiries[i] = 0.5 + 2.0*i;
+		for (Size j = 0; j < columns; ++j)
+		{
+			forwards[i][j] = 0.03 + 0.002*i + 0.001*j;
+			std::vector<Real>& p = parameters[i][j];
+			p[0] = 0.04 + 0.005*j - 0.003*i;
+			p[1] = beta;
+			p[2] = 0.5 - 0.05*i + 0.02*j;
+			p[3] = -0.3 + 0.1*i - 0.05*j;
+			for (Size k = 0; k < 11; ++k)
+			{
+				strikes[i][j].push_back(forwards[i][j]*(0.5 + 0.1*k));
+				volatilities[i][j].push_back(sabrVolatility(
+					strikes[i][j].back(), forwards[i][j], expiries[i],
+					p[0], p[1], p[2], p[3]));
+			}
+		}
+	}
+
+	SabrSmileCalibration calibration(expiries, forwards, strikes, volatilities,
+									 Null<Real>(), beta, Null<Real>(),
+									 Null<Real>(), false, true, false, false,
+									 false, 1.0E-10);
+	calibration.compute();
+
+	const Real tolerance = 1.0e-6;
+	for (Size i = 0; i < rows; ++i)
+	{
+		for (Size j = 0; j < columns; ++j)
+		{
+			const std::vector<Real>& calibrated = calibration.parameters(i, j);
+			for (Size k = 0; k < 4; ++k)
+				if (std::fabs(calibrated[k] - parameters[i][j][k]) > tolerance)
+					BOOST_FAIL("failed to calibrate Sabr parameter " << k
+							   << " at node (" << i << "," << j << ")"
+							   << std::setprecision(16)
+							   << "\n    calibrated: " << calibrated[k]
+							   << "\n    expected:   " << parameters[i][j][k]);
+			const boost::shared_ptr<SabrSmileSection>& section =
+				calibration.smileSection(i, j);
+			for (Size k = 0; k < strikes[i][j].size(); ++k)
+			{
+				const Volatility vol = section->volatility(strikes[i][j][k]);
+				if (std::fabs(vol - volatilities[i][j][k]) > tolerance)
+					BOOST_FAIL("failed to reproduce smile at node ("
+							   << i << "," << j << ")"
+							   << std::setprecision(16)
+							   << "\n    strike:     " << strikes[i][j][k]
+							   << "\n    calculated: " << vol
+							   << "\n    expected:   " << volatilities[i][j][k]);
+			}
+		}
+	}
+}
+
+
+namespace {
+
+	template <Size N>
+	void checkFixedSizeInterpolation(const Real* x, const Real* y)
+	{
+		FixedSizeInterpolation<N, Linear> linear(x, x + N, y);
+		FixedSizeInterpolation<N, LogLinear> logLinear(x, x + N, y);
+		FixedSizeInterpolation<N, CubicNaturalSpline> spline(x, x + N, y);
+		LinearInterpolation linearRef(x, x + N, y);
+		LogLinearInterpolation logLinearRef(x, x + N, y);
+		CubicNaturalSpline splineRef(x, x + N, y);
+
+		const Real tol = 1.0e-12;
+		const Real xMin = x[0] - 0.5, xMax = x[N - 1] + 0.5;
+		for (Size k = 0; k <= 200; ++k)
+		{
+			// includes the nodes and points outside the range
+			const Real t = xMin + (xMax - xMin)*k / 200.0;
+			const Real points[] = { t, x[k % N] };
+			for (Size p = 0; p < LENGTH(points); ++p)
+			{
+				const Real z = points[p];
+				const Real calculated[] = {
+					linear(z, true), linear.derivative(z, true),
+					logLinear(z, true), logLinear.derivative(z, true),
+					logLinear.secondDerivative(z, true),
+					spline(z, true), spline.derivative(z, true),
+					spline.secondDerivative(z, true) };
+				const Real expected[] = {
+					linearRef(z, true), linearRef.derivative(z, true),
+					logLinearRef(z, true), logLinearRef.derivative(z, true),
+					logLinearRef.secondDerivative(z, true),
+					splineRef(z, true), splineRef.derivative(z, true),
+					splineRef.secondDerivative(z, true) };
+				for (Size i = 0; i < LENGTH(calculated); ++i)
+					if (std::fabs(calculated[i] - expected[i])
+						> tol*std::max(1.0, std::fabs(expected[i])))
+						BOOST_FAIL("failed to reproduce interpolation with "
+								   << N << " nodes"
+								   << std::setprecision(16)
+								   << "\n    result:     " << i
+								   << "\n    x:          " << z
+								   << "\n    calculated: " << calculated[i]
+								   << "\n    expected:   " << expected[i]);
+			}
+		}
+
+		// extrapolation is checked as in the Interpolation classes
+		BOOST_CHECK_THROW(spline(xMax), Error);
+		spline.enableExtrapolation();
+		BOOST_CHECK_NO_THROW(spline(xMax));
+	}
+
+}
+
+void InterpolationTest::testFixedSizeInterpolation()
+{
+	BOOST_TEST_MESSAGE("Testing fixed-size interpolations...");
+
+	const Real x[] = { 0.1, 0.25, 0.5, 1.0, 2.0, 3.0, 5.0, 7.0,
+					   10.0, 15.0, 20.0, 30.0 };
+	const Real y[] = { 0.011, 0.013, 0.012, 0.016, 0.021, 0.024,
+					   0.023, 0.026, 0.030, 0.031, 0.029, 0.032 };
+
+	checkFixedSizeInterpolation<2>(x, y);
+	checkFixedSizeInterpolation<3>(x, y);
+	checkFixedSizeInterpolation<5>(x, y);
+	checkFixedSizeInterpolation<12>(x, y);
+
+	// new values at the nodes
+	const Real* xBegin = x;
+	FixedSizeInterpolation<5, CubicNaturalSpline> spline(xBegin, xBegin + 5, y);
+	spline.update(y + 1);
+	CubicNaturalSpline splineRef(xBegin, xBegin + 5, y + 1);
+	for (Real z = 0.1; z < 2.0; z += 0.05)
+		if (std::fabs(spline(z) - splineRef(z)) > 1.0e-15)
+			BOOST_FAIL("failed to update fixed-size spline"
+					   << std::setprecision(16)
+					   << "\n    x:          " << z
+					   << "\n    calculated: " << spline(z)
+					   << "\n    expected:   " << splineRef(z));
+}
+
+void InterpolationTest::testConvexMonotoneSections()
+{
+	BOOST_TEST_MESSAGE("Testing convex-monotone interpolation sections...");
+
+	const Real times[] = { 0.0, 0.25, 0.5, 1.0, 2.0, 3.0, 5.0, 7.0,
+						   10.0, 15.0, 20.0, 30.0 };
+	// the first value is ignored; the dip exercises the sections
+	// which avoid negative values
+	const Real forwards[] = { 0.0, 0.011, 0.013, 0.002, 0.0005, 0.024,
+							  0.023, 0.026, 0.030, 0.031, 0.029, 0.032 };
+	std::vector<Real> x(times, times + LENGTH(times));
+	std::vector<Real> y(forwards, forwards + LENGTH(forwards));
+	const Size n = x.size();
+
+	const Real quadraticities[] = { 0.0, 0.3, 1.0 };
+	const Real monotonicities[] = { 0.0, 0.7, 1.0 };
+	const bool positivity[] = { false, true };
+	const Real tolerance = 1.0e-12;
+
+	for (Size i = 0; i < LENGTH(quadraticities); ++i)
+	{
+		for (Size j = 0; j < LENGTH(monotonicities); ++j)
+		{
+			for (Size k = 0; k < LENGTH(positivity); ++k)
+			{
+				ConvexMonotone method(quadraticities[i], monotonicities[j],
+									  positivity[k]);
+				Interpolation full =
+					method.interpolate(x.begin(), x.end(), y.begin());
+
+				// the averages over the periods are reproduced
+				Real integral = 0.0;
+				for (Size l = 1; l < n; ++l)
+				{
+					integral += y[l] * (x[l] - x[l - 1]);
+					if (std::fabs(full.primitive(x[l]) - integral) > tolerance)
+						BOOST_FAIL("wrong primitive at node " << l
+								   << std::setprecision(16)
+								   << "\n    quadraticity: " << quadraticities[i]
+								   << "\n    monotonicity: " << monotonicities[j]
+								   << "\n    calculated:   " << full.primitive(x[l])
+								   << "\n    expected:     " << integral);
+				}
+
+				if (positivity[k])
+				{
+					for (Real t = x.front(); t < x.back() + 1.0; t += 0.01)
+						if (full(t, true) < 0.0)
+							BOOST_FAIL("negative value " << full(t, true)
+									   << " at " << t
+									   << "\n    quadraticity: "
+									   << quadraticities[i]
+									   << "\n    monotonicity: "
+									   << monotonicities[j]);
+				}
+
+				// adding one node at a time, reusing the sections
+				// calculated for the previous nodes
+				Interpolation local;
+				for (Size l = 2; l <= n; ++l)
+				{
+					local = method.localInterpolate(x.begin(),
+													x.begin() + l,
+													y.begin(), 1, local, n);
+				}
+				for (Real t = x.front(); t < x.back() + 1.0; t += 0.01)
+				{
+					if (std::fabs(local(t, true) - full(t, true)) > tolerance
+						|| std::fabs(local.primitive(t, true)
+									 - full.primitive(t, true)) > tolerance)
+						BOOST_FAIL("local interpolation differs from the "
+								   "global one at " << t
+								   << std::setprecision(16)
+								   << "\n    quadraticity: " << quadraticities[i]
+								   << "\n    monotonicity: " << monotonicities[j]
+								   << "\n    local value:  " << local(t, true)
+								   << "\n    global value: " << full(t, true));
+				}
+			}
+		}
+	}
+}
+
+
 test_suite* InterpolationTest::suite()
 {
 	test_suite* suite = BOOST_TEST_SUITE("Interpolation tests");
@@ -2465,6 +3517,22 @@ test_suite* InterpolationTest::suite()
 	suite->add(QUANTLIB_TEST_CASE(
 		&InterpolationTest::testLagrangeInterpolationOnChebyshevPoints));
 	suite->add(QUANTLIB_TEST_CASE(&InterpolationTest::testBSplines));
+	suite->add(QUANTLIB_TEST_CASE(&InterpolationTest::testBatchEvaluation));
+	suite->add(QUANTLIB_TEST_CASE(&InterpolationTest::testLocalityHint));
+	suite->add(QUANTLIB_TEST_CASE(
+		&InterpolationTest::testIncrementalSplineUpdate));
+	suite->add(QUANTLIB_TEST_CASE(
+		&InterpolationTest::testKernelInterpolationSolvers));
+	suite->add(QUANTLIB_TEST_CASE(&InterpolationTest::testPrecomputedSurfaces));
+	suite->add(QUANTLIB_TEST_CASE(
+		&InterpolationTest::testTensorProductInterpolation));
+	suite->add(QUANTLIB_TEST_CASE(&InterpolationTest::testSabrGradients));
+	suite->add(QUANTLIB_TEST_CASE(
+		&InterpolationTest::testSabrSmileCalibration));
+	suite->add(QUANTLIB_TEST_CASE(
+		&InterpolationTest::testFixedSizeInterpolation));
+	suite->add(QUANTLIB_TEST_CASE(
+		&InterpolationTest::testConvexMonotoneSections));
 
 	return suite;
 }
@@ -35,12 +35,18 @@ class MatricesTest {
     static void testSVD();
     static void testQRDecomposition();
     static void testQRSolve();
+    static void testQRLeastSquares();
     static void testInverse();
     static void testDeterminant();
     static void testOrthogonalProjection();
     static void testCholeskyDecomposition();
     static void testMoorePenroseInverse();
     static void testIterativeSolvers();
+    static void testTruncatedDecompositions();
+    static void testCsrMatrix();
+    static void testTridiagonalFactorization();
+    static void benchmarkSparseProductUblas();
+    static void benchmarkSparseProductCsr();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -72,13 +78,17 @@ class MatricesTest {
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/math/matrixutilities/svd.hpp>
+#include <ql/math/matrixutilities/truncatedsvd.hpp>
 #include <ql/math/matrixutilities/gmres.hpp>
 #include <ql/math/matrixutilities/bicgstab.hpp>
+#include <ql/math/matrixutilities/csrmatrix.hpp>
+#include <ql/math/matrixutilities/sparseilupreconditioner.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/math/matrixutilities/qrdecomposition.hpp>
 #include <ql/math/matrixutilities/basisincompleteordered.hpp>
 #include <ql/experimental/math/moorepenroseinverse.hpp>
+#include <ql/methods/finitedifferences/tridiagonaloperator.hpp>
 
 #include <boost/math/special_functions/fpclassify.hpp>
 
@@ -376,6 +386,56 @@ void MatricesTest::testQRSolve() {
     }
 }
 
+void MatricesTest::testQRLeastSquares() {
+
+    BOOST_TEST_MESSAGE("Testing reusable QR least squares solver...");
+
+    const Size m = 40, n = 6;
+    const Real tol = 1.0e-12;
+    MersenneTwisterUniformRng rng(1234UL);
+
+    QRLeastSquares solver;
+    Array b(m), x(n), qtb(m);
+    for (Size trial=0; trial<3; ++trial) {
+        Matrix A(m, n);
+        for (Size i=0; i<m; ++i) {
+            for (Size j=0; j<n; ++j)
+                A[i][j] = rng.nextReal() - 0.5;
+            b[i] = rng.nextReal();
+        }
+        // the last trial has a column duplicating the first one
+        if (trial == 2)
+            std::copy(A.column_begin(0), A.column_end(0),
+                      A.column_begin(n-1));
+
+        solver.factorize(A);
+        const Size expectedRank = (trial == 2) ? n-1 : n;
+        if (solver.rank() != expectedRank)
+            BOOST_FAIL("wrong numerical rank " << solver.rank()
+                       << ", expected " << expectedRank);
+
+        qtb = b;
+        solver.solveFor(qtb, x);
+        const Array y = solver.solveFor(b);
+
+        // the fitted values are unique even for rank-deficient A
+        const Array fitted = A*x;
+        const Array expected = A*SVD(A).solveFor(b);
+        const Array reference = qrSolve(A, b);
+        for (Size i=0; i<m; ++i)
+            if (std::fabs(fitted[i] - expected[i]) > tol)
+                BOOST_FAIL("fitted value " << i << " is " << fitted[i]
+                           << ", expected " << expected[i]);
+        for (Size j=0; j<n; ++j) {
+            if (std::fabs(x[j] - y[j]) > tol)
+                BOOST_FAIL("in-place and allocating solutions differ");
+            if (solver.rank() == n && std::fabs(x[j] - reference[j]) > tol)
+                BOOST_FAIL("coefficient " << j << " is " << x[j]
+                           << ", expected " << reference[j]);
+        }
+    }
+}
+
 void MatricesTest::testInverse() {
 
     BOOST_TEST_MESSAGE("Testing LU inverse calculation...");
@@ -719,6 +779,294 @@ void MatricesTest::testIterativeSolvers() {
     #endif
 }
 
+void MatricesTest::testTruncatedDecompositions() {
+    BOOST_TEST_MESSAGE("Testing truncated eigen and singular value "
+                       "decompositions...");
+
+    // correlation matrix of a five sectors factor model
+    const Size n = 120, factors = 5;
+    MersenneTwisterUniformRng rng(1234UL);
+    Matrix loadings(n, factors, 0.0);
+    for (Size i=0; i<n; ++i)
+        loadings[i][i%factors] = 0.7 + 0.2*rng.nextReal();
+    Matrix corr = loadings * transpose(loadings);
+    for (Size i=0; i<n; ++i)
+        corr[i][i] = 1.0;
+
+    const Real tol = 1.0e-8;
+
+    SymmetricSchurDecomposition full(corr);
+    TruncatedEigenDecomposition truncated(corr, factors);
+    for (Size j=0; j<factors; ++j) {
+        Real expected = full.eigenvalues()[j];
+        Real calculated = truncated.eigenvalues()[j];
+        if (std::fabs(calculated-expected) > tol*expected)
+            BOOST_FAIL("truncated eigenvalue #" << j << " is " << calculated
+                       << ", expected " << expected);
+        // eigenvectors are determined up to the sign
+        Real overlap = 0.0;
+        for (Size i=0; i<n; ++i)
+            overlap += full.eigenvectors()[i][j] *
+                       truncated.eigenvectors()[i][j];
+        if (std::fabs(std::fabs(overlap) - 1.0) > tol)
+            BOOST_FAIL("truncated eigenvector #" << j
+                       << " not aligned with full one (overlap "
+                       << overlap << ")");
+    }
+
+    Matrix fullSqrt = rankReducedSqrt(corr, factors, 1.0,
+                                      SalvagingAlgorithm::Spectral);
+    Matrix truncatedSqrt =
+        rankReducedSqrt(corr, factors, 1.0, SalvagingAlgorithm::Spectral,
+                        RankReductionAlgorithm::TruncatedSpectral);
+    if (truncatedSqrt.columns() != fullSqrt.columns())
+        BOOST_FAIL("truncated rank reduced sqrt has "
+                   << truncatedSqrt.columns() << " factors, expected "
+                   << fullSqrt.columns());
+    Real error = norm(truncatedSqrt*transpose(truncatedSqrt)
+                      - fullSqrt*transpose(fullSqrt));
+    if (error > tol)
+        BOOST_FAIL("truncated rank reduced sqrt does not reproduce the "
+                   "full one (norm of difference " << error << ")");
+
+    // rectangular matrices, both orientations
+    Matrix A = loadings * transpose(loadings);
+    Matrix B(n, 40);
+    for (Size i=0; i<n; ++i)
+        for (Size j=0; j<40; ++j)
+            B[i][j] = A[i][j] + 1.0e-3*rng.nextReal();
+    Matrix testMatrices[] = { B, transpose(B) };
+    for (Size t=0; t<LENGTH(testMatrices); ++t) {
+        const Matrix& C = testMatrices[t];
+        SVD svd(C);
+        TruncatedSVD tsvd(C, factors);
+        for (Size j=0; j<factors; ++j) {
+            Real expected = svd.singularValues()[j];
+            Real calculated = tsvd.singularValues()[j];
+            if (std::fabs(calculated-expected) > tol*expected)
+                BOOST_FAIL("truncated singular value #" << j << " is "
+                           << calculated << ", expected " << expected);
+        }
+        Real reconstructionError =
+            norm(tsvd.U()*tsvd.S()*transpose(tsvd.V()) - C);
+        Real expectedError = 0.0;
+        for (Size j=factors; j<svd.singularValues().size(); ++j)
+            expectedError += svd.singularValues()[j]*svd.singularValues()[j];
+        expectedError = std::sqrt(expectedError);
+        if (std::fabs(reconstructionError - expectedError) > 1.0e-6)
+            BOOST_FAIL("truncated SVD reconstruction error is "
+                       << reconstructionError << ", expected "
+                       << expectedError);
+    }
+}
+
+void MatricesTest::testTridiagonalFactorization() {
+
+    BOOST_TEST_MESSAGE("Testing batched tridiagonal solver...");
+
+    const Size n = 50, count = 7;
+    MersenneTwisterUniformRng rng(1234UL);
+
+    Array low(n-1), mid(n), high(n-1);
+    for (Size i=0; i<n-1; ++i) {
+        low[i] = rng.nextReal() - 0.5;
+        high[i] = rng.nextReal() - 0.5;
+    }
+    for (Size i=0; i<n; ++i)
+        mid[i] = 1.0 + rng.nextReal();
+    const TridiagonalOperator L(low, mid, high);
+    const TridiagonalFactorization factorization(L);
+
+    if (!factorization.factorizes(L))
+        BOOST_FAIL("factorization does not match its operator");
+
+    Array rhs(n*count);
+    for (Size i=0; i<rhs.size(); ++i)
+        rhs[i] = rng.nextReal();
+
+    Array batch(n*count), inPlace = rhs;
+    factorization.solveFor(rhs, batch, count);
+    factorization.solveFor(inPlace, inPlace, count);
+
+    const Real tolerance = 1.0e-13;
+    for (Size k=0; k<count; ++k) {
+        Array b(n), single(n);
+        for (Size i=0; i<n; ++i)
+            b[i] = rhs[i*count+k];
+        factorization.solveFor(b, single);
+        const Array expected = L.solveFor(b);
+        const Array residual = L.applyTo(single) - b;
+
+        for (Size i=0; i<n; ++i) {
+            if (std::fabs(batch[i*count+k] - expected[i]) > tolerance
+                || std::fabs(inPlace[i*count+k] - expected[i]) > tolerance
+                || std::fabs(single[i] - expected[i]) > tolerance
+                || std::fabs(residual[i]) > tolerance)
+                BOOST_FAIL("failed to reproduce tridiagonal solution"
+                           << std::setprecision(16)
+                           << "\n    right-hand side: " << k
+                           << "\n    element:         " << i
+                           << "\n    batched:         " << batch[i*count+k]
+                           << "\n    in place:        "
+                           << inPlace[i*count+k]
+                           << "\n    single:          " << single[i]
+                           << "\n    expected:        " << expected[i]
+                           << "\n    residual:        " << residual[i]);
+        }
+    }
+
+    TridiagonalOperator modified = L;
+    modified.setMidRow(n/2, low[n/2-1], mid[n/2] + 1.0, high[n/2]);
+    if (factorization.factorizes(modified))
+        BOOST_FAIL("factorization matches a modified operator");
+}
+
+#if !defined(QL_NO_UBLAS_SUPPORT)
+
+namespace {
+
+    // five-point convection-diffusion operator on a square grid
+    SparseMatrix convectionDiffusionMatrix(Size gridSize) {
+        const Size n = gridSize*gridSize;
+        SparseMatrix m(n, n, 5*n);
+        for (Size i=0; i<gridSize; ++i) {
+            for (Size j=0; j<gridSize; ++j) {
+                const Size k = i*gridSize + j;
+                if (i > 0)          m(k, k-gridSize) = -1.2;
+                if (j > 0)          m(k, k-1)        = -1.1;
+                m(k, k) = 4.0;
+                if (j+1 < gridSize) m(k, k+1)        = -0.9;
+                if (i+1 < gridSize) m(k, k+gridSize) = -0.8;
+            }
+        }
+        return m;
+    }
+
+    class IluPreconditioner :
+        public std::unary_function<const Array&, Disposable<Array> > {
+      public:
+        explicit IluPreconditioner(const SparseILUPreconditioner& p)
+        : p_(p) {}
+        Disposable<Array> operator()(const Array& x) const {
+            return p_.apply(x);
+        }
+      private:
+        const SparseILUPreconditioner& p_;
+    };
+
+    class SparseMatrixMult :
+        public std::unary_function<const Array&, Disposable<Array> > {
+      public:
+        explicit SparseMatrixMult(const SparseMatrix& m) : m_(m) {}
+        Disposable<Array> operator()(const Array& x) const {
+            return prod(m_, x);
+        }
+      private:
+        const SparseMatrix& m_;
+    };
+
+    const Size sparseProductGridSize = 500;
+    const Size sparseProductSteps = 1000;
+
+}
+
+void MatricesTest::testCsrMatrix() {
+    BOOST_TEST_MESSAGE("Testing CSR sparse matrix...");
+
+    const Size gridSize = 20, n = gridSize*gridSize;
+    const SparseMatrix A = convectionDiffusionMatrix(gridSize);
+    const CsrMatrix csr(A);
+
+    if (csr.rows() != n || csr.columns() != n || csr.nonZeros() != A.nnz())
+        BOOST_FAIL("CSR matrix has wrong dimensions: " << csr.rows() << "x"
+                   << csr.columns() << " with " << csr.nonZeros()
+                   << " non-zeros, expected " << n << "x" << n << " with "
+                   << A.nnz());
+
+    Matrix dense(n, n, 0.0);
+    for (Size i=0; i<n; ++i)
+        for (Size j=0; j<n; ++j)
+            dense[i][j] = A(i, j);
+    const CsrMatrix fromDense(dense);
+
+    for (Size i=0; i<n; ++i)
+        for (Size j=0; j<n; ++j)
+            if (csr(i, j) != dense[i][j] || fromDense(i, j) != dense[i][j])
+                BOOST_FAIL("CSR element (" << i << "," << j << ") is "
+                           << csr(i, j) << ", expected " << dense[i][j]);
+
+    Array x(n);
+    MersenneTwisterUniformRng rng(42UL);
+    for (Size i=0; i<n; ++i)
+        x[i] = rng.nextReal() - 0.5;
+
+    const Array expected = dense*x;
+    const Array calculated = prod(csr, x);
+    Array inPlace(n);
+    prod(csr, x, inPlace);
+    const Array ublas = prod(A, x);
+    const Real tol = 1e4*QL_EPSILON;
+    if (norm2(calculated - expected) > tol
+        || norm2(inPlace - expected) > tol
+        || norm2(ublas - expected) > tol)
+        BOOST_FAIL("CSR matrix-vector product does not match the dense one"
+                   << "\n  csr error  : " << norm2(calculated - expected)
+                   << "\n  ublas error: " << norm2(ublas - expected));
+
+    const Real relTol = 1e-10;
+    const SparseILUPreconditioner ilu(csr, 1);
+    const SparseILUPreconditioner iluUblas(A, 1);
+    const Array p = ilu.apply(x);
+    if (norm2(p - iluUblas.apply(x)) > tol)
+        BOOST_FAIL("ILU preconditioner built from CSR matrix differs from "
+                   "the ublas one");
+
+    const boost::shared_ptr<const CsrMatrix> sharedCsr(new CsrMatrix(csr));
+    const BiCGStabResult bicg =
+        BiCGstab(sharedCsr, 100, relTol, IluPreconditioner(ilu)).solve(expected);
+    const BiCGStabResult bicgUblas =
+        BiCGstab(SparseMatrixMult(A), 100, relTol,
+                 IluPreconditioner(iluUblas)).solve(expected);
+    if (norm2(dense*bicg.x - expected)/norm2(expected) > relTol
+        || bicg.iterations != bicgUblas.iterations)
+        BOOST_FAIL("Failed to solve CSR system using BiCGstab"
+                   << "\n  rel error : "
+                   << norm2(dense*bicg.x - expected)/norm2(expected)
+                   << "\n  iterations: " << bicg.iterations
+                   << " (ublas: " << bicgUblas.iterations << ")");
+
+    const GMRESResult gmres =
+        GMRES(sharedCsr, 100, relTol, IluPreconditioner(ilu)).solve(expected);
+    if (norm2(dense*gmres.x - expected)/norm2(expected) > relTol)
+        BOOST_FAIL("Failed to solve CSR system using GMRES"
+                   << "\n  rel error : "
+                   << norm2(dense*gmres.x - expected)/norm2(expected));
+}
+
+void MatricesTest::benchmarkSparseProductUblas() {
+    const SparseMatrix A = convectionDiffusionMatrix(sparseProductGridSize);
+    Array x(A.size1(), 1.0);
+    for (Size i=0; i<sparseProductSteps; ++i)
+        x = 0.25*prod(A, x);
+    if (!(Norm2(x) >= 0.0))
+        BOOST_FAIL("ublas matrix-vector product failed");
+}
+
+void MatricesTest::benchmarkSparseProductCsr() {
+    const CsrMatrix A(
+        convectionDiffusionMatrix(sparseProductGridSize));
+    Array x(A.rows(), 1.0), y(A.rows());
+    for (Size i=0; i<sparseProductSteps; ++i) {
+        prod(A, x, y);
+        x.swap(y);
+        x *= 0.25;
+    }
+    if (!(Norm2(x) >= 0.0))
+        BOOST_FAIL("CSR matrix-vector product failed");
+}
+
+#endif
+
 test_suite* MatricesTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Matrix tests");
 
@@ -729,6 +1077,7 @@ test_suite* MatricesTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testHighamSqrt));
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testQRDecomposition));
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testQRSolve));
+    suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testQRLeastSquares));
     #if !defined(QL_NO_UBLAS_SUPPORT)
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testInverse));
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testDeterminant));
@@ -736,6 +1085,13 @@ test_suite* MatricesTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testCholeskyDecomposition));
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testMoorePenroseInverse));
     suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testIterativeSolvers));
+    suite->add(QUANTLIB_TEST_CASE(
+                        &MatricesTest::testTruncatedDecompositions));
+    suite->add(QUANTLIB_TEST_CASE(
+                        &MatricesTest::testTridiagonalFactorization));
+    #if !defined(QL_NO_UBLAS_SUPPORT)
+    suite->add(QUANTLIB_TEST_CASE(&MatricesTest::testCsrMatrix));
+    #endif
     return suite;
 }
 
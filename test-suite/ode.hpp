@@ -30,6 +30,8 @@ class OdeTest {
     static void testAdaptiveRungeKutta();
     static void testMatrixExponential();
     static void testMatrixExponentialOfZero();
+    static void testPadeMatrixExponential();
+    static void testMatrixExponentialAction();
 
     static boost::unit_test_framework::test_suite* suite();
 };
@@ -248,11 +250,106 @@ void OdeTest::testMatrixExponentialOfZero() {
     }
 }
 
+void OdeTest::testPadeMatrixExponential() {
+    BOOST_TEST_MESSAGE("Testing matrix exponential based on "
+                       "scaling and squaring...");
+
+    Matrix m(3, 3);
+    m[0][0] = 5; m[0][1] =-6; m[0][2] =-6;
+    m[1][0] =-1; m[1][1] = 4; m[1][2] = 2;
+    m[2][0] = 3; m[2][1] =-6; m[2][2] =-4;
+
+    const Real tol = 1e-13;
+
+    for (Real t=0.001; t < 11; t+=t) {
+        Matrix expected(3, 3);
+        expected[0][0] = -3*std::exp(t)+4*std::exp(2*t);
+        expected[0][1] =  6*std::exp(t)-6*std::exp(2*t);
+        expected[0][2] =  6*std::exp(t)-6*std::exp(2*t);
+        expected[1][0] =    std::exp(t)-  std::exp(2*t);
+        expected[1][1] = -2*std::exp(t)+3*std::exp(2*t);
+        expected[1][2] = -2*std::exp(t)+2*std::exp(2*t);
+        expected[2][0] = -3*std::exp(t)+3*std::exp(2*t);
+        expected[2][1] =  6*std::exp(t)-6*std::exp(2*t);
+        expected[2][2] =  6*std::exp(t)-5*std::exp(2*t);
+
+        const Matrix calculated = PadeExpm(m, t);
+        const Real relDiffNorm =
+            frobenuiusNorm(calculated - expected)/frobenuiusNorm(expected);
+
+        if (relDiffNorm > tol) {
+            BOOST_FAIL("Failed to reproduce expected matrix exponential."
+                    << "\n t                   : " << t
+                    << "\n rel. difference norm: " << relDiffNorm
+                    << "\n tolerance           : " << tol);
+        }
+    }
+
+    const Matrix zero(3, 3, 0.0);
+    const Matrix identity = PadeExpm(zero);
+    for (Size i=0; i < identity.rows(); ++i) {
+        for (Size j=0; j < identity.columns(); ++j) {
+            const Real kroneckerDelta = (i==j)? 1.0 : 0.0;
+            if (identity[i][j] != kroneckerDelta) {
+                BOOST_FAIL("Failed to reproduce exponential of "
+                           "a zero matrix.");
+            }
+        }
+    }
+}
+
+void OdeTest::testMatrixExponentialAction() {
+    BOOST_TEST_MESSAGE("Testing action of the matrix exponential "
+                       "on a vector...");
+
+    // generator of a rating migration chain with absorbing default
+    Matrix q(4, 4, 0.0);
+    q[0][0] = -0.12; q[0][1] = 0.10; q[0][2] = 0.015; q[0][3] = 0.005;
+    q[1][0] =  0.05; q[1][1] =-0.25; q[1][2] = 0.17;  q[1][3] = 0.03;
+    q[2][0] =  0.01; q[2][1] = 0.09; q[2][2] =-0.40;  q[2][3] = 0.30;
+
+    // default indicator, exp(t*q) v are the default probabilities
+    Array v(4, 0.0);
+    v[3] = 1.0;
+
+    std::vector<Time> times;
+    times.push_back(0.0);
+    times.push_back(0.25);
+    times.push_back(1.0);
+    times.push_back(5.0);
+    times.push_back(30.0);
+    times.push_back(100.0);
+
+    const std::vector<Array> onGrid = Expmv(q, v, times);
+
+    const Real tol = 1e-12;
+    for (Size i=0; i < times.size(); ++i) {
+        const Array expected = PadeExpm(q, times[i])*v;
+        const Array single = Expmv(q, v, times[i]);
+        for (Size j=0; j < v.size(); ++j) {
+            if (std::fabs(onGrid[i][j] - expected[j]) > tol
+                || std::fabs(single[j] - expected[j]) > tol) {
+                BOOST_FAIL("Failed to reproduce action of the matrix "
+                           "exponential."
+                           << std::setprecision(16)
+                           << "\n t        : " << times[i]
+                           << "\n state    : " << j
+                           << "\n on grid  : " << onGrid[i][j]
+                           << "\n single   : " << single[j]
+                           << "\n expected : " << expected[j]
+                           << "\n tolerance: " << tol);
+            }
+        }
+    }
+}
+
 test_suite* OdeTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("ode tests");
     suite->add(QUANTLIB_TEST_CASE(&OdeTest::testAdaptiveRungeKutta));
     suite->add(QUANTLIB_TEST_CASE(&OdeTest::testMatrixExponential));
     suite->add(QUANTLIB_TEST_CASE(&OdeTest::testMatrixExponentialOfZero));
+    suite->add(QUANTLIB_TEST_CASE(&OdeTest::testPadeMatrixExponential));
+    suite->add(QUANTLIB_TEST_CASE(&OdeTest::testMatrixExponentialAction));
     return suite;
 }
 
@@ -30,6 +30,10 @@ class OptimizersTest {
     static void test();
     static void nestedOptimizationTest();
     static void testDifferentialEvolution();
+    static void testDifferentialEvolutionEvaluation();
+    static void testLevenbergMarquardt();
+    static void testProjectedJacobian();
+    static void testMultiStart();
     static boost::unit_test_framework::test_suite* suite(SpeedLevel speed) {
     test_suite* suite = BOOST_TEST_SUITE("Optimizers tests");
 
@@ -40,6 +44,11 @@ class OptimizersTest {
         suite->add(QUANTLIB_TEST_CASE(
             &OptimizersTest::testDifferentialEvolution));
     }
+    suite->add(QUANTLIB_TEST_CASE(
+        &OptimizersTest::testDifferentialEvolutionEvaluation));
+    suite->add(QUANTLIB_TEST_CASE(&OptimizersTest::testLevenbergMarquardt));
+    suite->add(QUANTLIB_TEST_CASE(&OptimizersTest::testProjectedJacobian));
+    suite->add(QUANTLIB_TEST_CASE(&OptimizersTest::testMultiStart));
 
     return suite;
 };
@@ -82,6 +91,8 @@ class OptimizersTest {
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/math/optimization/differentialevolution.hpp>
 #include <ql/math/optimization/goldstein.hpp>
+#include <ql/math/optimization/multistart.hpp>
+#include <ql/math/optimization/projectedcostfunction.hpp>
 
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
@@ -601,4 +612,475 @@ void OptimizersTest::testDifferentialEvolution() {
     }
 }
 
+namespace {
+
+    class BatchGriewangk : public Griewangk {
+      public:
+        BatchGriewangk() : calls(0) {}
+        Disposable<Array> valueBatch(const std::vector<Array>& x) const {
+            ++calls;
+            return CostFunction::valueBatch(x);
+        }
+        mutable Size calls;
+    };
+
+}
+
+void OptimizersTest::testDifferentialEvolutionEvaluation() {
+    BOOST_TEST_MESSAGE("Testing differential evolution evaluation modes...");
+
+    const Size members = 50;
+    const DifferentialEvolution::Evaluation evaluations[] = {
+        DifferentialEvolution::Sequential,
+        DifferentialEvolution::Parallel,
+        DifferentialEvolution::Batch
+    };
+    const DifferentialEvolution::Strategy strategies[] = {
+        DifferentialEvolution::BestMemberWithJitter,
+        DifferentialEvolution::Rand1SelfadaptiveWithRotation
+    };
+    BoundaryConstraint constraint(-600.0, 600.0);
+    EndCriteria endCriteria(100, 50, 1e-12, 1e-10, Null<Real>());
+
+    for (Size i=0; i<LENGTH(strategies); ++i) {
+        Array reference;
+        Real referenceCost = Null<Real>();
+        for (Size j=0; j<LENGTH(evaluations); ++j) {
+            DifferentialEvolution optimizer(
+                DifferentialEvolution::Configuration()
+                .withStepsizeWeight(0.4)
+                .withCrossoverProbability(0.35)
+                .withPopulationMembers(members)
+                .withStrategy(strategies[i])
+                .withAdaptiveCrossover()
+                .withEvaluation(evaluations[j])
+                .withSeed(3242));
+            BatchGriewangk costFunction;
+            Problem problem(costFunction, constraint, Array(10, 100.0));
+            // the population is shuffled by std::random_shuffle
+            std::srand(42);
+            optimizer.minimize(problem, endCriteria);
+
+            if (evaluations[j] == DifferentialEvolution::Batch
+                && costFunction.calls == 0)
+                BOOST_ERROR("batch cost function not used");
+            if (evaluations[j] != DifferentialEvolution::Batch
+                && costFunction.calls != 0)
+                BOOST_ERROR("batch cost function used in evaluation mode "
+                            << evaluations[j]);
+
+            if (j == 0) {
+                reference = problem.currentValue();
+                referenceCost = problem.functionValue();
+            } else if (problem.functionValue() != referenceCost
+                       || !std::equal(reference.begin(), reference.end(),
+                                      problem.currentValue().begin())) {
+                BOOST_ERROR("strategy " << strategies[i]
+                            << ", evaluation mode " << evaluations[j]
+                            << ": result differs from sequential evaluation"
+                            << std::setprecision(16)
+                            << "\n    calculated: "
+                            << problem.functionValue()
+                            << "\n    expected:   " << referenceCost);
+            }
+        }
+    }
+}
+
+namespace {
+
+    // residuals a exp(b t_i) - y_i, with an analytic jacobian
+    class ExponentialFit : public CostFunction {
+      public:
+        ExponentialFit(const std::vector<Real>& t,
+                       const std::vector<Real>& y)
+        : t_(t), y_(y), jacobians(0), fills(0) {}
+        Real value(const Array& x) const {
+            Array r = values(x);
+            return DotProduct(r, r);
+        }
+        Disposable<Array> values(const Array& x) const {
+            Array r(t_.size());
+            for (Size i=0; i<t_.size(); ++i)
+                r[i] = x[0]*std::exp(x[1]*t_[i]) - y_[i];
+            return r;
+        }
+        void fillValues(Array& r, const Array& x) const {
+            ++fills;
+            for (Size i=0; i<t_.size(); ++i)
+                r[i] = x[0]*std::exp(x[1]*t_[i]) - y_[i];
+        }
+        void jacobian(Matrix& jac, const Array& x) const {
+            ++jacobians;
+            for (Size i=0; i<t_.size(); ++i) {
+                jac[i][0] = std::exp(x[1]*t_[i]);
+                jac[i][1] = x[0]*t_[i]*std::exp(x[1]*t_[i]);
+            }
+        }
+      private:
+        std::vector<Real> t_, y_;
+      public:
+        mutable Size jacobians, fills;
+    };
+
+    /* residuals z(x_i) - y_i, where z(p) = p is found by minimizing
+       (z-p)^2 with the same optimizer */
+    class NestedFit : public CostFunction {
+      public:
+        NestedFit(OptimizationMethod& method, const Array& y)
+        : method_(method), y_(y) {}
+        Real value(const Array& x) const {
+            Array r = values(x);
+            return DotProduct(r, r);
+        }
+        Disposable<Array> values(const Array& x) const {
+            Array r(x.size());
+            for (Size i=0; i<x.size(); ++i)
+                r[i] = inner(x[i]) - y_[i];
+            return r;
+        }
+      private:
+        class Inner : public CostFunction {
+          public:
+            explicit Inner(Real p) : p_(p) {}
+            Real value(const Array& z) const {
+                return (z[0]-p_)*(z[0]-p_);
+            }
+            Disposable<Array> values(const Array& z) const {
+                Array r(1, z[0]-p_);
+                return r;
+            }
+          private:
+            Real p_;
+        };
+        Real inner(Real p) const {
+            Inner f(p);
+            NoConstraint constraint;
+            Problem problem(f, constraint, Array(1, 0.0));
+            method_.minimize(problem, EndCriteria(1000, 100, 1e-14,
+                                                  1e-14, 1e-14));
+            return problem.currentValue()[0];
+        }
+        OptimizationMethod& method_;
+        Array y_;
+    };
+
+}
+
+void OptimizersTest::testLevenbergMarquardt() {
+    BOOST_TEST_MESSAGE("Testing Levenberg-Marquardt with analytic "
+                       "jacobian and nested minimizations...");
+
+    std::vector<Real> t, y;
+    for (Size i=0; i<10; ++i) {
+        t.push_back(0.25*i);
+        y.push_back(2.0*std::exp(-0.7*t.back()) + 0.01*std::sin(3.0*i));
+    }
+    NoConstraint constraint;
+    EndCriteria endCriteria(1000, 100, 1e-12, 1e-12, 1e-12);
+
+    ExponentialFit f1(t, y), f2(t, y);
+    LevenbergMarquardt finiteDifferences, analytic(1e-8, 1e-8, 1e-8, true);
+    Problem p1(f1, constraint, Array(2, 1.0));
+    Problem p2(f2, constraint, Array(2, 1.0));
+    Integer info;
+    finiteDifferences.minimize(p1, endCriteria, info);
+    analytic.minimize(p2, endCriteria);
+
+    if (info != finiteDifferences.getInfo() || info <= 0 || info > 4)
+        BOOST_ERROR("wrong MINPACK info: " << info << " returned, "
+                    << finiteDifferences.getInfo() << " stored");
+    if (f1.fills == 0 || f1.fills != Size(p1.functionEvaluation()))
+        BOOST_ERROR("in-place values used for " << f1.fills << " of "
+                    << p1.functionEvaluation() << " evaluations");
+
+    // the MINPACK callback evaluates the problem in place
+    Array fvec(t.size());
+    Array x = p1.currentValue();
+    int iflag = 1;
+    Array initValues = f1.values(p1.currentValue());
+    Matrix initJacobian;
+    QuantLib::detail::LevenbergMarquardtFunction callback(p1, initValues,
+                                                          initJacobian);
+    callback.fcn(int(t.size()), 2, x.begin(), fvec.begin(), &iflag);
+    Array residuals = f1.values(x);
+    for (Size i=0; i<t.size(); ++i) {
+        if (fvec[i] != residuals[i])
+            BOOST_ERROR("wrong residual from fcn() at t = " << t[i]
+                        << "\n    calculated: " << fvec[i]
+                        << "\n    expected:   " << residuals[i]);
+    }
+
+    if (f1.jacobians != 0 || f2.jacobians == 0)
+        BOOST_ERROR("analytic jacobian called " << f1.jacobians
+                    << " times with finite differences and "
+                    << f2.jacobians << " times when requested");
+    for (Size i=0; i<2; ++i) {
+        if (std::fabs(p1.currentValue()[i] - p2.currentValue()[i]) > 1e-6)
+            BOOST_ERROR("analytic and finite-difference jacobians give "
+                        "different minima"
+                        << std::setprecision(10)
+                        << "\n    finite differences: " << p1.currentValue()
+                        << "\n    analytic:           "
+                        << p2.currentValue());
+    }
+
+    // the same optimizer used within its own cost function
+    Array targets(3);
+    targets[0] = 1.0; targets[1] = -2.0; targets[2] = 0.5;
+    LevenbergMarquardt lm;
+    NestedFit nested(lm, targets);
+    Problem p3(nested, constraint, Array(3, 0.0));
+    lm.minimize(p3, endCriteria);
+    for (Size i=0; i<3; ++i) {
+        if (std::fabs(p3.currentValue()[i] - targets[i]) > 1e-8)
+            BOOST_ERROR("nested minimization failed"
+                        << std::setprecision(10)
+                        << "\n    calculated: " << p3.currentValue()
+                        << "\n    expected:   " << targets);
+    }
+}
+
+namespace {
+
+    /* residuals x_0 t_i + x_1 t_i^2 + x_2 - y_i, optionally with an
+       analytic jacobian; records the evaluations and whether the
+       last parameter was moved from the given value */
+    class QuadraticFit : public CostFunction {
+      public:
+        QuadraticFit(const std::vector<Real>& t, Real x2, bool analytic)
+        : t_(t), x2_(x2), analytic_(analytic),
+          evaluations(0), jacobians(0), movedX2(false) {}
+        Real value(const Array& x) const {
+            Array r = values(x);
+            return DotProduct(r, r);
+        }
+        Disposable<Array> values(const Array& x) const {
+            ++evaluations;
+            if (x[2] != x2_)
+                movedX2 = true;
+            Array r(t_.size());
+            for (Size i=0; i<t_.size(); ++i)
+                r[i] = x[0]*t_[i] + x[1]*t_[i]*t_[i] + x[2] - 1.0;
+            return r;
+        }
+        void jacobian(Matrix& jac, const Array& x) const {
+            if (!analytic_) {
+                CostFunction::jacobian(jac, x);
+                return;
+            }
+            ++jacobians;
+            for (Size i=0; i<t_.size(); ++i) {
+                jac[i][0] = t_[i];
+                jac[i][1] = t_[i]*t_[i];
+                jac[i][2] = 1.0;
+            }
+        }
+        bool hasAnalyticJacobian() const { return analytic_; }
+      private:
+        std::vector<Real> t_;
+        Real x2_;
+        bool analytic_;
+      public:
+        mutable Size evaluations, jacobians;
+        mutable bool movedX2;
+    };
+
+}
+
+void OptimizersTest::testProjectedJacobian() {
+    BOOST_TEST_MESSAGE("Testing jacobian of projected cost functions...");
+
+    std::vector<Real> t;
+    for (Size i=0; i<5; ++i)
+        t.push_back(0.5*i);
+    Array parameters(3);
+    parameters[0] = 1.0; parameters[1] = -0.5; parameters[2] = 0.3;
+    std::vector<bool> fixed(3, false);
+    fixed[2] = true;
+    Array free(2);
+    free[0] = 0.8; free[1] = -0.4;
+
+    for (Size k=0; k<2; ++k) {
+        const bool analytic = (k == 1);
+        QuadraticFit f(t, parameters[2], analytic);
+        ProjectedCostFunction projected(f, parameters, fixed);
+        Matrix jac(t.size(), 2);
+        projected.jacobian(jac, free);
+
+        for (Size i=0; i<t.size(); ++i) {
+            if (std::fabs(jac[i][0] - t[i]) > 1e-6
+                || std::fabs(jac[i][1] - t[i]*t[i]) > 1e-6)
+                BOOST_ERROR("wrong projected jacobian at t = " << t[i]
+                            << (analytic ? " (analytic)" : "")
+                            << "\n    calculated: " << jac[i][0]
+                            << ", " << jac[i][1]
+                            << "\n    expected:   " << t[i]
+                            << ", " << t[i]*t[i]);
+        }
+        if (f.movedX2)
+            BOOST_ERROR("fixed parameter moved by projected jacobian"
+                        << (analytic ? " (analytic)" : ""));
+        if (projected.hasAnalyticJacobian() != analytic)
+            BOOST_ERROR("analytic jacobian not forwarded");
+        // finite differences on the free parameters only, or the
+        // analytic jacobian alone
+        Size expectedEvaluations = analytic ? 0 : 4;
+        Size expectedJacobians = analytic ? 1 : 0;
+        if (f.evaluations != expectedEvaluations
+            || f.jacobians != expectedJacobians)
+            BOOST_ERROR("projected jacobian evaluated the cost function "
+                        << f.evaluations << " times and its jacobian "
+                        << f.jacobians << " times"
+                        << (analytic ? " (analytic)" : "")
+                        << "\n    expected: " << expectedEvaluations
+                        << " and " << expectedJacobians);
+    }
+}
+
+namespace {
+
+    /* sum of x_i^2 + 20 sin^2(pi x_i), i.e., the Rastrigin function,
+       as a sum of squares; its local minima are close to the points
+       with integer coordinates, the global one being the origin */
+    class Rastrigin : public CostFunction {
+      public:
+        Real value(const Array& x) const {
+            Array r = values(x);
+            return DotProduct(r, r);
+        }
+        Disposable<Array> values(const Array& x) const {
+            Array r(2*x.size());
+            for (Size i=0; i<x.size(); ++i) {
+                r[2*i] = x[i];
+                r[2*i+1] = std::sqrt(20.0)*std::sin(M_PI*x[i]);
+            }
+            return r;
+        }
+    };
+
+    // fails with a QuantLib::Error, or with another exception if
+    // so requested, beyond x[0] = 4
+    class FailingRastrigin : public Rastrigin {
+      public:
+        explicit FailingRastrigin(bool quantLibError)
+        : quantLibError_(quantLibError) {}
+        Disposable<Array> values(const Array& x) const {
+            if (x[0] > 4.0) {
+                QL_REQUIRE(!quantLibError_, "outside the domain");
+                throw std::domain_error("outside the domain");
+            }
+            return Rastrigin::values(x);
+        }
+      private:
+        bool quantLibError_;
+    };
+
+}
+
+void OptimizersTest::testMultiStart() {
+    BOOST_TEST_MESSAGE("Testing multi-start optimization...");
+
+    Rastrigin rastrigin;
+    BoundaryConstraint constraint(-5.0, 5.0);
+    EndCriteria endCriteria(1000, 100, 1e-12, 1e-12, 1e-12);
+    Array start(2);
+    start[0] = 3.1; start[1] = -2.2;
+
+    // a single local search gets stuck
+    boost::shared_ptr<OptimizationMethod> lm(new LevenbergMarquardt);
+    Problem local(rastrigin, constraint, start);
+    lm->minimize(local, endCriteria);
+    if (local.functionValue() < 1.0)
+        BOOST_FAIL("local search expected to end in a local minimum"
+                   << "\n    minimum: " << local.currentValue()
+                   << "\n    value:   " << local.functionValue());
+
+    const Size maxStarts = 200;
+    std::vector<Array> results;
+    std::vector<Size> starts, clusters;
+    std::vector<Integer> evaluations;
+    for (Size k=0; k<2; ++k) {
+        const bool parallel = (k == 1);
+        MultiStartOptimization multiStart(lm, maxStarts, 10, 2, 1e-10,
+                                          1e-4, parallel);
+        Problem problem(rastrigin, constraint, start);
+        multiStart.minimize(problem, endCriteria);
+
+        if (problem.functionValue() > 1e-12
+            || Norm2(problem.currentValue()) > 1e-6)
+            BOOST_ERROR("global minimum not found"
+                        << (parallel ? " (parallel)" : "")
+                        << "\n    minimum: " << problem.currentValue()
+                        << "\n    value:   " << problem.functionValue());
+        const std::vector<MultiStartOptimization::Minimum>& minima =
+            multiStart.minima();
+        if (minima.size() < 2)
+            BOOST_ERROR("local minima expected in the clusters");
+        Size hits = 0;
+        for (Size i=0; i<minima.size(); ++i) {
+            hits += minima[i].hits;
+            if (i > 0 && minima[i].cost < minima[i-1].cost)
+                BOOST_ERROR("minima not sorted by cost");
+        }
+        if (hits != multiStart.starts())
+            BOOST_ERROR(hits << " hits in the clusters for "
+                        << multiStart.starts() << " local searches");
+        if (multiStart.starts() >= maxStarts)
+            BOOST_ERROR("no early stop after "
+                        << multiStart.starts() << " local searches");
+        if (problem.functionEvaluation()
+            < Integer(multiStart.starts())*local.functionEvaluation()/10)
+            BOOST_ERROR("evaluations of the local searches not counted: "
+                        << problem.functionEvaluation() << " for "
+                        << multiStart.starts() << " local searches");
+
+        results.push_back(problem.currentValue());
+        starts.push_back(multiStart.starts());
+        clusters.push_back(minima.size());
+        evaluations.push_back(problem.functionEvaluation());
+    }
+
+    if (starts[0] != starts[1] || clusters[0] != clusters[1]
+        || evaluations[0] != evaluations[1]
+        || !std::equal(results[0].begin(), results[0].end(),
+                       results[1].begin()))
+        BOOST_ERROR("parallel results differ from sequential ones"
+                    << "\n    sequential: " << results[0] << ", "
+                    << starts[0] << " starts, " << clusters[0] << " clusters"
+                    << "\n    parallel:   " << results[1] << ", "
+                    << starts[1] << " starts, " << clusters[1]
+                    << " clusters");
+
+    // searches failing with a QuantLib::Error are discarded,
+    // other exceptions are propagated
+    for (Size k=0; k<2; ++k) {
+        const bool parallel = (k == 1);
+        MultiStartOptimization multiStart(lm, 20, 10, 2, 1e-10,
+                                          1e-4, parallel);
+        FailingRastrigin quantLibError(true), otherError(false);
+        Problem discarded(quantLibError, constraint, start);
+        multiStart.minimize(discarded, endCriteria);
+        Size hits = 0;
+        for (Size i=0; i<multiStart.minima().size(); ++i)
+            hits += multiStart.minima()[i].hits;
+        if (hits == 0 || hits >= multiStart.starts())
+            BOOST_ERROR("failed searches not discarded"
+                        << (parallel ? " (parallel)" : "") << ": "
+                        << hits << " hits for " << multiStart.starts()
+                        << " local searches");
+
+        Problem propagated(otherError, constraint, start);
+        bool thrown = false;
+        try {
+            multiStart.minimize(propagated, endCriteria);
+        } catch (std::exception&) {
+            thrown = true;
+        }
+        if (!thrown)
+            BOOST_ERROR("exception not propagated"
+                        << (parallel ? " (parallel)" : ""));
+    }
+}
+
 #endif
\ No newline at end of file
@@ -27,6 +27,8 @@
 #include <ql/math/solvers1d/newton.hpp>
 #include <ql/math/solvers1d/newtonsafe.hpp>
 #include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
+#include <ql/math/solvers1d/batchbrent.hpp>
+#include <ql/math/solvers1d/batchnewtonsafe.hpp>
 
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
@@ -66,6 +68,7 @@ class Solver1DTest {
     static void testFiniteDifferenceNewtonSafe();
     static void testRidder();
     static void testSecant();
+    static void testBatchSolvers();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -183,6 +186,85 @@ namespace {
         }
     }        
 
+    class Square {
+      public:
+        explicit Square(Real c) : c_(c) {}
+        Real operator()(Real x) const { return x*x-c_; }
+        Real derivative(Real x) const { return 2.0*x; }
+      private:
+        Real c_;
+    };
+
+    class BatchSquares {
+      public:
+        explicit BatchSquares(const std::vector<Real>& c) : c_(c) {}
+        void operator()(const Size* lanes, const Real* x, Real* fx,
+                        Size n) const {
+            for (Size k=0; k<n; ++k)
+                fx[k] = x[k]*x[k]-c_[lanes[k]];
+        }
+        void operator()(const Size* lanes, const Real* x, Real* fx,
+                        Real* dfx, Size n) const {
+            for (Size k=0; k<n; ++k) {
+                fx[k] = x[k]*x[k]-c_[lanes[k]];
+                dfx[k] = 2.0*x[k];
+            }
+        }
+      private:
+        const std::vector<Real>& c_;
+    };
+
+    template <class S, class B>
+    void test_batch_solver(S solver, B batchSolver, const std::string& name,
+                           Size maxEvaluations) {
+        // roots of x^2-c over [0,10]; the first lane has its root
+        // on the lower bound, the second one is not bracketed
+        const Size n = 50;
+        std::vector<Real> c(n), guess(n), xMin(n, 0.0), xMax(n, 10.0);
+        for (Size i=0; i<n; ++i) {
+            c[i] = 0.04*i*i;
+            guess[i] = 0.1 + 0.19*i;
+        }
+        c[1] = -1.0;
+
+        Real accuracy = 1.0e-10;
+        solver.setMaxEvaluations(maxEvaluations);
+        batchSolver.setMaxEvaluations(maxEvaluations);
+        std::vector<Real> roots;
+        batchSolver.solve(BatchSquares(c), accuracy, guess, xMin, xMax,
+                          roots);
+
+        Size converged = 0;
+        for (Size i=0; i<n; ++i) {
+            Real expected = Null<Real>();
+            typename B::Status expectedStatus = B::Converged;
+            try {
+                expected = solver.solve(Square(c[i]), accuracy, guess[i],
+                                        xMin[i], xMax[i]);
+            } catch (Error&) {
+                expectedStatus = (i == 1 ? B::NotBracketed
+                                         : B::MaxEvaluationsExceeded);
+            }
+            if (roots[i] != expected
+                || batchSolver.status()[i] != expectedStatus) {
+                BOOST_FAIL(name << " solver, lane " << i << ":\n"
+                           << "    expected:   " << expected
+                           << " (status " << expectedStatus << ")\n"
+                           << "    calculated: " << roots[i]
+                           << " (status " << batchSolver.status()[i]
+                           << ")");
+            }
+            if (expectedStatus == B::Converged)
+                ++converged;
+        }
+        if (maxEvaluations >= 100 && converged != n-1)
+            BOOST_FAIL(name << " solver: " << converged
+                       << " lanes converged, " << n-1 << " expected");
+        if (maxEvaluations < 100 && converged == n-1)
+            BOOST_FAIL(name << " solver: no lane exceeded "
+                       << maxEvaluations << " evaluations");
+    }
+
     template <class S>
     void test_solver(const S& solver, const std::string& name, Real accuracy) {
         // guess on the left side of the root, increasing function
@@ -252,6 +334,16 @@ void Solver1DTest::testSecant() {
     test_solver(Secant(), "Secant", 1.0e-6);
 }
 
+void Solver1DTest::testBatchSolvers() {
+    BOOST_TEST_MESSAGE("Testing batch solvers...");
+    test_batch_solver(Brent(), BatchBrent(), "BatchBrent", 100);
+    test_batch_solver(Brent(), BatchBrent(), "BatchBrent", 8);
+    test_batch_solver(NewtonSafe(), BatchNewtonSafe(),
+                      "BatchNewtonSafe", 100);
+    test_batch_solver(NewtonSafe(), BatchNewtonSafe(),
+                      "BatchNewtonSafe", 6);
+}
+
 
 test_suite* Solver1DTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("1-D solver tests");
@@ -263,6 +355,7 @@ test_suite* Solver1DTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&Solver1DTest::testFiniteDifferenceNewtonSafe));
     suite->add(QUANTLIB_TEST_CASE(&Solver1DTest::testRidder));
     suite->add(QUANTLIB_TEST_CASE(&Solver1DTest::testSecant));
+    suite->add(QUANTLIB_TEST_CASE(&Solver1DTest::testBatchSolvers));
     return suite;
 }
 